@@ -0,0 +1,173 @@
+// bounce_batch.c - Перебор вариантов ввода от одного чекпоинта пакетным тиком
+// Уровень прогревается обычным game_tick() до чекпоинта, затем N дорожек
+// продолжают его каждая со своим случайным вводом через sim_batch_tick().
+// Тот же перебор повторяется по одной дорожке обычным game_tick() от снимка:
+// печатается время обоих способов на дорожку-тик и лучший вариант, а каждая
+// дорожка сверяется по sim_hash() (расхождение - код возврата 1).
+#include "platform_host.h"
+#include "game.h"
+#include "sim_batch.h"
+#include "types.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int level;
+    int lanes;
+    int ticks;
+    int warmup;         // Тиков до чекпоинта
+    uint32_t seed;
+    const char* data_root;
+} batch_options_t;
+
+// Генератор ввода как в bounce_headless, но со своим состоянием у каждой дорожки
+typedef struct {
+    uint32_t rng;
+    int hold;
+    MoveMask current;
+} input_gen_t;
+
+static MoveMask input_next(input_gen_t* g) {
+    static const MoveMask masks[] = {
+        0, MOVE_LEFT, MOVE_RIGHT, MOVE_UP,
+        MOVE_LEFT | MOVE_UP, MOVE_RIGHT | MOVE_UP
+    };
+    if (g->hold <= 0) {
+        g->rng = g->rng * 1664525u + 1013904223u;
+        g->current = masks[(g->rng >> 8) % (sizeof(masks) / sizeof(masks[0]))];
+        g->rng = g->rng * 1664525u + 1013904223u;
+        g->hold = 4 + (int)((g->rng >> 8) % 32);
+    }
+    g->hold--;
+    return g->current;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [-l level] [-n lanes] [-t ticks] [-w warmup] [-s seed] [-d data_root]\n"
+            "  -l  номер уровня 1-%d (по умолчанию 1)\n"
+            "  -n  число вариантов ввода (по умолчанию 1024, пакетами по %d)\n"
+            "  -t  тиков каждого варианта (по умолчанию 300)\n"
+            "  -w  тиков до чекпоинта (по умолчанию 200)\n"
+            "  -s  seed генератора ввода (по умолчанию 1)\n"
+            "  -d  каталог с levels/ (по умолчанию текущий)\n",
+            argv0, MAX_LEVEL, SIM_BATCH_LANES);
+}
+
+static int parse_args(int argc, char** argv, batch_options_t* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc || argv[i][0] != '-' || argv[i][2] != '\0') return 0;
+        const char* value = argv[++i];
+        switch (argv[i - 1][1]) {
+            case 'l': opt->level = atoi(value); break;
+            case 'n': opt->lanes = atoi(value); break;
+            case 't': opt->ticks = atoi(value); break;
+            case 'w': opt->warmup = atoi(value); break;
+            case 's': opt->seed = (uint32_t)strtoul(value, NULL, 0); break;
+            case 'd': opt->data_root = value; break;
+            default: return 0;
+        }
+    }
+    return opt->level >= 1 && opt->level <= MAX_LEVEL && opt->lanes > 0 &&
+           opt->ticks > 0 && opt->warmup >= 0;
+}
+
+// Оценка варианта: кольца, затем продвижение вправо (для примера отбора)
+static long lane_score(const SimContext* sim) {
+    return (long)sim->numRings * 100000 + sim->player.xPos;
+}
+
+int main(int argc, char** argv) {
+    batch_options_t opt = { 1, 1024, 300, 200, 1, NULL };
+    if (!parse_args(argc, argv, &opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+    host_set_data_root(opt.data_root);
+
+    SimContext* sim = (SimContext*)calloc(1, sizeof(SimContext));
+    SimBatch* batch = (SimBatch*)calloc(1, sizeof(SimBatch));
+    SimSnapshot* checkpoint = (SimSnapshot*)calloc(1, sizeof(SimSnapshot));
+    MoveMask* inputs = (MoveMask*)calloc((size_t)SIM_BATCH_LANES * (size_t)opt.ticks, sizeof(MoveMask));
+    uint64_t* hashes = (uint64_t*)calloc(SIM_BATCH_LANES, sizeof(uint64_t));
+    if (!sim || !batch || !checkpoint || !inputs || !hashes) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    if (!game_start_level(sim, opt.level, GAME_START_FRESH)) {
+        fprintf(stderr, "failed to load level %d\n", opt.level);
+        return 1;
+    }
+
+    input_gen_t warm = { opt.seed, 0, 0 };
+    for (int t = 0; t < opt.warmup && sim->state == STATE_GAME; t++) {
+        game_tick(sim, input_next(&warm));
+    }
+    if (sim->state != STATE_GAME || !sim_snapshot(sim, checkpoint)) {
+        fprintf(stderr, "level %d: no checkpoint after %d ticks\n", opt.level, opt.warmup);
+        return 1;
+    }
+
+    uint64_t batch_ns = 0, scalar_ns = 0;
+    int mismatches = 0, best = -1;
+    long best_score = 0;
+    for (int first = 0; first < opt.lanes; first += SIM_BATCH_LANES) {
+        int count = opt.lanes - first < SIM_BATCH_LANES ? opt.lanes - first : SIM_BATCH_LANES;
+        for (int i = 0; i < count; i++) {
+            input_gen_t gen = { opt.seed ^ (0x9E3779B9u * (uint32_t)(first + i + 1)), 0, 0 };
+            for (int t = 0; t < opt.ticks; t++) {
+                inputs[(size_t)t * SIM_BATCH_LANES + (size_t)i] = input_next(&gen);
+            }
+        }
+
+        // Пакетом
+        sim_restore(sim, checkpoint);
+        uint64_t start_ns = host_time_ns();
+        sim_batch_fill(batch, sim, count);
+        for (int t = 0; t < opt.ticks; t++) {
+            sim_batch_tick(batch, sim, &inputs[(size_t)t * SIM_BATCH_LANES]);
+        }
+        batch_ns += host_time_ns() - start_ns;
+        for (int i = 0; i < count; i++) {
+            sim_batch_extract(batch, sim, i);
+            hashes[i] = sim_hash(sim);
+        }
+
+        // По одной дорожке
+        for (int i = 0; i < count; i++) {
+            start_ns = host_time_ns();
+            sim_restore(sim, checkpoint);
+            int t;
+            for (t = 0; t < opt.ticks && sim->state == STATE_GAME; t++) {
+                game_tick(sim, inputs[(size_t)t * SIM_BATCH_LANES + (size_t)i]);
+            }
+            // Дорожки пакета стоят после конца уровня, а шипы идут дальше
+            level_seek_moving_objects(&sim->level, checkpoint->movingTick + (uint32_t)opt.ticks);
+            scalar_ns += host_time_ns() - start_ns;
+            if (sim_hash(sim) != hashes[i]) {
+                if (mismatches++ == 0) {
+                    fprintf(stderr, "lane %d differs from game_tick() (level %d, seed %u)\n",
+                            first + i, opt.level, (unsigned)opt.seed);
+                }
+            }
+            if (best < 0 || lane_score(sim) > best_score) {
+                best = first + i;
+                best_score = lane_score(sim);
+            }
+        }
+    }
+
+    double lane_ticks = (double)opt.lanes * opt.ticks;
+    printf("level %d: %d lanes x %d ticks from tick %d\n", opt.level, opt.lanes, opt.ticks, opt.warmup);
+    printf("batch  %.1f ns/lane-tick\n", (double)batch_ns / lane_ticks);
+    printf("scalar %.1f ns/lane-tick\n", (double)scalar_ns / lane_ticks);
+    printf("best lane %d (score %ld), %d mismatches\n", best, best_score, mismatches);
+
+    free(hashes);
+    free(inputs);
+    free(checkpoint);
+    free(batch);
+    sim_free(sim);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,214 @@
+// bounce_bench.c - Микробенчмарк физики по всем уровням игры
+// Для каждого уровня мяч ставится в узлы сетки пустых тайлов (обоих размеров)
+// и ведется player_update() по фиксированному сценарию ввода. Время и счетчики
+// физики (SimContext::stats, сборка с -DPHYSICS_STATS) печатаются в JSON,
+// чтобы регрессии в пути коллизий было видно до запуска на PSP.
+#include "platform_host.h"
+#include "game.h"
+#include "level.h"
+#include "types.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef PHYSICS_STATS
+#error "bounce_bench собирается с -DPHYSICS_STATS (см. host/Makefile)"
+#endif
+
+// Сценарий ввода для каждой точки старта: вправо, прыжки, стоп, влево
+typedef struct {
+    MoveMask input;
+    int ticks;
+} bench_step_t;
+
+static const bench_step_t s_script[] = {
+    { MOVE_RIGHT,           10 },
+    { MOVE_RIGHT | MOVE_UP,  8 },
+    { 0,                     6 },
+    { MOVE_LEFT,            10 },
+    { MOVE_LEFT | MOVE_UP,   8 },
+    { MOVE_UP,               8 },
+};
+
+typedef struct {
+    int grid;           // Шаг сетки точек старта в тайлах
+    int repeats;        // Сколько раз сценарий проигрывается с одной точки
+    int passes;         // Прогонов уровня; берется лучшее время
+    const char* data_root;
+    const char* output;
+} bench_options_t;
+
+typedef struct {
+    int spawns;
+    uint64_t ticks;
+    uint64_t best_ns;
+    PhysicsStats stats;
+} bench_result_t;
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [-g grid] [-r repeats] [-n passes] [-d data_root] [-o output.json]\n"
+            "  -g  шаг сетки точек старта в тайлах (по умолчанию 3)\n"
+            "  -r  повторов сценария ввода с каждой точки (по умолчанию 2)\n"
+            "  -n  прогонов каждого уровня, в отчет идет лучшее время (по умолчанию 3)\n"
+            "  -d  каталог с levels/ (по умолчанию текущий)\n"
+            "  -o  файл для JSON (по умолчанию stdout)\n",
+            argv0);
+}
+
+static int parse_args(int argc, char** argv, bench_options_t* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc || argv[i][0] != '-' || argv[i][2] != '\0') return 0;
+        const char* value = argv[++i];
+        switch (argv[i - 1][1]) {
+            case 'g': opt->grid = atoi(value); break;
+            case 'r': opt->repeats = atoi(value); break;
+            case 'n': opt->passes = atoi(value); break;
+            case 'd': opt->data_root = value; break;
+            case 'o': opt->output = value; break;
+            default: return 0;
+        }
+    }
+    return opt->grid > 0 && opt->repeats > 0 && opt->passes > 0;
+}
+
+// Мяч в центре тайла (tx, ty) заданного размера, как при респауне
+static void bench_spawn(SimContext* sim, int tx, int ty, BallSizeState size) {
+    int half = (size == SMALL_SIZE_STATE) ? HALF_NORMAL_SIZE : HALF_ENLARGED_SIZE;
+    player_init(sim, tx * TILE_SIZE + half, ty * TILE_SIZE + half, size);
+}
+
+// Один прогон уровня с чистой карты. Возвращает false, если уровень не загрузился.
+static bool bench_level_pass(SimContext* sim, int levelNumber, const bench_options_t* opt,
+                             bench_result_t* out, uint64_t* elapsed_ns) {
+    if (!game_start_level(sim, levelNumber, GAME_START_FRESH)) {
+        return false;
+    }
+    memset(&sim->stats, 0, sizeof(sim->stats));
+    out->spawns = 0;
+    out->ticks = 0;
+
+    static const BallSizeState sizes[] = { SMALL_SIZE_STATE, LARGE_SIZE_STATE };
+    uint64_t start_ns = host_time_ns();
+    for (int y = 0; y < sim->level.height; y += opt->grid) {
+        for (int x = 0; x < sim->level.width; x += opt->grid) {
+            if (level_get_id(&sim->level, x, y) != 0) {
+                continue;  // Старт только из пустых тайлов (в том числе в воде)
+            }
+            for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+                bench_spawn(sim, x, y, sizes[s]);
+                out->spawns++;
+                for (int r = 0; r < opt->repeats; r++) {
+                    for (size_t k = 0; k < sizeof(s_script) / sizeof(s_script[0]); k++) {
+                        for (int t = 0; t < s_script[k].ticks; t++) {
+                            sim_events_clear(sim);  // Как в начале game_tick()
+                            sim->player.direction = s_script[k].input;
+                            player_update(sim);
+                            level_update_moving_objects(&sim->level);
+                            if (sim->player.ballState == BALL_STATE_DEAD) {
+                                bench_spawn(sim, x, y, sizes[s]);
+                            }
+                            out->ticks++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    *elapsed_ns = host_time_ns() - start_ns;
+    out->stats = sim->stats;
+    return true;
+}
+
+static double per(uint64_t value, uint64_t count) {
+    return count ? (double)value / (double)count : 0.0;
+}
+
+static void print_metrics(FILE* out, const bench_result_t* r) {
+    fprintf(out,
+            "\"spawns\": %d, \"ticks\": %llu, \"ns_per_tick\": %.2f, "
+            "\"ns_per_collision\": %.2f, \"collisions_per_tick\": %.3f, "
+            "\"tile_tests_per_tick\": %.3f, \"substeps_per_tick\": %.3f, "
+            "\"fast_substeps_per_tick\": %.3f",
+            r->spawns, (unsigned long long)r->ticks,
+            per(r->best_ns, r->ticks),
+            per(r->best_ns, r->stats.collisionCalls),
+            per(r->stats.collisionCalls, r->ticks),
+            per(r->stats.tileTests, r->ticks),
+            per(r->stats.substepsY + r->stats.substepsX, r->ticks),
+            per(r->stats.fastSubstepsY + r->stats.fastSubstepsX, r->ticks));
+}
+
+int main(int argc, char** argv) {
+    bench_options_t opt = { 3, 2, 3, NULL, NULL };
+    if (!parse_args(argc, argv, &opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+    host_set_data_root(opt.data_root);
+
+    SimContext* sim = (SimContext*)calloc(1, sizeof(SimContext));
+    if (!sim) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    bench_result_t results[MAX_LEVEL + 1];
+    bench_result_t total;
+    memset(results, 0, sizeof(results));
+    memset(&total, 0, sizeof(total));
+
+    for (int level = 1; level <= MAX_LEVEL; level++) {
+        bench_result_t* r = &results[level];
+        r->best_ns = UINT64_MAX;
+        // Прогоны детерминированы: счетчики одинаковы, время берется лучшее
+        for (int pass = 0; pass < opt.passes; pass++) {
+            uint64_t elapsed_ns;
+            if (!bench_level_pass(sim, level, &opt, r, &elapsed_ns)) {
+                fprintf(stderr, "failed to load level %d\n", level);
+                sim_free(sim);
+                return 1;
+            }
+            if (elapsed_ns < r->best_ns) r->best_ns = elapsed_ns;
+        }
+
+        total.spawns += r->spawns;
+        total.ticks += r->ticks;
+        total.best_ns += r->best_ns;
+        total.stats.updates += r->stats.updates;
+        total.stats.collisionCalls += r->stats.collisionCalls;
+        total.stats.tileTests += r->stats.tileTests;
+        total.stats.substepsY += r->stats.substepsY;
+        total.stats.substepsX += r->stats.substepsX;
+        total.stats.fastSubstepsY += r->stats.fastSubstepsY;
+        total.stats.fastSubstepsX += r->stats.fastSubstepsX;
+    }
+    sim_free(sim);
+
+    FILE* out = stdout;
+    if (opt.output) {
+        out = fopen(opt.output, "w");
+        if (!out) {
+            fprintf(stderr, "failed to write %s\n", opt.output);
+            return 1;
+        }
+    }
+
+    fprintf(out, "{\n  \"benchmark\": \"physics\",\n");
+    fprintf(out, "  \"grid\": %d, \"repeats\": %d, \"passes\": %d,\n", opt.grid, opt.repeats, opt.passes);
+    fprintf(out, "  \"levels\": [\n");
+    for (int level = 1; level <= MAX_LEVEL; level++) {
+        fprintf(out, "    { \"level\": %d, ", level);
+        print_metrics(out, &results[level]);
+        fprintf(out, " }%s\n", level < MAX_LEVEL ? "," : "");
+    }
+    fprintf(out, "  ],\n  \"total\": { ");
+    print_metrics(out, &total);
+    fprintf(out, " }\n}\n");
+
+    if (out != stdout && fclose(out) != 0) {
+        fprintf(stderr, "failed to write %s\n", opt.output);
+        return 1;
+    }
+    return 0;
+}
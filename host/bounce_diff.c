@@ -0,0 +1,460 @@
+// bounce_diff.c - Сверка текущего ядра с замороженным эталоном по каждому тику
+// Эталон - замороженное ядро до оптимизаций из host/ref, слинкованное в тот же
+// бинарник с префиксом ref_ (host/Makefile). Обе стороны получают одинаковый ввод (случайный по всем
+// уровням и из файлов реплеев), и после каждого тика сравниваются все поля мяча,
+// счетчики, дверь, движущиеся объекты и карта тайлов целиком. Физика намеренно
+// повторяет причуды оригинала (например, залипание на рампе уровня 4), поэтому
+// любая оптимизация должна давать здесь побитово то же состояние.
+// Прогоны распределяются по потокам. Из расхождения с наименьшим номером
+// прогона строится минимальный реплей (ввод до первого расходящегося тика с
+// обнуленными лишними отрезками), который воспроизводит его: bounce_diff file.rpl
+#include "diff_side.h"
+#include "platform_host.h"
+#include "replay.h"
+#include "types.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DIFF_MAX_TILES (255 * 255)
+#define DIFF_MAX_REPORT_LINES 12
+
+static const char* const s_field_names[DIFF_NUM_FIELDS] = {
+#define DIFF_PLAYER_NAME(name) "player." #name,
+#define DIFF_SIM_NAME(name) #name,
+    DIFF_PLAYER_FIELDS(DIFF_PLAYER_NAME)
+    DIFF_SIM_FIELDS(DIFF_SIM_NAME)
+#undef DIFF_PLAYER_NAME
+#undef DIFF_SIM_NAME
+};
+
+typedef struct {
+    int level;
+    int threads;
+    int cases;              // Случайных прогонов на уровень
+    uint32_t ticks;         // Предел тиков одного прогона
+    uint32_t seed;
+    int shrink;             // Предел попыток упрощения ввода
+    const char* data_root;
+    const char* output;
+    const char** replays;
+    int numReplays;
+} diff_options_t;
+
+// Прогон: старт уровня и ввод. Случайный ввод строится по seed в потоке.
+typedef struct {
+    int level;
+    int mode;
+    int score;              // < 0 - счёт и жизни старта уровня
+    int numLives;
+    uint32_t seed;          // Для случайного ввода
+    bool invincible;        // Случайный ввод с бессмертием (прогоны дольше)
+    const replay_t* replay; // Или ввод из реплея
+} diff_case_t;
+
+// Состояние потока: две стороны и буферы
+typedef struct {
+    DiffSide* cur;
+    DiffSide* ref;
+    uint8_t* inputs;
+    uint8_t* tilesCur;
+    uint8_t* tilesRef;
+    uint64_t ticks;         // Сверено тиков
+} diff_worker_t;
+
+typedef struct {
+    const diff_options_t* opt;
+    const diff_case_t* cases;
+    int numCases;
+    pthread_mutex_t lock;
+    int next;               // Следующий свободный прогон
+    int failed;             // Наименьший прогон с расхождением (numCases - нет)
+    uint32_t failedTicks;   // Его ввод до расходящегося тика включительно
+    uint8_t* failedInputs;
+    uint64_t ticks;
+} diff_shared_t;
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [-l level] [-n cases] [-t ticks] [-s seed] [-j threads] [-m shrink]\n"
+            "          [-d data_root] [-o fail.rpl] [replay.rpl ...]\n"
+            "  -l  только этот уровень (по умолчанию все)\n"
+            "  -n  случайных прогонов на уровень (по умолчанию 32, 0 - только реплеи)\n"
+            "  -t  предел тиков одного прогона (по умолчанию 20000)\n"
+            "  -s  seed первого прогона (по умолчанию 1)\n"
+            "  -j  потоков (по умолчанию по числу процессоров)\n"
+            "  -m  предел попыток упрощения ввода расхождения (по умолчанию 400)\n"
+            "  -d  каталог с levels/ (по умолчанию текущий)\n"
+            "  -o  минимальный реплей расхождения (по умолчанию diff_fail.rpl)\n"
+            "эталон: замороженное ядро host/ref\n",
+            argv0);
+}
+
+static int parse_args(int argc, char** argv, diff_options_t* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] != '-') {
+            opt->replays[opt->numReplays++] = argv[i];
+            continue;
+        }
+        if (i + 1 >= argc || argv[i][2] != '\0') return 0;
+        const char* value = argv[++i];
+        switch (argv[i - 1][1]) {
+            case 'l': opt->level = atoi(value); break;
+            case 'n': opt->cases = atoi(value); break;
+            case 't': opt->ticks = (uint32_t)strtoul(value, NULL, 0); break;
+            case 's': opt->seed = (uint32_t)strtoul(value, NULL, 0); break;
+            case 'j': opt->threads = atoi(value); break;
+            case 'm': opt->shrink = atoi(value); break;
+            case 'd': opt->data_root = value; break;
+            case 'o': opt->output = value; break;
+            default: return 0;
+        }
+    }
+    return opt->level >= 0 && opt->level <= MAX_LEVEL && opt->cases >= 0 &&
+           opt->ticks > 0 && opt->threads > 0 && opt->shrink >= 0;
+}
+
+// Генератор ввода как в bounce_headless: маска держится 4-35 тиков
+static uint32_t rng_next(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+static void random_inputs(const diff_case_t* c, uint8_t* inputs, uint32_t count) {
+    static const uint8_t masks[] = {
+        0, MOVE_LEFT, MOVE_RIGHT, MOVE_UP,
+        MOVE_LEFT | MOVE_UP, MOVE_RIGHT | MOVE_UP
+    };
+    uint32_t rng = c->seed;
+    uint32_t t = 0;
+    while (t < count) {
+        uint8_t input = masks[rng_next(&rng) % sizeof(masks)];
+        if (c->invincible) input |= REPLAY_FLAG_INVINCIBLE;
+        uint32_t hold = 4 + rng_next(&rng) % 32;
+        for (uint32_t k = 0; k < hold && t < count; k++) {
+            inputs[t++] = input;
+        }
+    }
+}
+
+// Ввод прогона в w->inputs; возвращает число тиков
+static uint32_t case_inputs(const diff_case_t* c, uint32_t limit, uint8_t* inputs) {
+    if (!c->replay) {
+        random_inputs(c, inputs, limit);
+        return limit;
+    }
+    uint32_t n = 0;
+    for (uint32_t r = 0; r < c->replay->numRuns; r++) {
+        for (uint32_t k = 0; k < c->replay->runs[r].length && n < limit; k++) {
+            inputs[n++] = c->replay->runs[r].input;
+        }
+    }
+    return n;
+}
+
+static bool diff_start(diff_worker_t* w, const diff_case_t* c) {
+    bool cur = diff_side_start(w->cur, c->level, c->mode, c->score, c->numLives);
+    bool ref = ref_diff_side_start(w->ref, c->level, c->mode, c->score, c->numLives);
+    return cur && ref;
+}
+
+// Сравнить стороны; при describe дописать отличия в report
+static bool diff_equal(diff_worker_t* w, char* report, size_t size) {
+    DiffState a, b;
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    diff_side_state(w->cur, &a);
+    ref_diff_side_state(w->ref, &b);
+    int na = diff_side_tiles(w->cur, w->tilesCur, DIFF_MAX_TILES);
+    int nb = ref_diff_side_tiles(w->ref, w->tilesRef, DIFF_MAX_TILES);
+    bool equal = memcmp(&a, &b, sizeof(a)) == 0 && na == nb &&
+                 memcmp(w->tilesCur, w->tilesRef, (size_t)(na > 0 ? na : 0)) == 0;
+    if (equal || !report) return equal;
+
+    size_t len = strlen(report);
+    int lines = 0;
+#define DIFF_LINE(...) do { \
+        if (lines++ < DIFF_MAX_REPORT_LINES && len < size) \
+            len += (size_t)snprintf(report + len, size - len, __VA_ARGS__); \
+    } while (0)
+    for (int i = 0; i < DIFF_NUM_FIELDS; i++) {
+        if (a.fields[i] != b.fields[i]) {
+            DIFF_LINE("  %-22s ref %d, cur %d\n", s_field_names[i], b.fields[i], a.fields[i]);
+        }
+    }
+    for (int i = 0; i < a.numMovingObjects && i < DIFF_MAX_MOVING; i++) {
+        if (memcmp(a.moving[i], b.moving[i], sizeof(a.moving[i])) != 0) {
+            DIFF_LINE("  moving[%d] offset/direction ref (%d,%d)/(%d,%d), cur (%d,%d)/(%d,%d)\n", i,
+                      b.moving[i][0], b.moving[i][1], b.moving[i][2], b.moving[i][3],
+                      a.moving[i][0], a.moving[i][1], a.moving[i][2], a.moving[i][3]);
+        }
+    }
+    if (a.width != b.width || a.height != b.height || a.numMovingObjects != b.numMovingObjects) {
+        DIFF_LINE("  level ref %dx%d (%d moving), cur %dx%d (%d moving)\n",
+                  b.width, b.height, b.numMovingObjects, a.width, a.height, a.numMovingObjects);
+    } else {
+        for (int i = 0; i < na; i++) {
+            if (w->tilesCur[i] != w->tilesRef[i]) {
+                DIFF_LINE("  tile (%d,%d)            ref 0x%02X, cur 0x%02X\n",
+                          i % a.width, i / a.width, w->tilesRef[i], w->tilesCur[i]);
+            }
+        }
+    }
+    if (lines > DIFF_MAX_REPORT_LINES && len < size) {
+        snprintf(report + len, size - len, "  ... еще %d отличий\n", lines - DIFF_MAX_REPORT_LINES);
+    }
+#undef DIFF_LINE
+    return false;
+}
+
+// Прогнать count тиков ввода на обеих сторонах. Возвращает номер первого
+// расходящегося тика (0 - сразу после старта, t - после t-го ввода) или -1.
+// Прогон заканчивается и раньше, если уровень завершен (STATE_GAME сменился).
+static long diff_run(diff_worker_t* w, const diff_case_t* c, const uint8_t* inputs,
+                     uint32_t count, char* report, size_t size) {
+    if (!diff_start(w, c)) {
+        if (report) snprintf(report, size, "  уровень %d не загрузился\n", c->level);
+        return 0;
+    }
+    if (!diff_equal(w, report, size)) return 0;
+
+    DiffState state;
+    for (uint32_t t = 0; t < count; t++) {
+        diff_side_tick(w->cur, inputs[t]);
+        ref_diff_side_tick(w->ref, inputs[t]);
+        w->ticks++;
+        if (!diff_equal(w, report, size)) return (long)t + 1;
+        diff_side_state(w->cur, &state);
+        if (state.fields[DIFF_FIELD_state] != STATE_GAME) break;
+    }
+    return -1;
+}
+
+static bool diff_worker_init(diff_worker_t* w, uint32_t ticks) {
+    memset(w, 0, sizeof(*w));
+    w->cur = diff_side_new();
+    w->ref = ref_diff_side_new();
+    w->inputs = (uint8_t*)malloc(ticks);
+    w->tilesCur = (uint8_t*)malloc(DIFF_MAX_TILES);
+    w->tilesRef = (uint8_t*)malloc(DIFF_MAX_TILES);
+    return w->cur && w->ref && w->inputs && w->tilesCur && w->tilesRef;
+}
+
+static void diff_worker_free(diff_worker_t* w) {
+    diff_side_free(w->cur);
+    ref_diff_side_free(w->ref);
+    free(w->inputs);
+    free(w->tilesCur);
+    free(w->tilesRef);
+}
+
+static void* diff_thread(void* arg) {
+    diff_shared_t* shared = (diff_shared_t*)arg;
+    diff_worker_t w;
+    if (!diff_worker_init(&w, shared->opt->ticks)) {
+        fprintf(stderr, "out of memory\n");
+        diff_worker_free(&w);
+        return NULL;
+    }
+
+    for (;;) {
+        pthread_mutex_lock(&shared->lock);
+        int index = shared->next++;
+        // Прогоны после уже найденного расхождения не нужны: в отчет идет наименьший
+        bool done = index >= shared->failed;
+        pthread_mutex_unlock(&shared->lock);
+        if (done) break;
+
+        const diff_case_t* c = &shared->cases[index];
+        uint32_t count = case_inputs(c, shared->opt->ticks, w.inputs);
+        long tick = diff_run(&w, c, w.inputs, count, NULL, 0);
+        if (tick >= 0) {
+            pthread_mutex_lock(&shared->lock);
+            if (index < shared->failed) {
+                shared->failed = index;
+                shared->failedTicks = (uint32_t)tick;
+                memcpy(shared->failedInputs, w.inputs, (size_t)tick);
+            }
+            pthread_mutex_unlock(&shared->lock);
+        }
+    }
+
+    pthread_mutex_lock(&shared->lock);
+    shared->ticks += w.ticks;
+    pthread_mutex_unlock(&shared->lock);
+    diff_worker_free(&w);
+    return NULL;
+}
+
+// Упростить ввод расхождения: каждый отрезок одинакового ввода по очереди
+// заменяется пустым вводом, если расхождение от этого не пропадает. Длина
+// ввода сокращается до нового первого расходящегося тика.
+static uint32_t diff_shrink(diff_worker_t* w, const diff_case_t* c, uint8_t* inputs,
+                            uint32_t count, int attempts) {
+    for (uint32_t start = 0; start < count && attempts > 0;) {
+        uint32_t end = start + 1;
+        while (end < count && inputs[end] == inputs[start]) end++;
+        uint8_t input = inputs[start];
+        if (input != 0) {
+            memset(inputs + start, 0, end - start);
+            attempts--;
+            long tick = diff_run(w, c, inputs, count, NULL, 0);
+            if (tick >= 0) {
+                count = (uint32_t)tick;
+            } else {
+                memset(inputs + start, input, end - start);
+            }
+        }
+        start = end;
+    }
+    return count;
+}
+
+static bool diff_save(const diff_case_t* c, const uint8_t* inputs, uint32_t count, const char* path) {
+    replay_t r;
+    replay_init(&r);
+    replay_begin(&r, c->level, (game_start_mode_t)c->mode, c->score, c->numLives);
+    bool ok = true;
+    for (uint32_t t = 0; t < count && ok; t++) {
+        ok = replay_record_tick(&r, inputs[t]);
+    }
+    ok = ok && replay_save(&r, path);
+    replay_free(&r);
+    return ok;
+}
+
+static int diff_report(const diff_options_t* opt, const diff_case_t* c,
+                       uint8_t* inputs, uint32_t count) {
+    diff_worker_t w;
+    if (!diff_worker_init(&w, count + 1)) {
+        fprintf(stderr, "out of memory\n");
+        diff_worker_free(&w);
+        return 1;
+    }
+    uint32_t original = count;
+    count = diff_shrink(&w, c, inputs, count, opt->shrink);
+
+    char report[4096] = "";
+    long tick = diff_run(&w, c, inputs, count, report, sizeof(report));
+    if (c->replay) {
+        printf("DIVERGENCE level %d, replay input\n", c->level);
+    } else {
+        printf("DIVERGENCE level %d, seed %u%s\n", c->level, (unsigned)c->seed,
+               c->invincible ? ", invincible" : "");
+    }
+    printf("first divergent tick %ld (input shrunk from %u to %u ticks), ref vs current:\n%s",
+           tick, (unsigned)original, (unsigned)count, report);
+
+    // Счёт и жизни старта нужны реплею явно (как после game_start_level)
+    diff_case_t saved = *c;
+    if (saved.score < 0) {
+        DiffState start;
+        diff_side_start(w.cur, c->level, c->mode, -1, 0);
+        diff_side_state(w.cur, &start);
+        saved.score = start.fields[DIFF_FIELD_score];
+        saved.numLives = start.fields[DIFF_FIELD_numLives];
+    }
+    if (diff_save(&saved, inputs, count, opt->output)) {
+        printf("reproducer: %s (bounce_diff %s)\n", opt->output, opt->output);
+    } else {
+        fprintf(stderr, "failed to write %s\n", opt->output);
+    }
+    diff_worker_free(&w);
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    const char* replayPaths[64];
+    diff_options_t opt = { 0, 0, 32, 20000, 1, 400, NULL, "diff_fail.rpl", replayPaths, 0 };
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    opt.threads = cpus > 0 ? (int)cpus : 1;
+    if (argc > (int)(sizeof(replayPaths) / sizeof(replayPaths[0])) || !parse_args(argc, argv, &opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (!diff_side_init(opt.data_root) || !ref_diff_side_init(opt.data_root)) {
+        fprintf(stderr, "failed to load levels\n");
+        return 1;
+    }
+
+    // Прогоны: сначала реплеи, затем случайный ввод по кругу уровней
+    int levels = opt.level ? 1 : MAX_LEVEL;
+    int numCases = opt.numReplays + levels * opt.cases;
+    diff_case_t* cases = (diff_case_t*)calloc((size_t)(numCases > 0 ? numCases : 1), sizeof(diff_case_t));
+    replay_t* replays = (replay_t*)calloc((size_t)(opt.numReplays > 0 ? opt.numReplays : 1), sizeof(replay_t));
+    if (!cases || !replays) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    int n = 0;
+    for (int i = 0; i < opt.numReplays; i++) {
+        replay_init(&replays[i]);
+        if (!replay_load(&replays[i], opt.replays[i])) {
+            fprintf(stderr, "failed to read replay %s\n", opt.replays[i]);
+            return 1;
+        }
+        diff_case_t* c = &cases[n++];
+        c->level = replays[i].level;
+        c->mode = replays[i].mode;
+        c->score = replays[i].score;
+        c->numLives = replays[i].numLives;
+        c->replay = &replays[i];
+    }
+    for (int k = 0; k < opt.cases; k++) {
+        for (int l = 0; l < levels; l++) {
+            diff_case_t* c = &cases[n++];
+            c->level = opt.level ? opt.level : l + 1;
+            c->mode = GAME_START_FRESH;
+            c->score = -1;
+            c->seed = opt.seed + (uint32_t)k;
+            c->invincible = (k & 1) != 0;
+        }
+    }
+
+    diff_shared_t shared;
+    memset(&shared, 0, sizeof(shared));
+    shared.opt = &opt;
+    shared.cases = cases;
+    shared.numCases = numCases;
+    shared.failed = numCases;
+    shared.failedInputs = (uint8_t*)malloc(opt.ticks);
+    pthread_mutex_init(&shared.lock, NULL);
+
+    uint64_t start_ns = host_time_ns();
+    int threads = opt.threads < numCases ? opt.threads : (numCases > 0 ? numCases : 1);
+    pthread_t* ids = (pthread_t*)calloc((size_t)threads, sizeof(pthread_t));
+    if (!shared.failedInputs || !ids) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&ids[i], NULL, diff_thread, &shared) != 0) {
+            fprintf(stderr, "failed to start thread\n");
+            return 1;
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    double seconds = (double)(host_time_ns() - start_ns) / 1e9;
+
+    int status = 0;
+    if (shared.failed < numCases) {
+        status = diff_report(&opt, &cases[shared.failed], shared.failedInputs, shared.failedTicks);
+    } else {
+        printf("%d runs, %llu ticks on %d threads in %.1f s: identical to ref\n",
+               numCases, (unsigned long long)shared.ticks, threads, seconds);
+    }
+
+    pthread_mutex_destroy(&shared.lock);
+    for (int i = 0; i < opt.numReplays; i++) {
+        replay_free(&replays[i]);
+    }
+    free(ids);
+    free(shared.failedInputs);
+    free(replays);
+    free(cases);
+    return status;
+}
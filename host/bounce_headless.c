@@ -0,0 +1,218 @@
+// bounce_headless.c - Прогон ядра симуляции без рендера, ввода и таймера
+// Крутит game_tick() с псевдослучайным вводом без ограничения частоты и
+// печатает итоговое состояние и скорость симуляции.
+// Вариант bounce_headless_stats (сборка с -DPHYSICS_STATS) дополнительно пишет
+// счетчики физики каждого тика в CSV (-c), чтобы найти тики, выходящие за бюджет.
+#include "platform_host.h"
+#include "game.h"
+#include "level.h"
+#include "types.h"
+#include "replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int level;
+    long ticks;
+    uint32_t seed;
+    const char* data_root;
+    const char* record_path;
+    const char* csv_path;
+} headless_options_t;
+
+// Детерминированный генератор ввода (LCG), одинаковый на всех платформах
+static uint32_t rng_next(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+static MoveMask random_input(uint32_t* rng, int* hold) {
+    static const MoveMask masks[] = {
+        0, MOVE_LEFT, MOVE_RIGHT, MOVE_UP,
+        MOVE_LEFT | MOVE_UP, MOVE_RIGHT | MOVE_UP
+    };
+    static MoveMask current = 0;
+    if (*hold <= 0) {
+        current = masks[rng_next(rng) % (sizeof(masks) / sizeof(masks[0]))];
+        *hold = 4 + (int)(rng_next(rng) % 32);
+    }
+    (*hold)--;
+    return current;
+}
+
+#ifdef PHYSICS_STATS
+_Static_assert(TILE_CLASS_COUNT == 16, "s_class_names must list every TileCollisionClass");
+static const char* const s_class_names[TILE_CLASS_COUNT] = {
+    "none", "brick", "rubber", "spike", "checkpoint", "exit", "moving_spike", "hoop",
+    "hoop_edge", "extra_life", "ramp", "speed", "deflator", "inflator", "gravity", "jump"
+};
+
+static void stats_csv_header(FILE* out) {
+    fprintf(out, "tick,level,ns,x,y,size,water,collisions,tile_tests,substeps_y,substeps_x,"
+                 "fast_substeps_y,fast_substeps_x,ramp_slides,enlarge_search");
+    for (int c = 0; c < TILE_CLASS_COUNT; c++) {
+        fprintf(out, ",class_%s", s_class_names[c]);
+    }
+    fputc('\n', out);
+}
+
+// Строка тика: время, положение мяча и счетчики, накопленные за тик
+static void stats_csv_row(FILE* out, long tick, const SimContext* sim, uint64_t ns) {
+    const Player* p = &sim->player;
+    const PhysicsStats* st = &sim->stats;
+    fprintf(out, "%ld,%d,%llu,%d,%d,%d,%d,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu",
+            tick, sim->levelNumber, (unsigned long long)ns, p->xPos, p->yPos, p->ballSize,
+            p->isInWater ? 1 : 0,
+            (unsigned long long)st->collisionCalls, (unsigned long long)st->tileTests,
+            (unsigned long long)st->substepsY, (unsigned long long)st->substepsX,
+            (unsigned long long)st->fastSubstepsY, (unsigned long long)st->fastSubstepsX,
+            (unsigned long long)st->rampSlides, (unsigned long long)st->enlargeSearch);
+    for (int c = 0; c < TILE_CLASS_COUNT; c++) {
+        fprintf(out, ",%llu", (unsigned long long)st->classTests[c]);
+    }
+    fputc('\n', out);
+}
+#endif
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+#ifdef PHYSICS_STATS
+            "usage: %s [-l level] [-t ticks] [-s seed] [-d data_root] [-r replay] [-c stats.csv]\n"
+#else
+            "usage: %s [-l level] [-t ticks] [-s seed] [-d data_root] [-r replay]\n"
+#endif
+            "  -l  номер уровня 1-%d (по умолчанию 1)\n"
+            "  -t  число тиков по 30 мс (по умолчанию 100000)\n"
+            "  -s  seed генератора ввода (по умолчанию 1)\n"
+            "  -d  каталог с levels/ (по умолчанию текущий)\n"
+            "  -r  записать реплей (путь от data root); прогон останавливается по завершении уровня\n"
+#ifdef PHYSICS_STATS
+            "  -c  счетчики физики по тикам в CSV\n"
+#endif
+            ,
+            argv0, MAX_LEVEL);
+}
+
+static int parse_args(int argc, char** argv, headless_options_t* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc || argv[i][0] != '-' || argv[i][2] != '\0') return 0;
+        const char* value = argv[++i];
+        switch (argv[i - 1][1]) {
+            case 'l': opt->level = atoi(value); break;
+            case 't': opt->ticks = atol(value); break;
+            case 's': opt->seed = (uint32_t)strtoul(value, NULL, 0); break;
+            case 'd': opt->data_root = value; break;
+            case 'r': opt->record_path = value; break;
+#ifdef PHYSICS_STATS
+            case 'c': opt->csv_path = value; break;
+#endif
+            default: return 0;
+        }
+    }
+    return opt->level >= 1 && opt->level <= MAX_LEVEL && opt->ticks > 0;
+}
+
+int main(int argc, char** argv) {
+    headless_options_t opt = { 1, 100000, 1, NULL, NULL, NULL };
+    if (!parse_args(argc, argv, &opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+    host_set_data_root(opt.data_root);
+
+    // Контекст целиком с картами уровня (~590 КБ) - в куче, а не на стеке
+    SimContext* sim = (SimContext*)calloc(1, sizeof(SimContext));
+    if (!sim) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    replay_t recording;
+    replay_init(&recording);
+    if (opt.record_path) {
+        game_attach_recorder(sim, &recording);
+    }
+
+    if (!game_start_level(sim, opt.level, GAME_START_FRESH)) {
+        fprintf(stderr, "failed to load level %d\n", opt.level);
+        sim_free(sim);
+        return 1;
+    }
+
+#ifdef PHYSICS_STATS
+    FILE* csv = NULL;
+    if (opt.csv_path) {
+        csv = fopen(opt.csv_path, "w");
+        if (!csv) {
+            fprintf(stderr, "failed to write %s\n", opt.csv_path);
+            sim_free(sim);
+            return 1;
+        }
+        stats_csv_header(csv);
+    }
+#endif
+
+    uint32_t rng = opt.seed;
+    int hold = 0;
+    long completions = 0, game_overs = 0, respawns = 0;
+    long events = 0;
+
+    uint64_t start_ns = host_time_ns();
+    long tick;
+    for (tick = 0; tick < opt.ticks; tick++) {
+#ifdef PHYSICS_STATS
+        memset(&sim->stats, 0, sizeof(sim->stats));
+        uint64_t tick_ns = host_time_ns();
+#endif
+        if (game_tick(sim, random_input(&rng, &hold))) {
+            respawns++;
+        }
+        events += sim->events.count;  // Звуки не нужны: события только считаются
+#ifdef PHYSICS_STATS
+        if (csv) stats_csv_row(csv, tick, sim, host_time_ns() - tick_ns);
+#endif
+        if (sim->state != STATE_GAME) {
+            if (sim->state == STATE_LEVEL_COMPLETE) completions++;
+            if (sim->state == STATE_GAME_OVER) game_overs++;
+            // Реплей описывает одну попытку от game_start_level()
+            if (opt.record_path) {
+                tick++;
+                break;
+            }
+            game_start_level(sim, opt.level, GAME_START_FRESH);
+        }
+    }
+    uint64_t elapsed_ns = host_time_ns() - start_ns;
+#ifdef PHYSICS_STATS
+    if (csv && fclose(csv) != 0) {
+        fprintf(stderr, "failed to write %s\n", opt.csv_path);
+    }
+#endif
+
+    if (opt.record_path) {
+        game_attach_recorder(sim, NULL);
+        if (!replay_save(&recording, opt.record_path)) {
+            fprintf(stderr, "failed to write replay %s\n", opt.record_path);
+            replay_free(&recording);
+            sim_free(sim);
+            return 1;
+        }
+        printf("replay %s: %u ticks in %u runs\n", opt.record_path,
+               (unsigned)recording.ticks, (unsigned)recording.numRuns);
+        replay_free(&recording);
+    }
+
+    const Player* p = &sim->player;
+    printf("level %d, %ld ticks, seed %u\n", opt.level, tick, (unsigned)opt.seed);
+    printf("respawns %ld, game overs %ld, completions %ld, events %ld\n",
+           respawns, game_overs, completions, events);
+    printf("player pos=(%d,%d) speed=(%d,%d) size=%d score=%d lives=%d rings=%d/%d\n",
+           p->xPos, p->yPos, p->xSpeed, p->ySpeed, p->ballSize,
+           sim->score, sim->numLives, sim->numRings, sim->level.totalRings);
+    printf("%.1f ns/tick, %.0f ticks/s\n",
+           (double)elapsed_ns / (double)tick,
+           (double)tick * 1e9 / (double)(elapsed_ns ? elapsed_ns : 1));
+    sim_free(sim);
+    return 0;
+}
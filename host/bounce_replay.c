@@ -0,0 +1,159 @@
+// bounce_replay.c - Воспроизведение реплея без рендера и таймера
+// Прогоняет записанный ввод через game_tick() без ограничения частоты и печатает
+// дайджест итогового состояния: одинаковый дайджест на двух сборках означает,
+// что оптимизация физики не изменила поведение на этой записи.
+// Если в реплее записаны хэши тиков (sim_hash), каждый тик сверяется с ними и
+// первый расходящийся тик сообщается сразу.
+#include "platform_host.h"
+#include "game.h"
+#include "level.h"
+#include "replay.h"
+#include "types.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// FNV-1a 64
+static uint64_t digest_bytes(uint64_t h, const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+static uint64_t digest_int(uint64_t h, int v) {
+    return digest_bytes(h, &v, sizeof(v));
+}
+
+// Дайджест по значимым полям (без паддинга структур)
+static uint64_t sim_state_digest(const SimContext* sim) {
+    const Player* p = &sim->player;
+    const Level* level = &sim->level;
+    uint64_t h = 0xCBF29CE484222325ULL;
+    const int fields[] = {
+        p->xPos, p->yPos, p->xSpeed, p->ySpeed, p->direction, p->ballSize,
+        p->jumpOffset, p->ballState, p->sizeState, p->mGroundedFlag, p->mCDRubberFlag,
+        p->mCDRampFlag, p->isInWater, p->speedBonusCntr, p->gravBonusCntr,
+        p->jumpBonusCntr, p->popCntr, p->slideCntr,
+        sim->state, sim->score, sim->numLives, sim->numRings,
+        game_exit_anim_offset(sim)
+    };
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        h = digest_int(h, fields[i]);
+    }
+    for (int y = 0; y < level->height; y++) {
+        for (int x = 0; x < level->width; x++) {
+            h = digest_int(h, level_get_tile_at(level, x, y));
+        }
+    }
+    for (int i = 0; i < level->numMovingObjects; i++) {
+        const MovingObject* obj = &level->movingObjects[i];
+        h = digest_int(h, obj->offset[0]);
+        h = digest_int(h, obj->offset[1]);
+        h = digest_int(h, obj->direction[0]);
+        h = digest_int(h, obj->direction[1]);
+    }
+    return h;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [-d data_root] [-n repeat] replay\n"
+            "  -d  каталог с levels/ (по умолчанию текущий); путь реплея тоже от него\n"
+            "  -n  прогнать реплей N раз подряд (для профилирования)\n",
+            argv0);
+}
+
+int main(int argc, char** argv) {
+    const char* data_root = NULL;
+    const char* path = NULL;
+    long repeat = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            data_root = argv[++i];
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            repeat = atol(argv[++i]);
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!path || repeat <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    host_set_data_root(data_root);
+
+    replay_t replay;
+    replay_init(&replay);
+    if (!replay_load(&replay, path)) {
+        fprintf(stderr, "failed to read replay %s\n", path);
+        return 1;
+    }
+
+    SimContext* sim = (SimContext*)calloc(1, sizeof(SimContext));
+    if (!sim) {
+        fprintf(stderr, "out of memory\n");
+        replay_free(&replay);
+        return 1;
+    }
+
+    uint64_t digest = 0;
+    uint64_t total_ticks = 0;
+    uint64_t start_ns = host_time_ns();
+    for (long run = 0; run < repeat; run++) {
+        replay_cursor_t cursor;
+        if (!replay_start(sim, &replay, &cursor)) {
+            fprintf(stderr, "failed to load level %d\n", replay.level);
+            sim_free(sim);
+            replay_free(&replay);
+            return 1;
+        }
+        while (replay_step(sim, &cursor)) {
+            total_ticks++;
+            uint64_t expected;
+            if (!replay_verify_hash(&cursor, sim, &expected)) {
+                const Player* p = &sim->player;
+                fprintf(stderr, "diverged at tick %u: hash %016llx, recorded %016llx\n"
+                                "player pos=(%d,%d) speed=(%d,%d) size=%d state=%d score=%d lives=%d rings=%d\n",
+                        (unsigned)cursor.tick - 1, (unsigned long long)sim_hash(sim),
+                        (unsigned long long)expected, p->xPos, p->yPos, p->xSpeed, p->ySpeed,
+                        p->ballSize, sim->state, sim->score, sim->numLives, sim->numRings);
+                sim_free(sim);
+                replay_free(&replay);
+                return 1;
+            }
+        }
+        uint64_t d = sim_state_digest(sim);
+        if (run > 0 && d != digest) {
+            fprintf(stderr, "run %ld diverged: %016llx != %016llx\n",
+                    run, (unsigned long long)d, (unsigned long long)digest);
+            sim_free(sim);
+            replay_free(&replay);
+            return 1;
+        }
+        digest = d;
+    }
+    uint64_t elapsed_ns = host_time_ns() - start_ns;
+
+    const Player* p = &sim->player;
+    printf("level %d, %u ticks, %u runs\n", replay.level, (unsigned)replay.ticks, (unsigned)replay.numRuns);
+    printf("player pos=(%d,%d) speed=(%d,%d) size=%d state=%d score=%d lives=%d rings=%d/%d\n",
+           p->xPos, p->yPos, p->xSpeed, p->ySpeed, p->ballSize, sim->state,
+           sim->score, sim->numLives, sim->numRings, sim->level.totalRings);
+    printf("digest %016llx\n", (unsigned long long)digest);
+    if (replay.numHashes > 0) {
+        printf("tick hashes match (%u ticks)\n", (unsigned)replay.numHashes);
+    }
+    printf("%.1f ns/tick, %.0f ticks/s\n",
+           (double)elapsed_ns / (double)(total_ticks ? total_ticks : 1),
+           (double)total_ticks * 1e9 / (double)(elapsed_ns ? elapsed_ns : 1));
+
+    sim_free(sim);
+    replay_free(&replay);
+    return 0;
+}
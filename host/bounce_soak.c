@@ -0,0 +1,395 @@
+// bounce_soak.c - Прогон случайного ввода на всех ядрах в поисках патологических тиков
+// Каждый прогон - уровень от старта до конца (или предела тиков) со своим seed
+// случайного ввода; нечетные прогоны - с бессмертием, чтобы уходить дальше.
+// После каждого тика по счетчикам физики (сборка с -DPHYSICS_STATS) проверяется:
+//   enlarge   - enlarge_ball() искал место дальше предела радиуса (-r);
+//   budget    - подшагов физики за тик (по X и Y, с коллизиями и свободным
+//               полетом) больше бюджета (-b);
+//   off-map   - центр мяча вне карты;
+//   frozen    - мяч не сдвинулся на тайл за -f тиков, и ни одна маска ввода,
+//               удерживаемая от этого состояния, его не сдвигает.
+// Бюджеты считаются в подшагах, а не во времени хоста, поэтому найденный тик
+// воспроизводится на любой машине. Прогон с нарушением повторяется с записью и
+// сохраняется реплеем (первые -k на вид), который воспроизводит bounce_replay.
+#include "platform_host.h"
+#include "game.h"
+#include "replay.h"
+#include "types.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SOAK_PROBE_TICKS 100   // Тиков удержания каждой маски при проверке застывшего мяча
+
+typedef enum {
+    SOAK_OK = 0,
+    SOAK_ENLARGE,
+    SOAK_BUDGET,
+    SOAK_OFF_MAP,
+    SOAK_FROZEN,
+    SOAK_NUM_KINDS
+} soak_kind_t;
+
+static const char* const s_kind_names[SOAK_NUM_KINDS] = {
+    "ok", "enlarge", "budget", "off-map", "frozen"
+};
+
+typedef struct {
+    int level;              // 0 - все уровни по кругу
+    long runs;              // Прогонов на уровень
+    uint32_t ticks;         // Предел тиков прогона
+    uint32_t seed;
+    int threads;
+    int budget;             // Подшагов физики за тик
+    int radius;             // Смещение enlarge_ball() в пикселях
+    int frozen;             // Тиков без сдвига на тайл до проверки
+    int keep;               // Реплеев на вид нарушения
+    const char* data_root;
+    const char* output;
+} soak_options_t;
+
+typedef struct {
+    int level;
+    uint32_t seed;
+    bool invincible;
+} soak_case_t;
+
+// Итог прогона: первое нарушение и худший тик
+typedef struct {
+    soak_kind_t kind;
+    uint32_t tick;          // Номер тика нарушения (с 1)
+    long value;             // Подшаги, радиус или тики без движения
+    int ballX, ballY;       // Мяч на тике нарушения
+    uint64_t ticks;         // Выполнено тиков
+    uint64_t worstSubsteps;
+    uint32_t worstSubstepsTick;
+    uint64_t worstRadius;
+    uint32_t worstRadiusTick;
+} soak_result_t;
+
+typedef struct {
+    const soak_options_t* opt;
+    pthread_mutex_t lock;
+    long next;              // Следующий прогон
+    long total;
+    uint64_t ticks;
+    long found[SOAK_NUM_KINDS];
+    // Худшие тики по всем прогонам
+    uint64_t worstSubsteps, worstRadius;
+    soak_case_t worstSubstepsCase, worstRadiusCase;
+    uint32_t worstSubstepsTick, worstRadiusTick;
+} soak_shared_t;
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [-l level] [-n runs] [-t ticks] [-s seed] [-j threads] [-b calls] [-r radius]\n"
+            "          [-f ticks] [-k keep] [-d data_root] [-o prefix]\n"
+            "  -l  только этот уровень (по умолчанию все)\n"
+            "  -n  прогонов на уровень (по умолчанию 256)\n"
+            "  -t  предел тиков прогона (по умолчанию 20000)\n"
+            "  -s  seed первого прогона (по умолчанию 1)\n"
+            "  -j  потоков (по умолчанию по числу процессоров)\n"
+            "  -b  бюджет подшагов физики за тик, X и Y вместе (по умолчанию 32)\n"
+            "  -r  предел смещения enlarge_ball() в пикселях (по умолчанию 24)\n"
+            "  -f  тиков без сдвига на тайл до проверки застывшего мяча (по умолчанию 300)\n"
+            "  -k  реплеев на вид нарушения (по умолчанию 4)\n"
+            "  -d  каталог с levels/ (по умолчанию текущий)\n"
+            "  -o  префикс файлов реплеев (по умолчанию soak_)\n",
+            argv0);
+}
+
+static int parse_args(int argc, char** argv, soak_options_t* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc || argv[i][0] != '-' || argv[i][2] != '\0') return 0;
+        const char* value = argv[++i];
+        switch (argv[i - 1][1]) {
+            case 'l': opt->level = atoi(value); break;
+            case 'n': opt->runs = atol(value); break;
+            case 't': opt->ticks = (uint32_t)strtoul(value, NULL, 0); break;
+            case 's': opt->seed = (uint32_t)strtoul(value, NULL, 0); break;
+            case 'j': opt->threads = atoi(value); break;
+            case 'b': opt->budget = atoi(value); break;
+            case 'r': opt->radius = atoi(value); break;
+            case 'f': opt->frozen = atoi(value); break;
+            case 'k': opt->keep = atoi(value); break;
+            case 'd': opt->data_root = value; break;
+            case 'o': opt->output = value; break;
+            default: return 0;
+        }
+    }
+    return opt->level >= 0 && opt->level <= MAX_LEVEL && opt->runs > 0 && opt->ticks > 0 &&
+           opt->threads > 0 && opt->budget > 0 && opt->radius > 0 && opt->frozen > 0 && opt->keep >= 0;
+}
+
+// Генератор ввода как в bounce_diff: маска держится 4-35 тиков
+static uint32_t rng_next(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+typedef struct {
+    uint32_t rng;
+    int hold;
+    MoveMask current;
+} soak_input_t;
+
+static MoveMask soak_next_input(soak_input_t* g) {
+    static const MoveMask masks[] = {
+        0, MOVE_LEFT, MOVE_RIGHT, MOVE_UP,
+        MOVE_LEFT | MOVE_UP, MOVE_RIGHT | MOVE_UP
+    };
+    if (g->hold <= 0) {
+        g->current = masks[rng_next(&g->rng) % (sizeof(masks) / sizeof(masks[0]))];
+        g->hold = 4 + (int)(rng_next(&g->rng) % 32);
+    }
+    g->hold--;
+    return g->current;
+}
+
+static void soak_case_at(const soak_options_t* opt, long index, soak_case_t* c) {
+    int levels = opt->level ? 1 : MAX_LEVEL;
+    c->level = opt->level ? opt->level : (int)(index % levels) + 1;
+    c->seed = opt->seed + (uint32_t)(index / levels);
+    c->invincible = ((index / levels) & 1) != 0;
+}
+
+static bool soak_off_map(const SimContext* sim) {
+    const Player* p = &sim->player;
+    return p->xPos < 0 || p->yPos < 0 ||
+           p->xPos >= sim->level.width * TILE_SIZE || p->yPos >= sim->level.height * TILE_SIZE;
+}
+
+// Сдвигает ли мяч хоть одна удерживаемая маска ввода: из снимка состояния каждая
+// маска держится SOAK_PROBE_TICKS тиков. Состояние sim восстанавливается.
+static bool soak_can_move(SimContext* sim, SimSnapshot* snap) {
+    static const MoveMask masks[] = {
+        0, MOVE_LEFT, MOVE_RIGHT, MOVE_UP,
+        MOVE_LEFT | MOVE_UP, MOVE_RIGHT | MOVE_UP
+    };
+    if (!sim_snapshot(sim, snap)) return true;
+    struct replay_s* recorder = sim->recorder;
+    sim->recorder = NULL;  // Пробные тики в реплей не пишутся
+    int x0 = sim->player.xPos, y0 = sim->player.yPos;
+    bool moved = false;
+    for (size_t m = 0; m < sizeof(masks) / sizeof(masks[0]) && !moved; m++) {
+        sim_restore(sim, snap);
+        for (int t = 0; t < SOAK_PROBE_TICKS && !moved; t++) {
+            game_tick(sim, masks[m]);
+            moved = sim->state != STATE_GAME || sim->numLives != snap->numLives ||
+                    abs(sim->player.xPos - x0) >= TILE_SIZE || abs(sim->player.yPos - y0) >= TILE_SIZE;
+        }
+    }
+    sim_restore(sim, snap);
+    sim->recorder = recorder;
+    return moved;
+}
+
+// Прогнать случай до первого нарушения, конца уровня или limit тиков.
+// С recorder ввод пишется в реплей (повтор найденного нарушения).
+static void soak_run(const soak_options_t* opt, SimContext* sim, SimSnapshot* snap, const soak_case_t* c,
+                     uint32_t limit, replay_t* recorder, soak_result_t* out) {
+    memset(out, 0, sizeof(*out));
+    game_attach_recorder(sim, recorder);
+    if (!game_start_level(sim, c->level, GAME_START_FRESH)) {
+        game_attach_recorder(sim, NULL);
+        return;
+    }
+    sim->invincible = c->invincible;
+
+    soak_input_t gen = { c->seed, 0, 0 };
+    int anchorX = sim->player.xPos, anchorY = sim->player.yPos;
+    int still = 0;
+    for (uint32_t t = 1; t <= limit && sim->state == STATE_GAME; t++) {
+        memset(&sim->stats, 0, sizeof(sim->stats));
+        game_tick(sim, soak_next_input(&gen));
+        out->ticks++;
+
+        uint64_t substeps = sim->stats.substepsX + sim->stats.substepsY +
+                            sim->stats.fastSubstepsX + sim->stats.fastSubstepsY;
+        if (substeps > out->worstSubsteps) {
+            out->worstSubsteps = substeps;
+            out->worstSubstepsTick = t;
+        }
+        if (sim->stats.enlargeRadius > out->worstRadius) {
+            out->worstRadius = sim->stats.enlargeRadius;
+            out->worstRadiusTick = t;
+        }
+
+        if (sim->stats.enlargeRadius > (uint64_t)opt->radius) {
+            out->kind = SOAK_ENLARGE;
+            out->value = (long)sim->stats.enlargeRadius;
+        } else if (substeps > (uint64_t)opt->budget) {
+            out->kind = SOAK_BUDGET;
+            out->value = (long)substeps;
+        } else if (soak_off_map(sim)) {
+            out->kind = SOAK_OFF_MAP;
+        } else if (abs(sim->player.xPos - anchorX) >= TILE_SIZE || abs(sim->player.yPos - anchorY) >= TILE_SIZE) {
+            anchorX = sim->player.xPos;
+            anchorY = sim->player.yPos;
+            still = 0;
+        } else if (++still >= opt->frozen && sim->state == STATE_GAME) {
+            if (!soak_can_move(sim, snap)) {
+                out->kind = SOAK_FROZEN;
+                out->value = still;
+            }
+            still = 0;
+        }
+        if (out->kind != SOAK_OK) {
+            out->tick = t;
+            out->ballX = sim->player.xPos;
+            out->ballY = sim->player.yPos;
+            break;
+        }
+    }
+    game_attach_recorder(sim, NULL);
+}
+
+// Повторить прогон с записью и сохранить реплей до тика нарушения включительно
+// в path. NULL - сохранен, иначе причина неудачи.
+static const char* soak_save(const soak_options_t* opt, SimContext* sim, SimSnapshot* snap,
+                             const soak_case_t* c, const soak_result_t* found, char* path, size_t size) {
+    snprintf(path, size, "%s%s_%02d_%u.rpl", opt->output, s_kind_names[found->kind],
+             c->level, (unsigned)c->seed);
+    replay_t r;
+    replay_init(&r);
+    soak_result_t again;
+    soak_run(opt, sim, snap, c, found->tick, &r, &again);
+    const char* error = NULL;
+    if (again.kind != found->kind || again.tick != found->tick) {
+        error = "does not reproduce";
+    } else if (!replay_save(&r, path)) {
+        error = "failed to write replay";
+    }
+    replay_free(&r);
+    return error;
+}
+
+static void* soak_thread(void* arg) {
+    soak_shared_t* shared = (soak_shared_t*)arg;
+    const soak_options_t* opt = shared->opt;
+    SimContext* sim = (SimContext*)calloc(1, sizeof(SimContext));
+    SimSnapshot* snap = (SimSnapshot*)malloc(sizeof(SimSnapshot));
+    if (!sim || !snap) {
+        fprintf(stderr, "out of memory\n");
+        sim_free(sim);
+        free(snap);
+        return NULL;
+    }
+
+    for (;;) {
+        pthread_mutex_lock(&shared->lock);
+        long index = shared->next++;
+        pthread_mutex_unlock(&shared->lock);
+        if (index >= shared->total) break;
+
+        soak_case_t c;
+        soak_case_at(opt, index, &c);
+        soak_result_t res;
+        soak_run(opt, sim, snap, &c, opt->ticks, NULL, &res);
+
+        pthread_mutex_lock(&shared->lock);
+        shared->ticks += res.ticks;
+        if (res.worstSubsteps > shared->worstSubsteps) {
+            shared->worstSubsteps = res.worstSubsteps;
+            shared->worstSubstepsCase = c;
+            shared->worstSubstepsTick = res.worstSubstepsTick;
+        }
+        if (res.worstRadius > shared->worstRadius) {
+            shared->worstRadius = res.worstRadius;
+            shared->worstRadiusCase = c;
+            shared->worstRadiusTick = res.worstRadiusTick;
+        }
+        bool save = res.kind != SOAK_OK && shared->found[res.kind]++ < opt->keep;
+        pthread_mutex_unlock(&shared->lock);
+        if (res.kind == SOAK_OK) continue;
+
+        // Повтор с записью - без блокировки: остальные потоки тем временем гоняют свои случаи
+        char path[1024];
+        const char* error = save ? soak_save(opt, sim, snap, &c, &res, path, sizeof(path)) : NULL;
+
+        // Строки отчета о случае печатаются вместе
+        pthread_mutex_lock(&shared->lock);
+        printf("level %d seed %u%s: %s at tick %u (%ld), ball (%d,%d)\n", c.level, (unsigned)c.seed,
+               c.invincible ? " invincible" : "", s_kind_names[res.kind], (unsigned)res.tick, res.value,
+               res.ballX, res.ballY);
+        if (save) {
+            if (error) {
+                printf("  -> %s: %s\n", path, error);
+            } else {
+                printf("  -> %s\n", path);
+            }
+        }
+        fflush(stdout);
+        pthread_mutex_unlock(&shared->lock);
+    }
+    free(snap);
+    sim_free(sim);
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    soak_options_t opt = { 0, 256, 20000, 1, 0, 32, 24, 300, 4, NULL, "soak_" };
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    opt.threads = cpus > 0 ? (int)cpus : 1;
+    if (!parse_args(argc, argv, &opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+    host_set_data_root(opt.data_root);
+
+    // Первая загрузка заполняет общий кэш файлов уровней - до запуска потоков
+    SimContext* sim = (SimContext*)calloc(1, sizeof(SimContext));
+    if (!sim || !game_start_level(sim, opt.level ? opt.level : 1, GAME_START_FRESH)) {
+        fprintf(stderr, "failed to load levels\n");
+        sim_free(sim);
+        return 1;
+    }
+    sim_free(sim);
+
+    soak_shared_t shared;
+    memset(&shared, 0, sizeof(shared));
+    shared.opt = &opt;
+    shared.total = opt.runs * (opt.level ? 1 : MAX_LEVEL);
+    pthread_mutex_init(&shared.lock, NULL);
+
+    uint64_t start_ns = host_time_ns();
+    int threads = opt.threads < shared.total ? opt.threads : (int)shared.total;
+    pthread_t* ids = (pthread_t*)calloc((size_t)threads, sizeof(pthread_t));
+    if (!ids) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&ids[i], NULL, soak_thread, &shared) != 0) {
+            fprintf(stderr, "failed to start thread\n");
+            return 1;
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    double seconds = (double)(host_time_ns() - start_ns) / 1e9;
+
+    printf("%ld runs, %llu ticks on %d threads in %.1f s (%.0f ticks/s)\n", shared.total,
+           (unsigned long long)shared.ticks, threads, seconds,
+           (double)shared.ticks / (seconds > 0 ? seconds : 1));
+    printf("worst tick: %llu substeps (level %d seed %u tick %u), budget %d\n",
+           (unsigned long long)shared.worstSubsteps, shared.worstSubstepsCase.level,
+           (unsigned)shared.worstSubstepsCase.seed, (unsigned)shared.worstSubstepsTick, opt.budget);
+    printf("worst enlarge_ball(): %llu px (level %d seed %u tick %u), limit %d\n",
+           (unsigned long long)shared.worstRadius, shared.worstRadiusCase.level,
+           (unsigned)shared.worstRadiusCase.seed, (unsigned)shared.worstRadiusTick, opt.radius);
+    long failures = 0;
+    printf("flagged:");
+    for (int k = SOAK_ENLARGE; k < SOAK_NUM_KINDS; k++) {
+        printf(" %s %ld", s_kind_names[k], shared.found[k]);
+        failures += shared.found[k];
+    }
+    printf("\n");
+
+    pthread_mutex_destroy(&shared.lock);
+    free(ids);
+    return failures ? 1 : 0;
+}
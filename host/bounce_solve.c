@@ -0,0 +1,749 @@
+// bounce_solve.c - Поиск маршрута прохождения уровня перебором ввода по тикам
+// Из стартового состояния уровня перебираются все 8 масок MoveMask на каждом
+// тике, пока какой-нибудь ветви не достанется game_complete_level(). Поиск идет
+// слоями (слой - номер тика), поэтому первый найденный маршрут - самый короткий
+// среди просмотренных ветвей:
+//   -w 0  полный поиск в ширину: если он уложился в пределы, маршрут
+//         минимален, а исчерпанный перебор доказывает, что уровень не пройти;
+//   -w N  лучевой поиск: в слое остаются N ветвей, ближайших к цели по карте
+//         расстояний (кольца, потом дверь), с ограничением на клетку и штрафом
+//         за клетки, где луч уже стоял, - маршрут находится быстро, но это
+//         только верхняя оценка числа тиков.
+// Повторы отсекаются общей таблицей транспозиций по sim_hash() (мяч, счетчики,
+// изменяемые ячейки карты и фаза шипов). Слой делится между потоками, и
+// освободившийся поток забирает половину чужого остатка. Найденный маршрут
+// пишется реплеем (-o), который проверяет bounce_replay.
+#include "platform_host.h"
+#include "game.h"
+#include "replay.h"
+#include "tile_table.h"
+#include "types.h"
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SOLVE_CHUNK 16                 // Узлов слоя, которые поток берет себе за раз
+#define SOLVE_NUM_INPUTS 8
+#define SOLVE_PER_CELL 8               // Ветвей луча на клетку карты
+#define SOLVE_VISIT_BITS 20             // Счетчики ветвей луча по клеткам за весь поиск
+#define SOLVE_VISIT_COST 16             // Ветвей в клетке на тайл штрафа
+#define SOLVE_FAR 0xFFFF               // Клетка карты расстояний, откуда цель недостижима
+
+// Все сочетания трёх направлений ввода
+static const MoveMask s_inputs[SOLVE_NUM_INPUTS] = {
+    0, MOVE_LEFT, MOVE_RIGHT, MOVE_LEFT | MOVE_RIGHT,
+    MOVE_UP, MOVE_LEFT | MOVE_UP, MOVE_RIGHT | MOVE_UP, MOVE_LEFT | MOVE_RIGHT | MOVE_UP
+};
+
+typedef struct {
+    int level;              // 0 - все уровни
+    int threads;
+    int width;              // Ширина луча (0 - полный поиск в ширину)
+    uint32_t ticks;         // Предел длины маршрута
+    long states;            // Предел состояний в таблице транспозиций
+    const char* data_root;
+    const char* output;
+} solve_options_t;
+
+// Карты расстояний в тайлах по проходимым клеткам (4-связность) до каждой
+// клетки активного кольца и до двери: оценка ветви в лучевом поиске
+typedef struct {
+    int width, height;
+    int numTargets;
+    int* targetX;
+    int* targetY;
+    uint16_t* dist;         // (numTargets + 1) карт width * height, последняя - до двери
+} solve_map_t;
+
+// Кандидат следующего слоя: ключ, оценка и ссылка на родителя
+typedef struct {
+    uint64_t key;
+    int score;
+    uint32_t cell;          // Клетка мяча, размер и собранные кольца (разнообразие луча)
+    uint32_t link;          // Индекс родителя * SOLVE_NUM_INPUTS + номер ввода
+} solve_child_t;
+
+// Необработанные узлы слоя у потока: [next, end)
+typedef struct {
+    pthread_mutex_t lock;
+    uint32_t next, end;
+} solve_range_t;
+
+struct solve_shared_s;
+
+typedef struct {
+    struct solve_shared_s* shared;
+    SimContext* sim;
+    SimSnapshot snap;
+    solve_range_t range;
+    solve_child_t* children;
+    uint8_t* states;        // Снимки детей по recSize байт
+    uint32_t numChildren, capacity;
+    uint64_t ticks;
+    bool failed;            // Не хватило памяти
+} solve_worker_t;
+
+typedef struct solve_shared_s {
+    const solve_options_t* opt;
+    const solve_map_t* map;
+    solve_worker_t* workers;
+    int numWorkers;
+    size_t recSize;         // Снимок без неиспользуемого хвоста tiles[]
+    const uint8_t* layer;   // Снимки узлов текущего слоя
+    uint32_t layerSize;
+
+    uint64_t* table;        // Открытая адресация, 0 - пустая ячейка
+    uint64_t tableMask;
+    uint64_t tableUsed;
+
+    pthread_barrier_t start, done;
+    pthread_mutex_t lock;
+    bool stop;
+    bool found;
+    uint32_t goalLink;      // Наименьшая ссылка на завершивший уровень тик
+} solve_shared_t;
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [-l level] [-w width] [-t ticks] [-m states] [-j threads] [-d data_root] [-o route]\n"
+            "  -l  номер уровня 1-%d (по умолчанию все)\n"
+            "  -w  ширина луча (по умолчанию 2048; 0 - полный поиск в ширину)\n"
+            "  -t  предел длины маршрута в тиках (по умолчанию 10000)\n"
+            "  -m  предел состояний в таблице транспозиций (по умолчанию 4000000)\n"
+            "  -j  потоков (по умолчанию по числу процессоров)\n"
+            "  -d  каталог с levels/ (по умолчанию текущий; свои уровни - в его levels/)\n"
+            "  -o  записать маршруты реплеями <route>NN.rpl\n",
+            argv0, MAX_LEVEL);
+}
+
+static int parse_args(int argc, char** argv, solve_options_t* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc || argv[i][0] != '-' || argv[i][2] != '\0') return 0;
+        const char* value = argv[++i];
+        switch (argv[i - 1][1]) {
+            case 'l': opt->level = atoi(value); break;
+            case 'w': opt->width = atoi(value); break;
+            case 't': opt->ticks = (uint32_t)strtoul(value, NULL, 0); break;
+            case 'm': opt->states = atol(value); break;
+            case 'j': opt->threads = atoi(value); break;
+            case 'd': opt->data_root = value; break;
+            case 'o': opt->output = value; break;
+            default: return 0;
+        }
+    }
+    return opt->level >= 0 && opt->level <= MAX_LEVEL && opt->width >= 0 &&
+           opt->width <= (1 << 24) && opt->ticks > 0 && opt->states > 0 && opt->threads > 0;
+}
+
+// === КАРТА РАССТОЯНИЙ ===
+
+static bool solve_ring_active(uint8_t id) {
+    return (id >= 13 && id <= 16) || (id >= 21 && id <= 24);
+}
+
+static bool solve_passable(const Level* level, int x, int y) {
+    uint8_t cls = level->collisionClass[y * level->stride + x];
+    return cls != TILE_CLASS_BRICK && cls != TILE_CLASS_RUBBER && cls != TILE_CLASS_SPIKE;
+}
+
+static void solve_flood(const Level* level, int x0, int y0, uint16_t* dist, int* queue) {
+    int w = level->width, h = level->height;
+    for (int i = 0; i < w * h; i++) dist[i] = SOLVE_FAR;
+    int head = 0, tail = 0;
+    dist[y0 * w + x0] = 0;
+    queue[tail++] = y0 * w + x0;
+    while (head < tail) {
+        int cell = queue[head++];
+        int x = cell % w, y = cell / w;
+        static const int dx[4] = { 1, -1, 0, 0 }, dy[4] = { 0, 0, 1, -1 };
+        for (int k = 0; k < 4; k++) {
+            int nx = x + dx[k], ny = y + dy[k];
+            if (nx < 0 || nx >= w || ny < 0 || ny >= h) continue;
+            int next = ny * w + nx;
+            if (dist[next] != SOLVE_FAR || !solve_passable(level, nx, ny)) continue;
+            dist[next] = (uint16_t)(dist[cell] + 1);
+            queue[tail++] = next;
+        }
+    }
+}
+
+static bool solve_map_build(solve_map_t* map, const Level* level) {
+    memset(map, 0, sizeof(*map));
+    map->width = level->width;
+    map->height = level->height;
+    int n = level->numMutableTiles > 0 ? level->numMutableTiles : 0;
+    size_t cells = (size_t)level->width * (size_t)level->height;
+    map->targetX = (int*)calloc((size_t)n + 1, sizeof(int));
+    map->targetY = (int*)calloc((size_t)n + 1, sizeof(int));
+    int* queue = (int*)malloc(cells * sizeof(int));
+    if (!map->targetX || !map->targetY || !queue) {
+        free(queue);
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        int x = level->mutableTiles[i] % level->stride, y = level->mutableTiles[i] / level->stride;
+        if (solve_ring_active(level_get_id(level, x, y))) {
+            map->targetX[map->numTargets] = x;
+            map->targetY[map->numTargets] = y;
+            map->numTargets++;
+        }
+    }
+    map->dist = (uint16_t*)malloc(cells * (size_t)(map->numTargets + 1) * sizeof(uint16_t));
+    if (!map->dist) {
+        free(queue);
+        return false;
+    }
+    for (int t = 0; t < map->numTargets; t++) {
+        solve_flood(level, map->targetX[t], map->targetY[t], map->dist + cells * (size_t)t, queue);
+    }
+    int ex = level->exitPosX, ey = level->exitPosY;
+    ex = ex < 0 ? 0 : (ex >= level->width ? level->width - 1 : ex);
+    ey = ey < 0 ? 0 : (ey >= level->height ? level->height - 1 : ey);
+    solve_flood(level, ex, ey, map->dist + cells * (size_t)map->numTargets, queue);
+    free(queue);
+    return true;
+}
+
+static void solve_map_free(solve_map_t* map) {
+    free(map->targetX);
+    free(map->targetY);
+    free(map->dist);
+}
+
+// Оценка ветви (меньше - ближе к цели): несобранные кольца, затем расстояние
+// до ближайшего из них или до двери, когда собраны все
+static int solve_score(const solve_map_t* map, const SimContext* sim) {
+    const Level* level = &sim->level;
+    int tx = sim->player.xPos / TILE_SIZE, ty = sim->player.yPos / TILE_SIZE;
+    tx = tx < 0 ? 0 : (tx >= map->width ? map->width - 1 : tx);
+    ty = ty < 0 ? 0 : (ty >= map->height ? map->height - 1 : ty);
+    size_t cells = (size_t)map->width * (size_t)map->height;
+    size_t at = (size_t)ty * (size_t)map->width + (size_t)tx;
+
+    int remaining = level->totalRings - sim->numRings;
+    int best = SOLVE_FAR;
+    if (remaining > 0) {
+        for (int t = 0; t < map->numTargets; t++) {
+            int d = map->dist[cells * (size_t)t + at];
+            if (d < best && solve_ring_active(level_get_id(level, map->targetX[t], map->targetY[t]))) {
+                best = d;
+            }
+        }
+    }
+    if (remaining <= 0 || best == SOLVE_FAR) {
+        best = map->dist[cells * (size_t)map->numTargets + at];
+        remaining = remaining > 0 ? remaining : 0;
+    }
+    return remaining * (SOLVE_FAR + 1) + best;
+}
+
+// === ТАБЛИЦА ТРАНСПОЗИЦИЙ ===
+
+// Ключ состояния. Биты направления game_tick() берет из ввода следующего тика
+// целиком, поэтому на будущее они не влияют и в ключ не входят.
+static uint64_t solve_key(SimContext* sim) {
+    MoveMask direction = sim->player.direction;
+    sim->player.direction = direction & ~(MOVE_LEFT | MOVE_RIGHT | MOVE_UP);
+    uint64_t key = sim_hash(sim);
+    sim->player.direction = direction;
+    return key ? key : 1;
+}
+
+// true, если состояние встретилось впервые
+static bool solve_visit(solve_shared_t* shared, uint64_t key) {
+    uint64_t slot = key & shared->tableMask;
+    for (;;) {
+        uint64_t expected = 0;
+        if (__atomic_compare_exchange_n(&shared->table[slot], &expected, key, false,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            __atomic_fetch_add(&shared->tableUsed, 1, __ATOMIC_RELAXED);
+            return true;
+        }
+        if (expected == key) return false;
+        slot = (slot + 1) & shared->tableMask;
+    }
+}
+
+// === РАЗВОРОТ СЛОЯ ===
+
+static bool solve_push(solve_worker_t* w, uint64_t key, int score, uint32_t cell, uint32_t link) {
+    size_t recSize = w->shared->recSize;
+    if (w->numChildren == w->capacity) {
+        uint32_t capacity = w->capacity ? w->capacity * 2 : 1024;
+        solve_child_t* children = (solve_child_t*)realloc(w->children, capacity * sizeof(solve_child_t));
+        if (children) w->children = children;
+        uint8_t* states = (uint8_t*)realloc(w->states, capacity * recSize);
+        if (states) w->states = states;
+        if (!children || !states) return false;
+        w->capacity = capacity;
+    }
+    solve_child_t* c = &w->children[w->numChildren];
+    c->key = key;
+    c->score = score;
+    c->cell = cell;
+    c->link = link;
+    sim_snapshot(w->sim, &w->snap);
+    memcpy(w->states + (size_t)w->numChildren * recSize, &w->snap, recSize);
+    w->numChildren++;
+    return true;
+}
+
+static void solve_expand_node(solve_worker_t* w, uint32_t node) {
+    solve_shared_t* shared = w->shared;
+    SimContext* sim = w->sim;
+    SimSnapshot parent;
+    memcpy(&parent, shared->layer + (size_t)node * shared->recSize, shared->recSize);
+    for (int k = 0; k < SOLVE_NUM_INPUTS; k++) {
+        sim_restore(sim, &parent);
+        game_tick(sim, s_inputs[k]);
+        w->ticks++;
+        uint32_t link = node * SOLVE_NUM_INPUTS + (uint32_t)k;
+        if (sim->state == STATE_LEVEL_COMPLETE) {
+            pthread_mutex_lock(&shared->lock);
+            if (!shared->found || link < shared->goalLink) {
+                shared->found = true;
+                shared->goalLink = link;
+            }
+            pthread_mutex_unlock(&shared->lock);
+            continue;
+        }
+        if (sim->state != STATE_GAME) continue;  // Game Over
+        uint64_t key = solve_key(sim);
+        if (!solve_visit(shared, key)) continue;
+        int score = shared->opt->width ? solve_score(shared->map, sim) : 0;
+        uint32_t cell = ((uint32_t)(sim->player.yPos / TILE_SIZE) & 0xFF) << 8 |
+                        ((uint32_t)(sim->player.xPos / TILE_SIZE) & 0xFF) |
+                        (uint32_t)sim->player.sizeState << 16 | (uint32_t)sim->numRings << 17;
+        if (!solve_push(w, key, score, cell, link)) {
+            w->failed = true;
+            return;
+        }
+    }
+}
+
+// Взять следующую порцию узлов: свою или половину самого большого чужого остатка
+static bool solve_take(solve_worker_t* w, uint32_t* first, uint32_t* count) {
+    solve_shared_t* shared = w->shared;
+    for (;;) {
+        pthread_mutex_lock(&w->range.lock);
+        if (w->range.next < w->range.end) {
+            *first = w->range.next;
+            *count = w->range.end - w->range.next < SOLVE_CHUNK ? w->range.end - w->range.next : SOLVE_CHUNK;
+            w->range.next += *count;
+            pthread_mutex_unlock(&w->range.lock);
+            return true;
+        }
+        pthread_mutex_unlock(&w->range.lock);
+
+        solve_worker_t* victim = NULL;
+        uint32_t most = 0;
+        for (int i = 0; i < shared->numWorkers; i++) {
+            solve_worker_t* other = &shared->workers[i];
+            pthread_mutex_lock(&other->range.lock);
+            uint32_t left = other->range.end - other->range.next;
+            pthread_mutex_unlock(&other->range.lock);
+            if (other != w && left > most) {
+                victim = other;
+                most = left;
+            }
+        }
+        if (!victim) return false;
+
+        pthread_mutex_lock(&victim->range.lock);
+        uint32_t left = victim->range.end - victim->range.next;
+        uint32_t begin = 0, end = 0;
+        if (left > 0) {
+            end = victim->range.end;
+            begin = end - (left + 1) / 2;
+            victim->range.end = begin;
+        }
+        pthread_mutex_unlock(&victim->range.lock);
+        if (begin == end) continue;  // Пока искали, остаток забрали
+
+        pthread_mutex_lock(&w->range.lock);
+        w->range.next = begin;
+        w->range.end = end;
+        pthread_mutex_unlock(&w->range.lock);
+    }
+}
+
+static void solve_expand(solve_worker_t* w) {
+    uint32_t first, count;
+    while (!w->failed && solve_take(w, &first, &count)) {
+        for (uint32_t i = 0; i < count && !w->failed; i++) {
+            solve_expand_node(w, first + i);
+        }
+    }
+}
+
+static void* solve_thread(void* arg) {
+    solve_worker_t* w = (solve_worker_t*)arg;
+    // Барьеры готовы, когда главный поток отпустит lock (см. solve_level)
+    pthread_mutex_lock(&w->shared->lock);
+    pthread_mutex_unlock(&w->shared->lock);
+    for (;;) {
+        pthread_barrier_wait(&w->shared->start);
+        if (w->shared->stop) break;
+        solve_expand(w);
+        pthread_barrier_wait(&w->shared->done);
+    }
+    return NULL;
+}
+
+// === ПОИСК ===
+
+typedef struct {
+    const solve_child_t* child;
+    int rank;               // Оценка со штрафом за давно занятую клетку
+    int worker;
+    uint32_t index;
+} solve_pick_t;
+
+static int solve_pick_cmp(const void* a, const void* b) {
+    const solve_pick_t* x = (const solve_pick_t*)a;
+    const solve_pick_t* y = (const solve_pick_t*)b;
+    if (x->rank != y->rank) return x->rank < y->rank ? -1 : 1;
+    if (x->child->key != y->child->key) return x->child->key < y->child->key ? -1 : 1;
+    return 0;
+}
+
+static uint32_t solve_cell_slot(uint32_t cell) {
+    return (cell * 2654435761u) >> (32 - SOLVE_VISIT_BITS);
+}
+
+// Отобрать в начало picks (упорядоченных по оценке) до keep детей, не больше
+// perCell на клетку: иначе луч сходится в одну точку, ближайшую к цели по
+// карте, и застревает в тупике. Возвращает число отобранных.
+static uint32_t solve_spread(solve_pick_t* picks, uint32_t n, uint32_t keep, int perCell) {
+    uint32_t slots = 1024;
+    while (slots < 2 * n) slots *= 2;
+    uint32_t* cells = (uint32_t*)malloc(slots * sizeof(uint32_t));
+    uint8_t* counts = (uint8_t*)calloc(slots, 1);
+    if (!cells || !counts) {
+        free(cells);
+        free(counts);
+        return keep;
+    }
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < n && kept < keep; i++) {
+        uint32_t cell = picks[i].child->cell;
+        uint32_t slot = (cell * 2654435761u) & (slots - 1);
+        while (counts[slot] && cells[slot] != cell) slot = (slot + 1) & (slots - 1);
+        cells[slot] = cell;
+        if (counts[slot] >= perCell) continue;
+        counts[slot]++;
+        picks[kept++] = picks[i];
+    }
+    free(cells);
+    free(counts);
+    return kept;
+}
+
+typedef enum {
+    SOLVE_FOUND = 0,
+    SOLVE_EXHAUSTED,        // Все достижимые состояния просмотрены
+    SOLVE_TICK_LIMIT,
+    SOLVE_STATE_LIMIT,
+    SOLVE_NO_MEMORY
+} solve_result_t;
+
+typedef struct {
+    solve_result_t result;
+    uint32_t length;        // Тиков в маршруте
+    uint8_t* route;         // Ввод по тикам
+    uint64_t states;
+    uint64_t ticks;
+} solve_outcome_t;
+
+// Ввод маршрута по ссылкам слоев: links[d][i] - ссылка узла i слоя d + 1
+static uint8_t* solve_route(uint32_t** links, uint32_t depth, uint32_t goalLink) {
+    uint8_t* route = (uint8_t*)malloc((size_t)depth + 1);
+    if (!route) return NULL;
+    uint32_t link = goalLink;
+    for (uint32_t d = depth + 1; d-- > 0;) {
+        route[d] = (uint8_t)s_inputs[link % SOLVE_NUM_INPUTS];
+        if (d > 0) link = links[d - 1][link / SOLVE_NUM_INPUTS];
+    }
+    return route;
+}
+
+static void solve_level(const solve_options_t* opt, SimContext* base, solve_outcome_t* out) {
+    memset(out, 0, sizeof(*out));
+    out->result = SOLVE_NO_MEMORY;
+
+    solve_shared_t shared;
+    memset(&shared, 0, sizeof(shared));
+    shared.opt = opt;
+    shared.recSize = (offsetof(SimSnapshot, tiles) + (size_t)base->level.numMutableTiles + 7) & ~(size_t)7;
+
+    // Таблица хотя бы вдвое больше предела: пробы остаются короткими
+    uint64_t slots = 1024;
+    uint64_t layerMax = opt->width ? (uint64_t)opt->width * SOLVE_NUM_INPUTS : 0;
+    while (slots < 2 * (uint64_t)opt->states || slots < 4 * layerMax) slots *= 2;
+    shared.table = (uint64_t*)calloc(slots, sizeof(uint64_t));
+    shared.tableMask = slots - 1;
+
+    solve_map_t map;
+    bool mapReady = solve_map_build(&map, &base->level);
+    shared.map = &map;
+
+    int threads = opt->threads;
+    shared.workers = (solve_worker_t*)calloc((size_t)threads, sizeof(solve_worker_t));
+    shared.numWorkers = threads;
+    uint8_t* layer = (uint8_t*)malloc(shared.recSize);
+    uint32_t** links = (uint32_t**)calloc((size_t)opt->ticks, sizeof(uint32_t*));
+    pthread_t* ids = (pthread_t*)calloc((size_t)threads, sizeof(pthread_t));
+    uint32_t* visits = (uint32_t*)calloc((size_t)1 << SOLVE_VISIT_BITS, sizeof(uint32_t));
+    bool ready = shared.table && mapReady && shared.workers && layer && links && ids && visits;
+    for (int i = 0; ready && i < threads; i++) {
+        solve_worker_t* w = &shared.workers[i];
+        w->shared = &shared;
+        w->sim = sim_clone(base);
+        ready = w->sim != NULL;
+        pthread_mutex_init(&w->range.lock, NULL);
+    }
+    if (!ready) {
+        fprintf(stderr, "out of memory\n");
+        goto cleanup;
+    }
+
+    // Потоки ждут на lock, пока барьеры не созданы по числу реально запущенных
+    pthread_mutex_init(&shared.lock, NULL);
+    pthread_mutex_lock(&shared.lock);
+    int started = 1;
+    for (; started < threads; started++) {
+        if (pthread_create(&ids[started], NULL, solve_thread, &shared.workers[started]) != 0) break;
+    }
+    if (started < threads) {
+        fprintf(stderr, "failed to start thread: searching with %d of %d\n", started, threads);
+    }
+    shared.numWorkers = started;
+    pthread_barrier_init(&shared.start, NULL, (unsigned)started);
+    pthread_barrier_init(&shared.done, NULL, (unsigned)started);
+    pthread_mutex_unlock(&shared.lock);
+
+    sim_snapshot(base, &shared.workers[0].snap);
+    memcpy(layer, &shared.workers[0].snap, shared.recSize);
+    solve_visit(&shared, solve_key(base));
+    shared.layer = layer;
+    shared.layerSize = 1;
+
+    out->result = SOLVE_TICK_LIMIT;
+    for (uint32_t depth = 0; depth < opt->ticks; depth++) {
+        // Слой делится поровну, дальше потоки перераспределяют его сами
+        for (int i = 0; i < started; i++) {
+            solve_worker_t* w = &shared.workers[i];
+            w->range.next = (uint32_t)((uint64_t)shared.layerSize * (uint64_t)i / (uint64_t)started);
+            w->range.end = (uint32_t)((uint64_t)shared.layerSize * (uint64_t)(i + 1) / (uint64_t)started);
+            w->numChildren = 0;
+        }
+        pthread_barrier_wait(&shared.start);
+        solve_expand(&shared.workers[0]);
+        pthread_barrier_wait(&shared.done);
+
+        uint64_t total = 0;
+        bool failed = false;
+        for (int i = 0; i < started; i++) {
+            total += shared.workers[i].numChildren;
+            failed |= shared.workers[i].failed;
+        }
+        if (failed) {
+            out->result = SOLVE_NO_MEMORY;
+            break;
+        }
+        if (shared.found) {
+            out->result = SOLVE_FOUND;
+            out->length = depth + 1;
+            out->route = solve_route(links, depth, shared.goalLink);
+            if (!out->route) out->result = SOLVE_NO_MEMORY;
+            break;
+        }
+        if (total == 0) {
+            out->result = opt->width ? SOLVE_TICK_LIMIT : SOLVE_EXHAUSTED;
+            if (opt->width) out->length = depth + 1;  // Луч обрезал все ветви
+            break;
+        }
+        if (!opt->width && (total > (uint64_t)opt->states || total >= (1u << 28))) {
+            out->result = SOLVE_STATE_LIMIT;
+            break;
+        }
+
+        // Следующий слой: все дети или лучшие width по оценке
+        solve_pick_t* picks = (solve_pick_t*)malloc((size_t)total * sizeof(solve_pick_t));
+        uint32_t keep = opt->width && total > (uint64_t)opt->width ? (uint32_t)opt->width : (uint32_t)total;
+        uint8_t* next = (uint8_t*)malloc((size_t)keep * shared.recSize);
+        links[depth] = (uint32_t*)malloc((size_t)keep * sizeof(uint32_t));
+        if (!picks || !next || !links[depth]) {
+            free(picks);
+            free(next);
+            out->result = SOLVE_NO_MEMORY;
+            break;
+        }
+        uint32_t n = 0;
+        for (int i = 0; i < started; i++) {
+            for (uint32_t c = 0; c < shared.workers[i].numChildren; c++) {
+                picks[n].child = &shared.workers[i].children[c];
+                picks[n].rank = picks[n].child->score +
+                                (int)(visits[solve_cell_slot(picks[n].child->cell)] / SOLVE_VISIT_COST);
+                picks[n].worker = i;
+                picks[n].index = c;
+                n++;
+            }
+        }
+        if (keep < n) {
+            qsort(picks, n, sizeof(solve_pick_t), solve_pick_cmp);
+            keep = solve_spread(picks, n, keep, SOLVE_PER_CELL);
+        }
+        for (uint32_t i = 0; i < keep; i++) {
+            const solve_worker_t* w = &shared.workers[picks[i].worker];
+            memcpy(next + (size_t)i * shared.recSize, w->states + (size_t)picks[i].index * shared.recSize,
+                   shared.recSize);
+            links[depth][i] = picks[i].child->link;
+            visits[solve_cell_slot(picks[i].child->cell)]++;
+        }
+        free(picks);
+        free(layer);
+        layer = next;
+        shared.layer = layer;
+        shared.layerSize = keep;
+
+        // Лучу таблица нужна для отсева повторов в ближайших слоях: переполненная
+        // очищается. Полному поиску без нее нет доказательства - предел.
+        if (shared.tableUsed > (uint64_t)opt->states) {
+            if (!opt->width) {
+                out->result = SOLVE_STATE_LIMIT;
+                out->states += shared.tableUsed;
+                shared.tableUsed = 0;
+                break;
+            }
+            out->states += shared.tableUsed;
+            memset(shared.table, 0, (size_t)slots * sizeof(uint64_t));
+            shared.tableUsed = 0;
+        }
+    }
+
+    shared.stop = true;
+    pthread_barrier_wait(&shared.start);
+    for (int i = 1; i < started; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    pthread_barrier_destroy(&shared.start);
+    pthread_barrier_destroy(&shared.done);
+    pthread_mutex_destroy(&shared.lock);
+
+cleanup:
+    out->states += shared.tableUsed;
+    for (uint32_t d = 0; links && d < opt->ticks; d++) {
+        free(links[d]);
+    }
+    for (int i = 0; shared.workers && i < threads; i++) {
+        solve_worker_t* w = &shared.workers[i];
+        out->ticks += w->ticks;
+        if (w->shared) pthread_mutex_destroy(&w->range.lock);
+        sim_free(w->sim);
+        free(w->children);
+        free(w->states);
+    }
+    if (mapReady) solve_map_free(&map);
+    free(visits);
+    free(ids);
+    free(links);
+    free(layer);
+    free(shared.workers);
+    free(shared.table);
+}
+
+// Прогнать маршрут с записью реплея; true, если он проходит уровень
+static bool solve_save(SimContext* sim, int level, const uint8_t* route, uint32_t length, const char* path) {
+    replay_t r;
+    replay_init(&r);
+    game_attach_recorder(sim, &r);
+    bool ok = game_start_level(sim, level, GAME_START_FRESH);
+    for (uint32_t t = 0; ok && t < length; t++) {
+        game_tick(sim, route[t]);
+    }
+    game_attach_recorder(sim, NULL);
+    ok = ok && sim->state == STATE_LEVEL_COMPLETE && (!path || replay_save(&r, path));
+    replay_free(&r);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    solve_options_t opt = { 0, 0, 2048, 10000, 4000000, NULL, NULL };
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    opt.threads = cpus > 0 ? (int)cpus : 1;
+    if (!parse_args(argc, argv, &opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+    host_set_data_root(opt.data_root);
+
+    SimContext* sim = (SimContext*)calloc(1, sizeof(SimContext));
+    if (!sim) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    int status = 0;
+    int first = opt.level ? opt.level : 1, last = opt.level ? opt.level : MAX_LEVEL;
+    for (int level = first; level <= last; level++) {
+        if (!game_start_level(sim, level, GAME_START_FRESH) || sim->level.numMutableTiles < 0) {
+            fprintf(stderr, "failed to load level %d\n", level);
+            status = 1;
+            continue;
+        }
+
+        uint64_t start_ns = host_time_ns();
+        solve_outcome_t out;
+        solve_level(&opt, sim, &out);
+        double seconds = (double)(host_time_ns() - start_ns) / 1e9;
+
+        printf("level %2d: ", level);
+        switch (out.result) {
+            case SOLVE_FOUND:
+                if (opt.width) {
+                    printf("route %u ticks (beam %d, upper bound)", (unsigned)out.length, opt.width);
+                } else {
+                    printf("minimal route %u ticks", (unsigned)out.length);
+                }
+                break;
+            case SOLVE_EXHAUSTED:
+                printf("not completable: every reachable state explored");
+                break;
+            case SOLVE_TICK_LIMIT:
+                if (opt.width && out.length) {
+                    printf("no route: beam lost every branch at tick %u", (unsigned)out.length);
+                } else {
+                    printf("no route within %u ticks", (unsigned)opt.ticks);
+                }
+                break;
+            case SOLVE_STATE_LIMIT:
+                printf("no route: state limit %ld reached", opt.states);
+                break;
+            case SOLVE_NO_MEMORY:
+                printf("out of memory");
+                break;
+        }
+        printf(", %llu states, %llu ticks, %.1f s\n",
+               (unsigned long long)out.states, (unsigned long long)out.ticks, seconds);
+
+        if (out.result == SOLVE_FOUND) {
+            char path[1024];
+            if (opt.output) snprintf(path, sizeof(path), "%s%02d.rpl", opt.output, level);
+            if (!solve_save(sim, level, out.route, out.length, opt.output ? path : NULL)) {
+                fprintf(stderr, "level %d: route does not replay\n", level);
+                status = 1;
+            } else if (opt.output) {
+                printf("          %s\n", path);
+            }
+        } else {
+            status = 1;
+        }
+        free(out.route);
+    }
+    sim_free(sim);
+    return status;
+}
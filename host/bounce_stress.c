@@ -0,0 +1,525 @@
+// bounce_stress.c - Худший тик и худший кадр на синтетических уровнях предельного размера
+// Генерирует уровни MAX_LEVEL_WIDTH x MAX_LEVEL_HEIGHT (255x255) в формате
+// levels/J2MElvl.NNN: плотные рампы, тонкие кольца, вода, бонусы и все
+// MAX_MOVING_OBJECTS движущихся шипов вокруг старта - такие карты может собрать
+// автор пользовательского уровня. По каждому уровню гоняется враждебный ввод
+// (удержание, дрожание маски каждый тик, длинные проходы с прыжками); после
+// каждого тика рендерится кадр level_render_visible_area() с камерой игры.
+// Дополнительно камера проходит все положения на карте с шагом в тайл.
+//
+// Графика подменена счетчиками (render_host.c): время кадра - это только
+// процессорная часть обхода тайлов на хосте, без GU. Время тика и кадра - хоста,
+// а не PSP: бюджеты 30 мс и 16.6 мс печатаются как запас (во сколько раз
+// медленнее может быть цель). Число примитивов кадра от платформы не зависит.
+// Новый худший замер повторяется -r раз из снимка состояния, в зачет идет
+// минимум, чтобы вытеснение потока не выдавалось за дорогой тик.
+#include "platform_host.h"
+#include "render_host.h"
+#include "game.h"
+#include "level.h"
+#include "solid_bitmap.h"
+#include "types.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define STRESS_TICK_BUDGET_NS  30000000ULL   // Фиксированный тик игры
+#define STRESS_FRAME_BUDGET_NS 16600000ULL   // Кадр при 60 Гц
+#define STRESS_LEVEL_BYTES     (8 + MAX_LEVEL_WIDTH * MAX_LEVEL_HEIGHT + 1 + MAX_MOVING_OBJECTS * 8)
+#define STRESS_CHECKPOINTS     8
+#define STRESS_SLOT            12            // Ячейка сетки движущихся шипов вокруг старта, тайлов
+
+SimContext g_sim;  // Контекст, который читает level_render.c
+
+// Профиль синтетического уровня: доли ячеек на 1000 и число колец
+typedef struct {
+    const char* name;
+    int ramps, bricks, spikes, bonuses;
+    int water;          // Зон 8x8 под водой на 100
+    int hoops;          // Колец (пар ячеек); вместе с чекпоинтами < MAX_MUTABLE_TILES
+    int ballSize;       // BALL_SIZE_SMALL / BALL_SIZE_LARGE
+} stress_profile_t;
+
+static const stress_profile_t s_profiles[] = {
+    { "ramps", 320,  60,  0, 10, 10,  60, BALL_SIZE_SMALL },
+    { "hoops",  60,  60, 10, 10, 10, 240, BALL_SIZE_SMALL },
+    { "water", 120,  60, 20, 20, 90, 120, BALL_SIZE_LARGE },
+    { "mixed", 180, 100, 40, 30, 40, 200, BALL_SIZE_SMALL },
+};
+#define STRESS_NUM_PROFILES ((int)(sizeof(s_profiles) / sizeof(s_profiles[0])))
+
+_Static_assert(2 * 240 + STRESS_CHECKPOINTS + 1 <= MAX_MUTABLE_TILES,
+               "synthetic levels must keep snapshots (Level::numMutableTiles != -1)");
+
+static const uint8_t s_bonus_tiles[] = {
+    TILE_SPEED_BONUS, TILE_DEFLATOR_FLOOR, TILE_DEFLATOR_CEILING, TILE_INFLATOR_FLOOR,
+    TILE_INFLATOR_CEILING, TILE_GRAVITY_FLOOR, TILE_GRAVITY_CEILING, TILE_JUMP_FLOOR, TILE_JUMP_CEILING
+};
+
+typedef struct {
+    int level;              // 0 - все уровни
+    int runs;               // Прогонов на уровень
+    uint32_t ticks;         // Предел тиков прогона
+    uint32_t seed;
+    int repeats;            // Повторов нового худшего замера
+    const char* generate;   // Каталог для сгенерированных уровней
+    const char* data_root;  // Готовые уровни вместо генерации
+} stress_options_t;
+
+// Худший замер: время хоста (минимум повторов) и где он случился
+typedef struct {
+    uint64_t ns;
+    int level;
+    uint32_t seed;          // 0 - проход камеры
+    uint32_t tick;
+    int cameraX, cameraY;
+    render_host_counters_t draws;
+} stress_worst_t;
+
+typedef struct {
+    uint64_t ticks, tickNs;
+    uint64_t frames, frameNs;
+    stress_worst_t tick, frame;
+    stress_worst_t drawsFrame;   // Кадр с наибольшим числом примитивов
+    size_t solidBytes;           // Наибольшая построенная за прогон пиксельная карта
+} stress_result_t;
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [-l level] [-n runs] [-t ticks] [-s seed] [-r repeats] [-g dir | -d data_root]\n"
+            "  -l  только этот уровень (по умолчанию все)\n"
+            "  -n  прогонов враждебного ввода на уровень (по умолчанию 12)\n"
+            "  -t  предел тиков прогона (по умолчанию 3000)\n"
+            "  -s  seed генерации и первого прогона (по умолчанию 1)\n"
+            "  -r  повторов нового худшего замера, в зачет минимум (по умолчанию 5)\n"
+            "  -g  каталог для сгенерированных уровней (по умолчанию stress)\n"
+            "  -d  гонять готовые уровни из каталога с levels/ без генерации\n",
+            argv0);
+}
+
+static int parse_args(int argc, char** argv, stress_options_t* opt) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc || argv[i][0] != '-' || argv[i][2] != '\0') return 0;
+        const char* value = argv[++i];
+        switch (argv[i - 1][1]) {
+            case 'l': opt->level = atoi(value); break;
+            case 'n': opt->runs = atoi(value); break;
+            case 't': opt->ticks = (uint32_t)strtoul(value, NULL, 0); break;
+            case 's': opt->seed = (uint32_t)strtoul(value, NULL, 0); break;
+            case 'r': opt->repeats = atoi(value); break;
+            case 'g': opt->generate = value; break;
+            case 'd': opt->data_root = value; break;
+            default: return 0;
+        }
+    }
+    return opt->level >= 0 && opt->level <= MAX_LEVEL && opt->runs > 0 && opt->ticks > 0 &&
+           opt->repeats > 0;
+}
+
+static uint32_t rng_next(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+// --- Генерация ---
+
+// Записать тайл, сохранив флаг воды ячейки
+static void stress_put(uint8_t* map, int x, int y, int id) {
+    uint8_t* cell = &map[y * MAX_LEVEL_WIDTH + x];
+    *cell = (uint8_t)((*cell & TILE_FLAG_WATER) | id);
+}
+
+static int stress_id(const uint8_t* map, int x, int y) {
+    return map[y * MAX_LEVEL_WIDTH + x] & TILE_ID_MASK;
+}
+
+// Свободна ли ячейка под кольцо или чекпоинт: не шипы, не дверь, не другое
+// кольцо и не клетки вокруг старта
+static bool stress_free(const uint8_t* map, int x, int y, int sx, int sy) {
+    int id = stress_id(map, x, y);
+    if (id == TILE_EXIT || id == TILE_MOVING_SPIKES || (id >= 13 && id <= 28) || id == TILE_CHECKPOINT) {
+        return false;
+    }
+    return abs(x - sx) > 1 || abs(y - sy) > 1;
+}
+
+// Собрать уровень профиля в out (STRESS_LEVEL_BYTES). Возвращает размер файла.
+static int stress_generate(const stress_profile_t* p, uint32_t seed, uint8_t* out) {
+    const int w = MAX_LEVEL_WIDTH, h = MAX_LEVEL_HEIGHT;
+    const int sx = w / 2, sy = h / 2;
+    const int exitX = w - 4, exitY = h - 4;
+    uint8_t* map = out + 8;
+    uint32_t rng = seed;
+
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int id = 0;
+            int r = (int)(rng_next(&rng) % 1000);
+            if (x == 0 || y == 0 || x == w - 1 || y == h - 1) {
+                id = TILE_BRICK_RED;
+            } else if (r < p->ramps) {
+                id = 30 + (int)(rng_next(&rng) % 8);
+            } else if ((r -= p->ramps) < p->bricks) {
+                id = (rng_next(&rng) & 1) ? TILE_BRICK_BLUE : TILE_BRICK_RED;
+            } else if ((r -= p->bricks) < p->spikes) {
+                id = TILE_SPIKE_UP + (int)(rng_next(&rng) % 4);
+            } else if ((r -= p->spikes) < p->bonuses) {
+                id = s_bonus_tiles[rng_next(&rng) % sizeof(s_bonus_tiles)];
+            }
+            map[y * w + x] = (uint8_t)id;
+        }
+    }
+    for (int zy = 0; zy < h; zy += 8) {
+        for (int zx = 0; zx < w; zx += 8) {
+            if ((int)(rng_next(&rng) % 100) >= p->water) continue;
+            for (int y = zy; y < zy + 8 && y < h; y++) {
+                for (int x = zx; x < zx + 8 && x < w; x++) {
+                    map[y * w + x] |= TILE_FLAG_WATER;
+                }
+            }
+        }
+    }
+
+    // Движущиеся шипы - сетка 4x4 ячеек по STRESS_SLOT тайлов с центром в старте;
+    // области занимают тайлы 2..10 своей ячейки, поэтому клетки старта свободны
+    uint8_t* moving = map + w * h;
+    *moving++ = MAX_MOVING_OBJECTS;
+    for (int i = 0; i < MAX_MOVING_OBJECTS; i++) {
+        int x0 = sx - 2 * STRESS_SLOT + (i % 4) * STRESS_SLOT + 2;
+        int y0 = sy - 2 * STRESS_SLOT + (i / 4) * STRESS_SLOT + 2;
+        int sizeX = 2, sizeY = 9, dirX = 0, dirY = 1;   // Вертикальный ход
+        if (i % 3 == 1) {
+            sizeX = 9; sizeY = 2; dirX = 1; dirY = 0;  // Горизонтальный
+        } else if (i % 3 == 2) {
+            sizeX = 6; sizeY = 6; dirX = 1; dirY = 1;  // Диагональный
+        }
+        if (rng_next(&rng) & 1) dirX = -dirX;
+        if (rng_next(&rng) & 1) dirY = -dirY;
+        for (int y = y0; y < y0 + sizeY; y++) {
+            for (int x = x0; x < x0 + sizeX; x++) {
+                stress_put(map, x, y, TILE_MOVING_SPIKES);
+            }
+        }
+        int offX = dirX ? (int)(rng_next(&rng) % (uint32_t)((sizeX - 2) * TILE_SIZE + 1)) : 0;
+        int offY = dirY ? (int)(rng_next(&rng) % (uint32_t)((sizeY - 2) * TILE_SIZE + 1)) : 0;
+        const uint8_t obj[8] = {
+            (uint8_t)x0, (uint8_t)y0, (uint8_t)(x0 + sizeX), (uint8_t)(y0 + sizeY),
+            (uint8_t)(int8_t)dirX, (uint8_t)(int8_t)dirY, (uint8_t)offX, (uint8_t)offY
+        };
+        memcpy(moving, obj, sizeof(obj));
+        moving += sizeof(obj);
+    }
+
+    for (int y = sy - 1; y <= sy + 1; y++) {
+        for (int x = sx - 1; x <= sx + 1; x++) {
+            stress_put(map, x, y, TILE_EMPTY);
+        }
+    }
+    for (int y = exitY; y < exitY + 2; y++) {
+        for (int x = exitX; x < exitX + 2; x++) {
+            stress_put(map, x, y, TILE_EXIT);
+        }
+    }
+
+    // Кольца: вертикальные 13/14 и 21/22 (верх над низом), горизонтальные
+    // 15/16 и 23/24 (левая половина слева) - как на уровнях игры
+    int rings = 0;
+    for (int attempt = 0; rings < p->hoops && attempt < p->hoops * 64; attempt++) {
+        int x = 1 + (int)(rng_next(&rng) % (uint32_t)(w - 3));
+        int y = 1 + (int)(rng_next(&rng) % (uint32_t)(h - 3));
+        int kind = (int)(rng_next(&rng) % 4);
+        int first = (kind & 2) ? 21 : 13;
+        int horiz = kind & 1;
+        int x2 = x + horiz, y2 = y + !horiz;
+        if (!stress_free(map, x, y, sx, sy) || !stress_free(map, x2, y2, sx, sy)) continue;
+        stress_put(map, x, y, first + 2 * horiz);
+        stress_put(map, x2, y2, first + 2 * horiz + 1);
+        rings++;
+    }
+    for (int placed = 0, attempt = 0; placed < STRESS_CHECKPOINTS && attempt < 1024; attempt++) {
+        int x = 1 + (int)(rng_next(&rng) % (uint32_t)(w - 2));
+        int y = 1 + (int)(rng_next(&rng) % (uint32_t)(h - 2));
+        if (!stress_free(map, x, y, sx, sy)) continue;
+        stress_put(map, x, y, TILE_CHECKPOINT);
+        placed++;
+    }
+
+    const uint8_t header[8] = {
+        (uint8_t)sx, (uint8_t)sy, (uint8_t)p->ballSize, (uint8_t)exitX, (uint8_t)exitY,
+        (uint8_t)rings, (uint8_t)w, (uint8_t)h
+    };
+    memcpy(out, header, sizeof(header));
+    return (int)(moving - out);
+}
+
+static bool stress_mkdir(const char* path) {
+    if (mkdir(path, 0777) == 0 || errno == EEXIST) return true;
+    fprintf(stderr, "failed to create %s: %s\n", path, strerror(errno));
+    return false;
+}
+
+// Записать уровни всех профилей в dir/levels/J2MElvl.001...
+static bool stress_write_levels(const char* dir, uint32_t seed) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/levels", dir);
+    if (!stress_mkdir(dir) || !stress_mkdir(path)) return false;
+
+    uint8_t* data = (uint8_t*)malloc(STRESS_LEVEL_BYTES);
+    if (!data) return false;
+    bool ok = true;
+    for (int i = 0; i < STRESS_NUM_PROFILES && ok; i++) {
+        int size = stress_generate(&s_profiles[i], seed + (uint32_t)i, data);
+        snprintf(path, sizeof(path), "%s/levels/J2MElvl.%03d", dir, i + 1);
+        FILE* f = fopen(path, "wb");
+        ok = f && fwrite(data, 1, (size_t)size, f) == (size_t)size;
+        if (f && fclose(f) != 0) ok = false;
+        if (!ok) fprintf(stderr, "failed to write %s\n", path);
+    }
+    free(data);
+    return ok;
+}
+
+// --- Замеры ---
+
+// Враждебный ввод: по seed одна из трех манер
+//   удержание маски 4-35 тиков, новая случайная маска каждый тик,
+//   длинные проходы в одну сторону с прыжком и сменой стороны
+typedef struct {
+    uint32_t rng;
+    int style;
+    int hold;
+    MoveMask current;
+} stress_input_t;
+
+static MoveMask stress_next_input(stress_input_t* g) {
+    static const MoveMask masks[] = {
+        0, MOVE_LEFT, MOVE_RIGHT, MOVE_UP,
+        MOVE_LEFT | MOVE_UP, MOVE_RIGHT | MOVE_UP
+    };
+    const int count = (int)(sizeof(masks) / sizeof(masks[0]));
+    if (g->style == 1) {
+        return masks[rng_next(&g->rng) % (uint32_t)count];
+    }
+    if (g->hold <= 0) {
+        if (g->style == 0) {
+            g->current = masks[rng_next(&g->rng) % (uint32_t)count];
+            g->hold = 4 + (int)(rng_next(&g->rng) % 32);
+        } else {
+            g->current = (g->current & MOVE_RIGHT) ? (MOVE_LEFT | MOVE_UP) : (MOVE_RIGHT | MOVE_UP);
+            g->hold = 100 + (int)(rng_next(&g->rng) % 400);
+        }
+    }
+    g->hold--;
+    return g->current;
+}
+
+static uint64_t stress_render(int cameraX, int cameraY) {
+    memset(&g_render_host, 0, sizeof(g_render_host));
+    uint64_t start = host_time_ns();
+    level_render_visible_area(cameraX, cameraY, SCREEN_WIDTH, SCREEN_HEIGHT - HUD_HEIGHT);
+    return host_time_ns() - start;
+}
+
+static uint64_t stress_draws(const render_host_counters_t* c) {
+    return c->rects + c->sprites;
+}
+
+// Кадр с камерой (cameraX, cameraY): счетчики и время; новый худший кадр
+// перерисовывается repeats раз, в зачет минимум
+static void stress_frame(const stress_options_t* opt, stress_result_t* res, int level, uint32_t seed,
+                         uint32_t tick, int cameraX, int cameraY) {
+    uint64_t ns = stress_render(cameraX, cameraY);
+    render_host_counters_t draws = g_render_host;
+    res->frames++;
+    res->frameNs += ns;
+
+    stress_worst_t here = { ns, level, seed, tick, cameraX, cameraY, draws };
+    if (stress_draws(&draws) > stress_draws(&res->drawsFrame.draws)) {
+        res->drawsFrame = here;
+    }
+    if (ns <= res->frame.ns) return;
+    for (int r = 0; r < opt->repeats; r++) {
+        uint64_t again = stress_render(cameraX, cameraY);
+        if (again < here.ns) here.ns = again;
+    }
+    if (here.ns > res->frame.ns) res->frame = here;
+}
+
+// Перенести мяч и точку респавна в случайную клетку с пустыми соседями:
+// от старта мяч редко уходит дальше арены движущихся шипов
+static void stress_place(SimContext* sim, uint32_t seed) {
+    const Level* level = &sim->level;
+    uint32_t rng = seed;
+    for (int attempt = 0; attempt < 100000; attempt++) {
+        int x = 1 + (int)(rng_next(&rng) % (uint32_t)(level->width - 2));
+        int y = 1 + (int)(rng_next(&rng) % (uint32_t)(level->height - 2));
+        bool empty = true;
+        for (int dy = -1; dy <= 1 && empty; dy++) {
+            for (int dx = -1; dx <= 1 && empty; dx++) {
+                empty = level_get_id(level, x + dx, y + dy) == TILE_EMPTY;
+            }
+        }
+        if (!empty) continue;
+        BallSizeState size = sim->player.sizeState;
+        int half = size == SMALL_SIZE_STATE ? HALF_NORMAL_SIZE : HALF_ENLARGED_SIZE;
+        player_init(sim, x * TILE_SIZE + half, y * TILE_SIZE + half, size);
+        sim->respawnX = x;
+        sim->respawnY = y;
+        game_reset_camera(sim);
+        return;
+    }
+}
+
+// Прогон враждебного ввода; новый худший тик повторяется из снимка.
+// Биты seed: 0 - бессмертие, 1 - старт в случайной клетке; seed % 3 - манера ввода
+static void stress_run(const stress_options_t* opt, SimSnapshot* snap, int level, uint32_t seed,
+                       stress_result_t* res) {
+    SimContext* sim = &g_sim;
+    if (!game_start_level(sim, level, GAME_START_FRESH)) return;
+    sim->invincible = (seed & 1) != 0;
+    if (seed & 2) stress_place(sim, seed);
+
+    stress_input_t gen = { seed, (int)(seed % 3), 0, 0 };
+    for (uint32_t t = 1; t <= opt->ticks && sim->state == STATE_GAME; t++) {
+        MoveMask input = stress_next_input(&gen);
+        bool saved = sim_snapshot(sim, snap);
+        uint64_t start = host_time_ns();
+        game_tick(sim, input);
+        uint64_t ns = host_time_ns() - start;
+        res->ticks++;
+        res->tickNs += ns;
+
+        if (ns > res->tick.ns) {
+            // Снимок восстанавливает то же состояние, и повтор тика с тем же вводом
+            // приводит к тому же результату - продолжение прогона не меняется
+            for (int r = 0; r < opt->repeats && saved; r++) {
+                sim_restore(sim, snap);
+                start = host_time_ns();
+                game_tick(sim, input);
+                uint64_t again = host_time_ns() - start;
+                if (again < ns) ns = again;
+            }
+            if (ns > res->tick.ns) {
+                stress_worst_t w = { ns, level, seed, t, 0, 0, { 0, 0, 0 } };
+                res->tick = w;
+            }
+        }
+
+        int cameraX, cameraY;
+        game_calculate_camera(sim, &cameraX, &cameraY);
+        stress_frame(opt, res, level, seed, t, cameraX, cameraY);
+    }
+    size_t solid = solid_bitmap_built_bytes(&sim->level);
+    if (solid > res->solidBytes) res->solidBytes = solid;
+}
+
+// Камера во всех положениях карты с шагом в тайл
+static void stress_sweep(const stress_options_t* opt, int level, stress_result_t* res) {
+    if (!game_start_level(&g_sim, level, GAME_START_FRESH)) return;
+    const int areaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
+    int maxX = g_sim.level.width * TILE_SIZE - SCREEN_WIDTH;
+    int maxY = g_sim.level.height * TILE_SIZE - areaHeight;
+    for (int cy = 0; cy <= (maxY > 0 ? maxY : 0); cy += TILE_SIZE) {
+        for (int cx = 0; cx <= (maxX > 0 ? maxX : 0); cx += TILE_SIZE) {
+            stress_frame(opt, res, level, 0, 0, cx, cy);
+        }
+    }
+}
+
+static double percent(uint64_t ns, uint64_t budget) {
+    return 100.0 * (double)ns / (double)budget;
+}
+
+static void print_worst(const char* what, const stress_worst_t* w, uint64_t budget) {
+    printf("  worst %s: %.1f us (%.2f%% of %.1f ms, headroom x%.0f)", what, (double)w->ns / 1e3,
+           percent(w->ns, budget), (double)budget / 1e6, w->ns ? (double)budget / (double)w->ns : 0.0);
+    if (w->seed) {
+        printf(" at level %d seed %u tick %u\n", w->level, (unsigned)w->seed, (unsigned)w->tick);
+    } else {
+        printf(" at level %d camera (%d,%d)\n", w->level, w->cameraX, w->cameraY);
+    }
+}
+
+static void stress_merge(stress_result_t* total, const stress_result_t* r) {
+    total->ticks += r->ticks;
+    total->tickNs += r->tickNs;
+    total->frames += r->frames;
+    total->frameNs += r->frameNs;
+    if (r->tick.ns > total->tick.ns) total->tick = r->tick;
+    if (r->frame.ns > total->frame.ns) total->frame = r->frame;
+    if (stress_draws(&r->drawsFrame.draws) > stress_draws(&total->drawsFrame.draws)) {
+        total->drawsFrame = r->drawsFrame;
+    }
+    if (r->solidBytes > total->solidBytes) total->solidBytes = r->solidBytes;
+}
+
+int main(int argc, char** argv) {
+    stress_options_t opt = { 0, 12, 3000, 1, 5, "stress", NULL };
+    if (!parse_args(argc, argv, &opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+    const bool generated = opt.data_root == NULL;
+    if (generated) {
+        if (!stress_write_levels(opt.generate, opt.seed)) return 1;
+        printf("generated %d levels %dx%d in %s/levels\n", STRESS_NUM_PROFILES, MAX_LEVEL_WIDTH,
+               MAX_LEVEL_HEIGHT, opt.generate);
+    }
+    host_set_data_root(generated ? opt.generate : opt.data_root);
+    level_load_tileset();
+
+    SimSnapshot* snap = (SimSnapshot*)malloc(sizeof(SimSnapshot));
+    if (!snap) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    stress_result_t total;
+    memset(&total, 0, sizeof(total));
+    int levels = 0;
+    int last = generated ? STRESS_NUM_PROFILES : MAX_LEVEL;
+    for (int level = opt.level ? opt.level : 1; level <= (opt.level ? opt.level : last); level++) {
+        if (!game_start_level(&g_sim, level, GAME_START_FRESH)) continue;
+        levels++;
+        printf("level %d%s%s: %dx%d, %d moving, %d mutable tiles\n", level,
+               generated && level <= STRESS_NUM_PROFILES ? " " : "",
+               generated && level <= STRESS_NUM_PROFILES ? s_profiles[level - 1].name : "",
+               g_sim.level.width, g_sim.level.height, g_sim.level.numMovingObjects,
+               g_sim.level.numMutableTiles);
+
+        stress_result_t res;
+        memset(&res, 0, sizeof(res));
+        for (int i = 0; i < opt.runs; i++) {
+            stress_run(&opt, snap, level, opt.seed + (uint32_t)i, &res);
+        }
+        stress_sweep(&opt, level, &res);
+
+        printf("  %llu ticks, mean %.1f us; %llu frames, mean %.1f us\n", (unsigned long long)res.ticks,
+               res.ticks ? (double)res.tickNs / (double)res.ticks / 1e3 : 0.0, (unsigned long long)res.frames,
+               res.frames ? (double)res.frameNs / (double)res.frames / 1e3 : 0.0);
+        printf("  solid bitmap: up to %zu of %zu KB built\n", res.solidBytes / 1024,
+               solid_bitmap_words(g_sim.level.width, g_sim.level.height) * sizeof(uint32_t) / 1024);
+        print_worst("tick", &res.tick, STRESS_TICK_BUDGET_NS);
+        print_worst("frame", &res.frame, STRESS_FRAME_BUDGET_NS);
+        printf("  most draws: %llu rects + %llu sprites, %llu mode switches\n",
+               (unsigned long long)res.drawsFrame.draws.rects, (unsigned long long)res.drawsFrame.draws.sprites,
+               (unsigned long long)res.drawsFrame.draws.modeSwitches);
+        fflush(stdout);
+        stress_merge(&total, &res);
+    }
+    free(snap);
+    level_render_cleanup();
+    if (levels == 0) {
+        fprintf(stderr, "failed to load levels\n");
+        return 1;
+    }
+
+    printf("all %d levels (host time, not PSP):\n", levels);
+    print_worst("tick", &total.tick, STRESS_TICK_BUDGET_NS);
+    print_worst("frame", &total.frame, STRESS_FRAME_BUDGET_NS);
+    printf("  most draws: %llu rects + %llu sprites per frame\n",
+           (unsigned long long)total.drawsFrame.draws.rects, (unsigned long long)total.drawsFrame.draws.sprites);
+    return total.tick.ns > STRESS_TICK_BUDGET_NS || total.frame.ns > STRESS_FRAME_BUDGET_NS ? 1 : 0;
+}
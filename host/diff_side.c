@@ -0,0 +1,99 @@
+// diff_side.c - Драйвер одной стороны bounce_diff поверх публичного API ядра
+// Пара к ref/diff_side.c: оба драйвера отдают одно и то же состояние через
+// публичные функции своей версии ядра (см. DIFF_SIM_FIELDS).
+#include "diff_side.h"
+#include "platform_host.h"
+#include "game.h"
+#include "level.h"
+#include "replay.h"
+#include <stdlib.h>
+
+struct diff_side_s {
+    SimContext sim;
+    bool ticked;        // После старта был тик: камера уже рассчитана
+};
+
+_Static_assert(MAX_MOVING_OBJECTS <= DIFF_MAX_MOVING, "DiffState::moving is too small");
+
+bool diff_side_init(const char* dataRoot) {
+    host_set_data_root(dataRoot);
+    // Первая загрузка заполняет общий кэш файлов уровней; дальше он только читается
+    DiffSide* side = diff_side_new();
+    if (!side) return false;
+    bool loaded = game_start_level(&side->sim, 1, GAME_START_FRESH);
+    diff_side_free(side);
+    return loaded;
+}
+
+DiffSide* diff_side_new(void) {
+    return (DiffSide*)calloc(1, sizeof(DiffSide));
+}
+
+void diff_side_free(DiffSide* side) {
+    if (side) level_free(&side->sim.level);
+    free(side);
+}
+
+bool diff_side_start(DiffSide* side, int level, int mode, int score, int numLives) {
+    // Как replay_start()
+    bool loaded = game_start_level(&side->sim, level, (game_start_mode_t)mode);
+    side->ticked = false;
+    if (score >= 0) {
+        side->sim.score = score;
+        side->sim.numLives = numLives;
+    }
+    return loaded;
+}
+
+void diff_side_tick(DiffSide* side, uint8_t input) {
+    // Как replay_step()
+    side->sim.invincible = (input & REPLAY_FLAG_INVINCIBLE) != 0;
+    game_tick(&side->sim, (MoveMask)(input & (MOVE_LEFT | MOVE_RIGHT | MOVE_UP)));
+    side->ticked = true;
+}
+
+void diff_side_state(DiffSide* side, DiffState* out) {
+    SimContext* sim = &side->sim;
+    const Player* p = &sim->player;
+    const Level* level = &sim->level;
+#define DIFF_STORE_PLAYER(name) out->fields[DIFF_FIELD_##name] = (int32_t)p->name;
+    DIFF_PLAYER_FIELDS(DIFF_STORE_PLAYER)
+#undef DIFF_STORE_PLAYER
+
+    // Повторный расчет после тика ничего не сдвигает: мяч уже в мертвой зоне
+    int cameraX = 0, cameraY = 0;
+    if (side->ticked) game_calculate_camera(sim, &cameraX, &cameraY);
+    out->fields[DIFF_FIELD_numRings] = sim->numRings;
+    out->fields[DIFF_FIELD_score] = sim->score;
+    out->fields[DIFF_FIELD_numLives] = sim->numLives;
+    out->fields[DIFF_FIELD_invincible] = sim->invincible;
+    out->fields[DIFF_FIELD_state] = sim->state;
+    out->fields[DIFF_FIELD_respawnX] = sim->respawnX;
+    out->fields[DIFF_FIELD_respawnY] = sim->respawnY;
+    out->fields[DIFF_FIELD_cameraY] = cameraY;
+    out->fields[DIFF_FIELD_exitOpen] = game_exit_is_open(sim);
+    out->fields[DIFF_FIELD_exitOffset] = game_exit_anim_offset(sim);
+
+    out->width = level->width;
+    out->height = level->height;
+    out->numMovingObjects = level->numMovingObjects;
+    for (int i = 0; i < level->numMovingObjects; i++) {
+        const MovingObject* obj = &level->movingObjects[i];
+        out->moving[i][0] = (int16_t)obj->offset[0];
+        out->moving[i][1] = (int16_t)obj->offset[1];
+        out->moving[i][2] = (int16_t)obj->direction[0];
+        out->moving[i][3] = (int16_t)obj->direction[1];
+    }
+}
+
+int diff_side_tiles(const DiffSide* side, uint8_t* out, int capacity) {
+    const Level* level = &side->sim.level;
+    int count = level->width * level->height;
+    if (count > capacity) return -1;
+    for (int y = 0; y < level->height; y++) {
+        for (int x = 0; x < level->width; x++) {
+            *out++ = (uint8_t)level_get_tile_at(level, x, y);
+        }
+    }
+    return count;
+}
@@ -0,0 +1,64 @@
+// diff_side.h - Одна сторона сравнения bounce_diff (эталон или проверяемое ядро)
+// Драйверов два: diff_side.c над текущим ядром (функции diff_side_*) и
+// ref/diff_side.c над замороженным эталоном в host/ref (те же функции с префиксом
+// ref_ после objcopy --redefine-syms, см. host/Makefile). Поэтому здесь нет типов
+// ядра: состояние передается плоскими полями, одинаковыми для обеих версий.
+#ifndef DIFF_SIDE_H
+#define DIFF_SIDE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Поля Player в порядке сравнения
+#define DIFF_PLAYER_FIELDS(X) \
+    X(xPos) X(yPos) X(globalBallX) X(globalBallY) X(xSpeed) X(ySpeed) X(direction) \
+    X(ballSize) X(mHalfBallSize) X(jumpOffset) X(ballState) X(sizeState) \
+    X(mGroundedFlag) X(mCDRubberFlag) X(speedBonusCntr) X(gravBonusCntr) \
+    X(jumpBonusCntr) X(popCntr) X(slideCntr) X(isInWater) X(mCDRampFlag)
+
+// Остальное состояние в том виде, в каком его отдает публичный API обеих версий:
+// камера - результат game_calculate_camera() после тика (до первого тика 0),
+// дверь - game_exit_is_open() и game_exit_anim_offset()
+#define DIFF_SIM_FIELDS(X) \
+    X(numRings) X(score) X(numLives) X(invincible) X(state) \
+    X(respawnX) X(respawnY) X(cameraY) X(exitOpen) X(exitOffset)
+
+// Индексы DiffState::fields: DIFF_FIELD_xPos, ..., DIFF_FIELD_exitOffset
+#define DIFF_FIELD_INDEX(name) DIFF_FIELD_##name,
+enum {
+    DIFF_PLAYER_FIELDS(DIFF_FIELD_INDEX)
+    DIFF_SIM_FIELDS(DIFF_FIELD_INDEX)
+    DIFF_NUM_FIELDS,
+    DIFF_NUM_PLAYER_FIELDS = DIFF_FIELD_numRings
+};
+#undef DIFF_FIELD_INDEX
+
+#define DIFF_MAX_MOVING 16      // Не меньше MAX_MOVING_OBJECTS обеих версий
+
+typedef struct {
+    int32_t fields[DIFF_NUM_FIELDS];    // DIFF_PLAYER_FIELDS, затем DIFF_SIM_FIELDS
+    int width, height;
+    int numMovingObjects;
+    int16_t moving[DIFF_MAX_MOVING][4]; // offset[0..1], direction[0..1]
+} DiffState;
+
+typedef struct diff_side_s DiffSide;
+
+// diff_side_init() - один раз до запуска потоков: корень данных и кэш уровней.
+// diff_side_start() - как replay_start(); score < 0 оставляет счёт и жизни старта.
+// diff_side_tick() принимает байт тика реплея (MoveMask | REPLAY_FLAG_INVINCIBLE).
+// diff_side_tiles() пишет тайлы карты (с флагами) построчно, возвращает их число.
+// diff_side_state() досчитывает камеру тем же вызовом, что и тик, поэтому не const.
+#define DIFF_SIDE_API(prefix) \
+    bool prefix##diff_side_init(const char* dataRoot); \
+    DiffSide* prefix##diff_side_new(void); \
+    void prefix##diff_side_free(DiffSide* side); \
+    bool prefix##diff_side_start(DiffSide* side, int level, int mode, int score, int numLives); \
+    void prefix##diff_side_tick(DiffSide* side, uint8_t input); \
+    void prefix##diff_side_state(DiffSide* side, DiffState* out); \
+    int prefix##diff_side_tiles(const DiffSide* side, uint8_t* out, int capacity);
+
+DIFF_SIDE_API()
+DIFF_SIDE_API(ref_)
+
+#endif // DIFF_SIDE_H
@@ -0,0 +1,90 @@
+// gen_collision_lut.c - Генератор и проверка таблицы коллизий g_collision_lut
+//   gen_collision_lut [-o file]  напечатать src/collision_lut.c по эталонным циклам
+//   gen_collision_lut -v         сверить скомпилированную таблицу с эталоном
+#include "collision_lut.h"
+#include <stdio.h>
+#include <string.h>
+
+// Насколько далеко за окном проверять, что эталон не даёт коллизий
+#define VERIFY_MARGIN 8
+
+static const int s_ball_sizes[2] = { NORMAL_SIZE, ENLARGED_SIZE };
+
+static uint32_t reference_row(int ballSize, collision_shape_t shape, int dy) {
+    uint32_t row = 0;
+    for (int dx = COLLISION_LUT_MIN; dx <= COLLISION_LUT_MAX; dx++) {
+        if (collision_reference(ballSize, shape, dx, dy)) {
+            row |= 1u << (dx - COLLISION_LUT_MIN);
+        }
+    }
+    return row;
+}
+
+static int generate(FILE* out) {
+    fprintf(out,
+            "// collision_lut.c - Таблица коллизий мяча с тайлом\n"
+            "// Сгенерировано host/gen_collision_lut из collision_ref.c, не редактировать вручную.\n"
+            "#include \"collision_lut.h\"\n"
+            "\n"
+            "const uint32_t g_collision_lut[2][COLLIDE_SHAPE_COUNT][COLLISION_LUT_SPAN] = {\n");
+    for (int size = 0; size < 2; size++) {
+        fprintf(out, "    {   // Мяч %dx%d\n", s_ball_sizes[size], s_ball_sizes[size]);
+        for (int shape = 0; shape < COLLIDE_SHAPE_COUNT; shape++) {
+            fprintf(out, "        [%s] = {", collision_shape_name((collision_shape_t)shape));
+            for (int i = 0; i < COLLISION_LUT_SPAN; i++) {
+                uint32_t row = reference_row(s_ball_sizes[size], (collision_shape_t)shape, COLLISION_LUT_MIN + i);
+                fprintf(out, "%s0x%08X,", (i % 6 == 0) ? "\n            " : " ", (unsigned)row);
+            }
+            fprintf(out, "\n        },\n");
+        }
+        fprintf(out, "    },\n");
+    }
+    fprintf(out, "};\n");
+    return ferror(out) ? 1 : 0;
+}
+
+static int verify(void) {
+    long checked = 0, mismatches = 0;
+    for (int size = 0; size < 2; size++) {
+        int ballSize = s_ball_sizes[size];
+        for (int shape = 0; shape < COLLIDE_SHAPE_COUNT; shape++) {
+            for (int dy = COLLISION_LUT_MIN - VERIFY_MARGIN; dy <= COLLISION_LUT_MAX + VERIFY_MARGIN; dy++) {
+                for (int dx = COLLISION_LUT_MIN - VERIFY_MARGIN; dx <= COLLISION_LUT_MAX + VERIFY_MARGIN; dx++) {
+                    bool expected = collision_reference(ballSize, (collision_shape_t)shape, dx, dy);
+                    bool actual = collision_lut_test(ballSize, (collision_shape_t)shape, dx, dy);
+                    checked++;
+                    if (expected != actual) {
+                        if (mismatches < 16) {
+                            fprintf(stderr, "mismatch: ball %d %s dx=%d dy=%d: table %d, reference %d\n",
+                                    ballSize, collision_shape_name((collision_shape_t)shape), dx, dy, actual, expected);
+                        }
+                        mismatches++;
+                    }
+                }
+            }
+        }
+    }
+    printf("collision lut: %ld entries checked, %ld mismatches\n", checked, mismatches);
+    return mismatches ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2 && strcmp(argv[1], "-v") == 0) {
+        return verify();
+    }
+    if (argc == 3 && strcmp(argv[1], "-o") == 0) {
+        FILE* out = fopen(argv[2], "w");
+        if (!out) {
+            perror(argv[2]);
+            return 1;
+        }
+        int rc = generate(out);
+        if (fclose(out) != 0) rc = 1;
+        return rc;
+    }
+    if (argc == 1) {
+        return generate(stdout);
+    }
+    fprintf(stderr, "usage: %s [-o file | -v]\n", argv[0]);
+    return 2;
+}
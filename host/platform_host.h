@@ -0,0 +1,13 @@
+// platform_host.h - Платформенная прослойка ядра для нативной (host) сборки
+#ifndef PLATFORM_HOST_H
+#define PLATFORM_HOST_H
+
+#include <stdint.h>
+
+// Каталог с ресурсами игры (levels/ и т.д.); по умолчанию текущий каталог.
+void host_set_data_root(const char* path);
+
+// Монотонное время в наносекундах для замеров производительности
+uint64_t host_time_ns(void);
+
+#endif // PLATFORM_HOST_H
@@ -0,0 +1,103 @@
+// diff_side.c - Драйвер эталонной стороны bounce_diff над замороженным ядром
+// host/ref - ядро до оптимизаций (physics.c, level.c, game_logic.c, tile_table.c,
+// replay.c и хостовые заглушки в том виде, в каком они были сразу после записи
+// реплеев). Файлы не правятся, кроме одного: состояние ядра (g_game, g_level,
+// респаун, дверь, камера) помечено REF_THREAD_LOCAL, так что у каждого потока
+// сверки своя копия однопоточного ядра. Отсюда ограничение: одна сторона на поток.
+// Состояние собирается теми же полями, что и в host/diff_side.c.
+#include "diff_side.h"
+#include "platform_host.h"
+#include "game.h"
+#include "level.h"
+#include "replay.h"
+#include <stdlib.h>
+
+struct diff_side_s {
+    bool ticked;        // После старта был тик: камера уже рассчитана
+};
+
+static REF_THREAD_LOCAL DiffSide* s_side = NULL;
+
+_Static_assert(MAX_MOVING_OBJECTS <= DIFF_MAX_MOVING, "DiffState::moving is too small");
+
+bool diff_side_init(const char* dataRoot) {
+    host_set_data_root(dataRoot);
+    // Первая загрузка заполняет общий кэш файлов уровней; дальше он только читается
+    return level_load_by_number(1) != 0;
+}
+
+DiffSide* diff_side_new(void) {
+    if (s_side) return NULL;
+    s_side = (DiffSide*)calloc(1, sizeof(DiffSide));
+    return s_side;
+}
+
+void diff_side_free(DiffSide* side) {
+    if (side && side == s_side) s_side = NULL;
+    free(side);
+}
+
+bool diff_side_start(DiffSide* side, int level, int mode, int score, int numLives) {
+    // game_start_level() эталона не сообщает об ошибке загрузки
+    bool loaded = level_load_by_number(level) != 0;
+    // Как replay_start()
+    game_start_level(level, (game_start_mode_t)mode);
+    if (score >= 0) {
+        g_game.score = score;
+        g_game.numLives = numLives;
+    }
+    side->ticked = false;
+    return loaded;
+}
+
+void diff_side_tick(DiffSide* side, uint8_t input) {
+    // Как replay_step()
+    g_game.invincible_cheat = (input & REPLAY_FLAG_INVINCIBLE) != 0;
+    game_tick((MoveMask)(input & (MOVE_LEFT | MOVE_RIGHT | MOVE_UP)));
+    side->ticked = true;
+}
+
+void diff_side_state(DiffSide* side, DiffState* out) {
+    const Player* p = &g_game.player;
+#define DIFF_STORE_PLAYER(name) out->fields[DIFF_FIELD_##name] = (int32_t)p->name;
+    DIFF_PLAYER_FIELDS(DIFF_STORE_PLAYER)
+#undef DIFF_STORE_PLAYER
+
+    int cameraX = 0, cameraY = 0;
+    if (side->ticked) game_calculate_camera(&cameraX, &cameraY);
+    int respawnX, respawnY;
+    level_get_respawn(&respawnX, &respawnY);
+    out->fields[DIFF_FIELD_numRings] = g_game.numRings;
+    out->fields[DIFF_FIELD_score] = g_game.score;
+    out->fields[DIFF_FIELD_numLives] = g_game.numLives;
+    out->fields[DIFF_FIELD_invincible] = g_game.invincible_cheat;
+    out->fields[DIFF_FIELD_state] = g_game.state;
+    out->fields[DIFF_FIELD_respawnX] = respawnX;
+    out->fields[DIFF_FIELD_respawnY] = respawnY;
+    out->fields[DIFF_FIELD_cameraY] = cameraY;
+    out->fields[DIFF_FIELD_exitOpen] = game_exit_is_open();
+    out->fields[DIFF_FIELD_exitOffset] = game_exit_anim_offset();
+
+    out->width = g_level.width;
+    out->height = g_level.height;
+    out->numMovingObjects = g_level.numMovingObjects;
+    for (int i = 0; i < g_level.numMovingObjects; i++) {
+        const MovingObject* obj = &g_level.movingObjects[i];
+        out->moving[i][0] = obj->offset[0];
+        out->moving[i][1] = obj->offset[1];
+        out->moving[i][2] = obj->direction[0];
+        out->moving[i][3] = obj->direction[1];
+    }
+}
+
+int diff_side_tiles(const DiffSide* side, uint8_t* out, int capacity) {
+    (void)side;
+    int count = g_level.width * g_level.height;
+    if (count > capacity) return -1;
+    for (int y = 0; y < g_level.height; y++) {
+        for (int x = 0; x < g_level.width; x++) {
+            *out++ = (uint8_t)level_get_tile_at(x, y);
+        }
+    }
+    return count;
+}
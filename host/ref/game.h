@@ -0,0 +1,58 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include "types.h"
+
+// HUD размеры
+#define HUD_HEIGHT 17               // Высота HUD: 2+12+2px синяя полоса + 1px разделитель
+
+void game_init(void);
+void game_shutdown(void);
+void game_reset_camera(void);
+void game_calculate_camera(int* outCameraX, int* outCameraY);
+
+typedef enum {
+    GAME_START_FRESH = 0,
+    GAME_START_SELECTED = 1,
+    GAME_START_NEXT = 2
+} game_start_mode_t;
+
+void game_start_level(int level_number, game_start_mode_t mode);
+
+// Один фиксированный тик игрового процесса (30 мс): применяет маску направлений,
+// обновляет физику, обрабатывает смерть/респаун, движущиеся объекты и дверь.
+// Не читает ввод и не рисует, поэтому доступен и в хостовой сборке ядра.
+// Возвращает true, если на этом тике мяч был респавнен.
+bool game_tick(MoveMask input);
+
+// Записывать ввод каждого тика в recorder (NULL - отключить).
+// game_start_level() начинает в нём новую запись (см. replay.h).
+struct replay_s;
+void game_attach_recorder(struct replay_s* recorder);
+
+typedef enum {
+    GAME_TICK_VARIABLE = 0,
+    GAME_TICK_FIXED = 1
+} game_tick_mode_t;
+
+typedef struct {
+    void (*update)(void);
+    void (*render)(void);
+    game_tick_mode_t tick_mode;
+} game_state_handler_t;
+
+const game_state_handler_t* game_get_state_handler(GameState state);
+void game_state_update(void);
+void game_state_render(void);
+
+// Анимация двери
+void game_exit_reset(void);
+int game_exit_anim_offset(void);
+bool game_exit_is_open(void);
+
+// Проверка состояния сохраненной игры
+bool game_can_continue(void);
+
+extern REF_THREAD_LOCAL Game g_game;
+
+#endif
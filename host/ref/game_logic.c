@@ -0,0 +1,376 @@
+// game_logic.c - Игровые правила и фиксированный тик симуляции (без рендера и ввода)
+// Модуль входит в ядро симуляции вместе с physics.c и level.c и собирается без PSPSDK.
+#include "game.h"
+#include "types.h"
+#include "level.h"
+#include "tile_table.h"
+#include "sound.h"
+#include "replay.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+REF_THREAD_LOCAL Game g_game;
+
+typedef enum {
+    EXIT_CLOSED = 0,
+    EXIT_WAITING_VISIBLE,
+    EXIT_OPENING,
+    EXIT_OPEN
+} ExitState;
+
+typedef struct {
+    ExitState state;
+    int animation_offset;
+} ExitController;
+
+static REF_THREAD_LOCAL ExitController s_exit = { EXIT_CLOSED, 0 };
+
+// Необязательная запись ввода (см. game_attach_recorder)
+static REF_THREAD_LOCAL replay_t* s_recorder = NULL;
+
+// Camera - система отслеживания игрока с мертвой зоной
+#define CAMERA_UNINITIALIZED -999
+#define CAMERA_DEADZONE_PERCENT 30   // 30% от игровой области - зона без движения камеры
+// Статическая переменная для вертикальной камеры с мертвой зоной
+static REF_THREAD_LOCAL int s_currentCameraY = CAMERA_UNINITIALIZED;
+
+// Проверка является ли уровень маленьким (ниже игровой области по высоте)
+// Такие уровни центрируются по вертикали без мертвой зоны камеры
+static inline bool is_level_small(void) {
+    int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
+    return (g_level.height * TILE_SIZE) < gameAreaHeight;
+}
+
+// Получить смещение камеры для вертикального центрирования маленького уровня
+// Возвращает отрицательное значение для центрирования уровня в игровой области
+static inline int get_center_offset(void) {
+    int levelPixelHeight = g_level.height * TILE_SIZE;
+    int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
+    return -(gameAreaHeight - levelPixelHeight) / 2;
+}
+
+// Единственный расчет камеры для игровой логики и рендера.
+void game_calculate_camera(int* outCameraX, int* outCameraY) {
+    Player* player = &g_game.player;
+    int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
+    int cameraX = player->xPos - SCREEN_WIDTH / 2;
+
+    if (s_currentCameraY == CAMERA_UNINITIALIZED) {
+        s_currentCameraY = player->yPos - gameAreaHeight / 2;
+    }
+
+    int deadZoneTop = (gameAreaHeight * CAMERA_DEADZONE_PERCENT) / 100;
+    int deadZoneBottom = gameAreaHeight - deadZoneTop;
+
+    if (!is_level_small()) {
+        int playerScreenY = player->yPos - s_currentCameraY;
+        if (playerScreenY < deadZoneTop) {
+            s_currentCameraY = player->yPos - deadZoneTop;
+        } else if (playerScreenY > deadZoneBottom) {
+            s_currentCameraY = player->yPos - deadZoneBottom;
+        }
+    }
+
+    int cameraY = s_currentCameraY;
+    int maxCameraX = g_level.width * TILE_SIZE - SCREEN_WIDTH;
+    int maxCameraY = g_level.height * TILE_SIZE - gameAreaHeight;
+
+    if (cameraX < 0) cameraX = 0;
+    if (cameraX > maxCameraX && maxCameraX > 0) cameraX = maxCameraX;
+
+    if (is_level_small()) {
+        cameraY = get_center_offset();
+    } else {
+        if (cameraY < 0) cameraY = 0;
+        if (cameraY > maxCameraY && maxCameraY > 0) cameraY = maxCameraY;
+    }
+
+    *outCameraX = cameraX;
+    *outCameraY = cameraY;
+}
+
+static bool game_exit_is_visible(int cameraX, int cameraY) {
+    const int exitX = g_level.exitPosX * TILE_SIZE;
+    const int exitY = g_level.exitPosY * TILE_SIZE;
+    const int exitSize = 2 * TILE_SIZE;
+    const int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
+
+    return exitX < cameraX + SCREEN_WIDTH &&
+           exitX + exitSize > cameraX &&
+           exitY < cameraY + gameAreaHeight &&
+           exitY + exitSize > cameraY;
+}
+
+static void game_exit_arm(void) {
+    if (s_exit.state == EXIT_CLOSED) {
+        s_exit.state = EXIT_WAITING_VISIBLE;
+    }
+}
+
+static void game_exit_update(int cameraX, int cameraY) {
+    const bool isVisible = game_exit_is_visible(cameraX, cameraY);
+
+    if (s_exit.state == EXIT_WAITING_VISIBLE && isVisible) {
+        s_exit.state = EXIT_OPENING;
+    }
+
+    // Оригинал делает первый шаг openExit() в тот же тик,
+    // в котором дверь стала видима, и приостанавливает анимацию
+    // если дверь снова ушла за границы видимой области.
+    if (s_exit.state == EXIT_OPENING && isVisible) {
+        s_exit.animation_offset += 4;
+        if (s_exit.animation_offset >= 24) {
+            s_exit.animation_offset = 24;
+            s_exit.state = EXIT_OPEN;
+        }
+    }
+}
+
+void game_reset_camera(void) {
+    if (is_level_small()) {
+        s_currentCameraY = get_center_offset();
+    } else {
+        s_currentCameraY = CAMERA_UNINITIALIZED; // Будет инициализирована позицией игрока
+    }
+}
+
+void game_start_level(int level_number, game_start_mode_t mode) {
+    g_game.state = STATE_GAME;
+    g_game.selected_level = level_number;
+
+    if (level_load_by_number(level_number)) {
+        game_reset_camera();
+    }
+
+    // Устанавливаем респавн в стартовую позицию (как в game_init)
+    level_set_respawn(g_level.startTileX, g_level.startTileY);
+
+    if (mode == GAME_START_FRESH || mode == GAME_START_SELECTED) {
+        // Сброс счётчиков при старте уровня (как в Java BounceCanvas.startLevel)
+        g_game.numRings = 0;
+        g_game.score = 0;
+        g_game.numLives = 3;
+    } else if (mode == GAME_START_NEXT) {
+        // При переходе на следующий уровень сохраняем счет/жизни
+        g_game.numRings = 0;
+    }
+
+    // Дверь всегда должна начинать уровень закрытой
+    game_exit_reset();
+
+    if (mode == GAME_START_FRESH) {
+        g_game.saved_game_state = SAVED_GAME_IN_PROGRESS;
+        g_game.new_best_score = false;
+    }
+
+    player_init(&g_game.player, g_level.startPosX, g_level.startPosY,
+                g_level.ballSize == BALL_SIZE_SMALL ? SMALL_SIZE_STATE : LARGE_SIZE_STATE);
+
+    if (s_recorder) {
+        replay_begin(s_recorder, level_number, mode, g_game.score, g_game.numLives);
+    }
+}
+
+void game_attach_recorder(replay_t* recorder) {
+    s_recorder = recorder;
+}
+
+// Применить маску направлений тика к игроку (те же set/release, что и при вводе)
+static void game_apply_input(Player* player, MoveMask input) {
+    static const MoveDirection dirs[] = { MOVE_LEFT, MOVE_RIGHT, MOVE_UP };
+    for (size_t i = 0; i < sizeof(dirs) / sizeof(dirs[0]); i++) {
+        if (input & dirs[i]) {
+            set_direction(player, dirs[i]);
+        } else {
+            release_direction(player, dirs[i]);
+        }
+    }
+}
+
+// Фиксированный тик игрового процесса (бывшая физическая часть update_game)
+bool game_tick(MoveMask input) {
+    Player* player = &g_game.player;
+    bool respawned = false;
+
+    if (s_recorder) {
+        replay_record_tick(s_recorder, (uint8_t)(input | (g_game.invincible_cheat ? REPLAY_FLAG_INVINCIBLE : 0)));
+    }
+
+    game_apply_input(player, input);
+
+    // Обновление физики игрока; тик 30 мс задается вызывающим кодом.
+    player_update(player);
+
+    // Обработка смерти игрока (как в Java BounceCanvas.java:569-580)
+    if (player->ballState == BALL_STATE_DEAD) {
+        // ВАЖНО: нестандартная логика жизней (как в оригинале Java Bounce):
+        // numLives: 3→2→1→0→(-1). Game Over при < 0, т.к. при 0 еще остается последняя попытка
+        // Это означает: 3 жизни = 4 попытки игры (3 обычные + 1 последняя при numLives=0)
+        if (g_game.numLives < 0) {
+            // Game Over - обновить рекорды и показать Game Over экран (как в оригинале BounceCanvas:440)
+            save_update_records(g_game.selected_level, g_game.score);
+            g_game.saved_game_state = SAVED_GAME_NONE;
+            g_game.state = STATE_GAME_OVER;
+        } else {
+            // Респаун - сохраняем ТЕКУЩИЙ размер мяча (основная цель этой задачи!)
+            BallSizeState currentSize = player->sizeState;  // СОХРАНЯЕМ размер
+
+            // Получаем координаты респауна (чекпоинта)
+            int respawnX, respawnY;
+            level_get_respawn(&respawnX, &respawnY);
+
+            // Респаун в точке чекпоинта с сохранённым размером (как в оригинале)
+            int respawnHalf = (currentSize == SMALL_SIZE_STATE) ? HALF_NORMAL_SIZE : HALF_ENLARGED_SIZE;
+            player_init(player, respawnX * TILE_SIZE + respawnHalf, respawnY * TILE_SIZE + respawnHalf, currentSize);
+
+            // Сброс камеры к игроку
+            game_reset_camera();
+
+            respawned = true;
+        }
+    }
+
+    // Обновление движущихся объектов
+    level_update_moving_objects();
+
+    // Как в оригинале: после сбора всех колец дверь ждет,
+    // пока не попадет в видимую область, и только затем открывается.
+    if (g_game.numRings == g_level.totalRings) {
+        game_exit_arm();
+    }
+
+    int cameraX, cameraY;
+    game_calculate_camera(&cameraX, &cameraY);
+    game_exit_update(cameraX, cameraY);
+
+    return respawned;
+}
+
+void game_add_score(int points) {
+    g_game.score += points;
+}
+
+void game_add_ring(void) {
+    game_add_score(RING_POINTS);    // 1. Добавить очки за кольцо
+    g_game.numRings++;      // 2. Увеличить счетчик колец
+    
+    // 3. Анимация двери запускается из game_ring_collected()
+}
+
+void game_set_respawn(int x, int y) {
+    level_deactivate_old_checkpoint();        // Деактивируем старый чекпоинт (7->8)
+    level_set_respawn(x, y);                  // Устанавливаем новые координаты
+    level_mark_checkpoint_active(x, y);       // Активируем новый чекпоинт
+    sound_play_pickup();                      // Звук активации чекпоинта
+}
+
+void game_add_extra_life(void) {
+    // Как в оригинале Ball.java:800-810
+    game_add_score(LIFE_POINTS);           // +очки за дополнительную жизнь
+    
+    if (g_game.numLives < 5) {      // максимум 5 жизней
+        g_game.numLives++;
+    }
+    sound_play_pickup();            // Звук получения дополнительной жизни
+}
+
+void game_complete_level(void) {
+    // Добавляем бонус за завершение уровня (как в BounceConst.java)
+    game_add_score(EXIT_POINTS);
+
+    // Обновить рекорды если нужно (как в оригинале BounceCanvas:179-185)
+    save_update_records(g_game.selected_level, g_game.score);
+
+    // Переход в экран завершения уровня (как в Java displayLevelComplete)
+    g_game.state = STATE_LEVEL_COMPLETE;
+}
+
+// Универсальная функция деактивации кольца (перенесена из physics.c)
+// Вспомогательная функция для сохранения флагов при установке нового ID
+static void set_id_preserving_flags(int tx, int ty, uint8_t newID) {
+    int currentTile = level_get_tile_at(tx, ty);
+    // Извлекаем флаги (биты 6-7) из текущего тайла, сбрасывая ID (биты 0-5)
+    // ~TILE_ID_MASK = ~0x3F = 0xC0 (биты 6-7)
+    uint8_t flags = currentTile & ~TILE_ID_MASK; // Сохраняем все флаги кроме ID
+    // Устанавливаем новый ID с сохранением старых флагов
+    level_set_id(tx, ty, newID | flags);
+}
+
+static void deactivate_ring_pair(int x, int y, uint8_t tileID) {
+    if (tileID >= tile_meta_count()) return;
+    const TileMeta* meta = &tile_meta_db()[tileID];
+    
+    if (tileID >= 13 && tileID <= 14) {
+        // Маленькие вертикальные кольца (ID=13-14)
+        if (meta->orientation == ORIENT_VERT_TOP) {
+            // Верхняя часть вертикального кольца (ID=13)
+            set_id_preserving_flags(x, y, tileID + 4);     // верх → неактивный (13→17)
+            set_id_preserving_flags(x, y + 1, tileID + 5); // низ → неактивный (13→18)
+        } else if (meta->orientation == ORIENT_VERT_BOTTOM) {
+            // Нижняя часть вертикального кольца (ID=14)
+            set_id_preserving_flags(x, y, tileID + 4);     // низ → неактивный (14→18)
+            set_id_preserving_flags(x, y - 1, tileID + 3); // верх → неактивный (14→17)
+        }
+    } else if (tileID >= 21 && tileID <= 22) {
+        // Большие вертикальные кольца (ID=21-22) - логика как для 13-14
+        if (tileID == 21) {
+            // Верхняя часть большого вертикального кольца (ID=21)
+            set_id_preserving_flags(x, y, 25);     // верх → неактивный (21→25)
+            set_id_preserving_flags(x, y + 1, 26); // низ → неактивный (21→26)
+        } else if (tileID == 22) {
+            // Нижняя часть большого вертикального кольца (ID=22)
+            set_id_preserving_flags(x, y, 26);     // низ → неактивный (22→26)
+            set_id_preserving_flags(x, y - 1, 25); // верх → неактивный (22→25)
+        }
+    } else if (tileID >= 23 && tileID <= 24) {
+        // Большие горизонтальные кольца (ID=23-24) - логика как для 15-16
+        if (tileID == 23) {
+            // Левая часть большого горизонтального кольца (ID=23)
+            set_id_preserving_flags(x, y, 27);     // левая часть → неактивная левая (23→27)
+            set_id_preserving_flags(x + 1, y, 28); // правая часть → неактивная правая (23→28)
+        } else if (tileID == 24) {
+            // Правая часть большого горизонтального кольца (ID=24)
+            set_id_preserving_flags(x, y, 28);     // правая часть → неактивная правая (24→28)
+            set_id_preserving_flags(x - 1, y, 27); // левая часть → неактивная левая (24→27)
+        }
+    } else if (meta->orientation == ORIENT_HORIZ_LEFT) {
+        // Маленькие горизонтальные кольца - левая часть (ID=15)
+        set_id_preserving_flags(x, y, 19);     // левая часть → неактивная левая (19)
+        set_id_preserving_flags(x + 1, y, 20); // правая часть → неактивная правая (20)
+    } else if (meta->orientation == ORIENT_HORIZ_RIGHT) {
+        // Маленькие горизонтальные кольца - правая часть (ID=16)  
+        set_id_preserving_flags(x, y, 20);     // правая часть → неактивная правая (20)
+        set_id_preserving_flags(x - 1, y, 19); // левая часть → неактивная левая (19)
+    }
+}
+
+// Новая функция для обработки события сбора кольца
+void game_ring_collected(int tileX, int tileY, uint8_t tileID) {
+    // 1. Деактивируем кольцо на карте
+    deactivate_ring_pair(tileX, tileY, tileID);
+    
+    // 2. Добавляем очки и обновляем счетчик
+    game_add_ring();
+    
+    // 3. Воспроизводим звук кольца (up.ott)
+    sound_play_hoop();
+    
+}
+
+// === АНИМАЦИЯ ДВЕРИ ===
+
+// Сброс анимации двери при загрузке уровня
+void game_exit_reset(void) {
+    s_exit.state = EXIT_CLOSED;
+    s_exit.animation_offset = 0;
+}
+
+// Получить текущее смещение анимации двери для рендера
+int game_exit_anim_offset(void) {
+    return s_exit.animation_offset;
+}
+
+// Проверить, завершена ли анимация открытия двери
+bool game_exit_is_open(void) {
+    return s_exit.state == EXIT_OPEN;
+}
@@ -0,0 +1,333 @@
+// level.c - Парсер оригинальных уровней Bounce + runtime-операции с тайлами
+// Рендер уровня вынесен в level_render.c, чтобы этот модуль собирался без PSPSDK.
+#include "level.h"
+#include "tile_table.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Статические переменные для респауна (как в оригинальном Java коде)
+static REF_THREAD_LOCAL int s_respawn_x = 0, s_respawn_y = 0;
+
+typedef struct {
+    unsigned char* data;
+    int size;
+} level_cache_entry_t;
+
+static level_cache_entry_t s_level_cache[MAX_LEVEL + 1];
+static int s_level_cache_preloaded = 0;
+
+// Формат пути к файлам уровней
+#define LEVEL_PATH_FORMAT "levels/J2MElvl.%03d"
+
+REF_THREAD_LOCAL Level g_level;
+
+
+static int level_read_file_to_buffer(const char* filename, unsigned char** out_data, int* out_size) {
+    FILE* file = util_open_file(filename, "rb");
+    if (!file) return 0;
+
+    if (fseek(file, 0, SEEK_END) != 0) {
+        fclose(file);
+        return 0;
+    }
+
+    long fileSize = ftell(file);
+    if (fileSize < 8 || fileSize > 0x7FFFFFFF) {
+        fclose(file);
+        return 0;
+    }
+
+    if (fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return 0;
+    }
+
+    unsigned char* buffer = (unsigned char*)malloc((size_t)fileSize);
+    if (!buffer) {
+        fclose(file);
+        return 0;
+    }
+
+    size_t bytesRead = fread(buffer, 1, (size_t)fileSize, file);
+    fclose(file);
+    if (bytesRead != (size_t)fileSize) {
+        free(buffer);
+        return 0;
+    }
+
+    *out_data = buffer;
+    *out_size = (int)fileSize;
+    return 1;
+}
+
+static int level_cache_load_one(int levelNumber) {
+    if (levelNumber < 1 || levelNumber > MAX_LEVEL) {
+        return 0;
+    }
+
+    if (s_level_cache[levelNumber].data && s_level_cache[levelNumber].size > 0) {
+        return 1;
+    }
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), LEVEL_PATH_FORMAT, levelNumber);
+
+    unsigned char* data = NULL;
+    int size = 0;
+    if (!level_read_file_to_buffer(filename, &data, &size)) {
+        return 0;
+    }
+
+    s_level_cache[levelNumber].data = data;
+    s_level_cache[levelNumber].size = size;
+    return 1;
+}
+
+static void level_cache_preload_all_once(void) {
+    if (s_level_cache_preloaded) {
+        return;
+    }
+
+    for (int level = 1; level <= MAX_LEVEL; ++level) {
+        (void)level_cache_load_one(level);
+    }
+
+    s_level_cache_preloaded = 1;
+}
+
+// --- Загрузка уровня из файла ---
+int level_load_from_file(const char* filename) {
+    unsigned char* buffer = NULL;
+    int fileSize = 0;
+    if (!level_read_file_to_buffer(filename, &buffer, &fileSize)) {
+        return 0;
+    }
+
+    int result = level_load_from_memory((const char*)buffer, fileSize);
+    free(buffer);
+    return result;
+}
+
+// --- Загрузка уровня по номеру ---
+int level_load_by_number(int levelNumber) {
+    if (levelNumber < 1 || levelNumber > MAX_LEVEL) {
+        return 0;
+    }
+
+    level_cache_preload_all_once();
+
+    if (level_cache_load_one(levelNumber)) {
+        return level_load_from_memory((const char*)s_level_cache[levelNumber].data,
+                                      s_level_cache[levelNumber].size);
+    }
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), LEVEL_PATH_FORMAT, levelNumber);
+    return level_load_from_file(filename);
+}
+
+// --- Парсер из памяти ---
+int level_load_from_memory(const char* levelData, int dataSize) {
+    if (!levelData || dataSize < 8) return 0;
+    memset(&g_level, 0, sizeof(Level));
+
+    const unsigned char* data = (const unsigned char*)levelData;
+    int offset = 0;
+
+    int startX_tiles   = data[offset++];
+    int startY_tiles   = data[offset++];
+    g_level.ballSize   = data[offset++];
+    g_level.exitPosX   = data[offset++];
+    g_level.exitPosY   = data[offset++];
+    g_level.totalRings = data[offset++];
+    g_level.width      = data[offset++];
+    g_level.height     = data[offset++];
+
+    if (g_level.width <= 0 || g_level.height <= 0 ||
+        g_level.width  > MAX_LEVEL_WIDTH || g_level.height > MAX_LEVEL_HEIGHT) {
+        return 0;
+    }
+
+    int mapBytes = g_level.width * g_level.height;
+    if (offset + mapBytes > dataSize) return 0;
+
+    int start_half = (g_level.ballSize == BALL_SIZE_SMALL) ? HALF_NORMAL_SIZE : HALF_ENLARGED_SIZE;
+    g_level.startPosX = startX_tiles * TILE_SIZE + start_half;
+    g_level.startPosY = startY_tiles * TILE_SIZE + start_half;
+    g_level.startTileX = startX_tiles;
+    g_level.startTileY = startY_tiles;
+
+    for (int y = 0; y < g_level.height; ++y) {
+        for (int x = 0; x < g_level.width; ++x) {
+            g_level.tileMap[y][x] = data[offset++];
+        }
+    }
+
+    // Загружаем движущиеся объекты (если есть)
+    g_level.numMovingObjects = 0;
+    if (dataSize - offset >= 1) {
+        int numMoveObj = data[offset++];
+        if (numMoveObj > 0 && numMoveObj <= MAX_MOVING_OBJECTS) {
+            // Проверяем, что хватает данных для всех объектов (каждый = 8 байт)
+            int requiredBytes = numMoveObj * 8;
+            if (dataSize - offset >= requiredBytes) {
+                g_level.numMovingObjects = numMoveObj;
+                
+                // Читаем данные каждого движущегося объекта
+                for (int i = 0; i < numMoveObj; ++i) {
+                    MovingObject* obj = &g_level.movingObjects[i];
+                    
+                    // Читаем topLeft, botRight, direction, startOffset
+                    obj->topLeft[0] = data[offset++];      // X
+                    obj->topLeft[1] = data[offset++];      // Y
+                    obj->botRight[0] = data[offset++];     // X  
+                    obj->botRight[1] = data[offset++];     // Y
+                    obj->direction[0] = (short)(signed char)data[offset++];    // X direction (знаковый int8_t -> short)
+                    obj->direction[1] = (short)(signed char)data[offset++];    // Y direction (знаковый int8_t -> short)  
+                    obj->offset[0] = data[offset++];       // Start X offset
+                    obj->offset[1] = data[offset++];       // Start Y offset
+                }
+            }
+        }
+    }
+
+    return 1;
+}
+
+
+// --- Доступ к тайлам ---
+int level_get_tile_at(int tileX, int tileY) {
+    if (tileX < 0 || tileX >= g_level.width || tileY < 0 || tileY >= g_level.height) {
+        return 1; // вне карты считаем стеной
+    }
+    return g_level.tileMap[tileY][tileX];
+}
+
+
+// --- Функции для движущихся объектов ---
+
+// Обновление позиций движущихся объектов (логика из Java updateMovingSpikeObj)
+// ПРИМЕЧАНИЕ: Делитель 30 FPS теперь управляется из game.c
+void level_update_moving_objects(void) {
+    
+    for (int i = 0; i < g_level.numMovingObjects; ++i) {
+        MovingObject* obj = &g_level.movingObjects[i];
+        
+        // Обновляем X offset
+        obj->offset[0] += obj->direction[0];
+        
+        // Вычисляем границы движения (в пикселях)
+        int maxOffsetX = (obj->botRight[0] - obj->topLeft[0] - 2) * TILE_SIZE;
+        int maxOffsetY = (obj->botRight[1] - obj->topLeft[1] - 2) * TILE_SIZE;
+        
+        // Проверяем границы по X и отражаем направление при достижении
+        if (obj->offset[0] <= 0) {
+            obj->offset[0] = 0;
+            obj->direction[0] = -obj->direction[0];
+        } else if (obj->offset[0] >= maxOffsetX) {
+            obj->offset[0] = (short)maxOffsetX;
+            obj->direction[0] = -obj->direction[0];
+        }
+        
+        // Обновляем Y offset  
+        obj->offset[1] += obj->direction[1];
+        
+        // Проверяем границы по Y и отражаем направление при достижении
+        if (obj->offset[1] <= 0) {
+            obj->offset[1] = 0;
+            obj->direction[1] = -obj->direction[1];
+        } else if (obj->offset[1] >= maxOffsetY) {
+            obj->offset[1] = (short)maxOffsetY;
+            obj->direction[1] = -obj->direction[1];
+        }
+    }
+}
+
+// Поиск движущегося объекта в данном тайле (аналог findSpikeIndex)
+int level_find_moving_object_at(int tileX, int tileY) {
+    for (int i = 0; i < g_level.numMovingObjects; ++i) {
+        MovingObject* obj = &g_level.movingObjects[i];
+        
+        // Проверяем, входит ли тайл в область движущегося объекта
+        if (obj->topLeft[0] <= tileX && obj->botRight[0] > tileX &&
+            obj->topLeft[1] <= tileY && obj->botRight[1] > tileY) {
+            return i;
+        }
+    }
+    return -1;  // Не найдено
+}
+
+MovingObject* level_get_moving_object(int index) {
+    if (index >= 0 && index < g_level.numMovingObjects) {
+        return &g_level.movingObjects[index];
+    }
+    return NULL;
+}
+
+// ============================================================================
+// ОПЕРАЦИИ С ТАЙЛАМИ КАРТЫ (для событийной системы)
+// ============================================================================
+
+// Временно удаляем - переместим в начало файла
+
+// Получить ID тайла (без флагов)
+uint8_t level_get_id(int tx, int ty) {
+    if (tx < 0 || tx >= g_level.width || ty < 0 || ty >= g_level.height) {
+        return 0; // За пределами карты - пустой тайл
+    }
+    return (uint8_t)(g_level.tileMap[ty][tx] & TILE_ID_MASK);
+}
+
+// Установить ID тайла (сохраняя флаги)
+void level_set_id(int tx, int ty, uint8_t id) {
+    if (tx >= 0 && tx < g_level.width && ty >= 0 && ty < g_level.height) {
+        short old_tile = g_level.tileMap[ty][tx];
+        short flags = old_tile & ~TILE_ID_MASK;  // Сохраняем все флаги
+        g_level.tileMap[ty][tx] = flags | (id & TILE_ID_MASK);  // Объединяем с новым ID
+    }
+}
+
+
+// Деактивировать старый чекпоинт перед установкой нового respawn.
+void level_deactivate_old_checkpoint(void) {
+    if (s_respawn_x >= 0 && s_respawn_x < g_level.width && s_respawn_y >= 0 && s_respawn_y < g_level.height) {
+        level_set_id(s_respawn_x, s_respawn_y, TILE_CHECKPOINT_ON);
+    }
+}
+
+// Активировать чекпоинт ((id&0x7F)|0x88) - соответствует Java: tileMap[paramInt1][paramInt2] = 136
+void level_mark_checkpoint_active(int tx, int ty) {
+    if (tx >= 0 && tx < g_level.width && ty >= 0 && ty < g_level.height) {
+        uint8_t id = level_get_id(tx, ty);
+        id = TILE_CHECKPOINT_ON; // Просто 8, без dirty бита (ТЕСТ)
+        level_set_id(tx, ty, id);
+    }
+}
+
+// Установить новую точку респауна (соответствует Java: setRespawn)
+// ВАЖНО: Эта функция только сохраняет координаты. Управление визуальным состоянием
+// чекпоинтов (деактивация старого, активация нового) должно выполняться вызывающим кодом.
+// См. game_set_respawn() для полного алгоритма активации чекпоинта.
+void level_set_respawn(int tx, int ty) {
+    s_respawn_x = tx;
+    s_respawn_y = ty;
+}
+
+// Получить текущую позицию респауна
+void level_get_respawn(int* tx, int* ty) {
+    if (tx) *tx = s_respawn_x;
+    if (ty) *ty = s_respawn_y;
+}
+
+// --- Cleanup function for resource deallocation ---
+void level_cleanup(void) {
+    for (int level = 1; level <= MAX_LEVEL; ++level) {
+        free(s_level_cache[level].data);
+        s_level_cache[level].data = NULL;
+        s_level_cache[level].size = 0;
+    }
+    s_level_cache_preloaded = 0;
+}
@@ -0,0 +1,44 @@
+// platform_host.c - Заглушки PSP-зависимых функций для нативной сборки ядра
+// Ядро (physics.c, level.c, game_logic.c) вызывает звук, сохранения и открытие
+// файлов; на хосте звук и рекорды не нужны, а файлы ищутся от data root.
+#include "platform_host.h"
+#include "types.h"
+#include "sound.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static char s_data_root[512] = "";
+
+void host_set_data_root(const char* path) {
+    if (!path) path = "";
+    snprintf(s_data_root, sizeof(s_data_root), "%s", path);
+}
+
+uint64_t host_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Аналог util_open_file() из main.c: пути относительно data root
+FILE* util_open_file(const char* path, const char* mode) {
+    if (!path || !mode) return NULL;
+    if (s_data_root[0] == '\0' || path[0] == '/') {
+        return fopen(path, mode);
+    }
+    char full[1024];
+    snprintf(full, sizeof(full), "%s/%s", s_data_root, path);
+    return fopen(full, mode);
+}
+
+// Звук: в headless-прогоне события симуляции не озвучиваются
+void sound_play_hoop(void) {}
+void sound_play_pickup(void) {}
+void sound_play_pop(void) {}
+
+// Рекорды: хостовая сборка не пишет сохранения
+void save_update_records(int level, int score) {
+    (void)level;
+    (void)score;
+}
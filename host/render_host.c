@@ -0,0 +1,59 @@
+// render_host.c - Подмена графики PSP для рендера уровня на хосте
+// Атлас не читается с диска: текстура-заглушка имеет размеры icons/objects_nm.png
+// (48x72), поэтому level_render.c проходит те же проверки спрайтов, что и на PSP.
+#include "render_host.h"
+#include "graphics.h"
+#include <stddef.h>
+
+#define HOST_ATLAS_WIDTH  48
+#define HOST_ATLAS_HEIGHT 72
+
+render_host_counters_t g_render_host;
+
+static int s_texturing = 0;
+static texture_t s_atlas = { NULL, HOST_ATLAS_WIDTH, HOST_ATLAS_HEIGHT,
+                             HOST_ATLAS_WIDTH, HOST_ATLAS_HEIGHT, 0, 0 };
+
+void graphics_set_texturing(int enabled) {
+    enabled = enabled ? 1 : 0;
+    if (enabled != s_texturing) {
+        g_render_host.modeSwitches++;
+        s_texturing = enabled;
+    }
+}
+
+void graphics_begin_plain(void) { graphics_set_texturing(0); }
+void graphics_begin_textured(void) { graphics_set_texturing(1); }
+int graphics_get_texturing_state(void) { return s_texturing; }
+
+void graphics_draw_rect(int x, int y, int w, int h, u32 color) {
+    (void)x; (void)y; (void)w; (void)h; (void)color;
+    g_render_host.rects++;
+}
+
+texture_t* png_load_texture_vram(const char* path) {
+    (void)path;
+    return &s_atlas;
+}
+
+sprite_rect_t png_create_sprite_rect(texture_t* tex, int x, int y, int w, int h) {
+    (void)tex;
+    sprite_rect_t r = { x, y, w, h };
+    return r;
+}
+
+void png_draw_sprite(texture_t* tex, sprite_rect_t* sprite, int x, int y, int w, int h) {
+    (void)tex; (void)sprite; (void)x; (void)y; (void)w; (void)h;
+    g_render_host.sprites++;
+}
+
+void png_draw_sprite_transform(texture_t* tex, sprite_rect_t* sprite,
+                               int x, int y, int w, int h,
+                               png_transform_t transform) {
+    (void)tex; (void)sprite; (void)x; (void)y; (void)w; (void)h; (void)transform;
+    g_render_host.sprites++;
+}
+
+void png_free_texture(texture_t* tex) {
+    (void)tex;
+}
@@ -0,0 +1,18 @@
+// render_host.h - Счетчики хостовой подмены графики для level_render.c
+// render_host.c реализует функции graphics_* и png_*, которые вызывает рендер
+// уровня, без вывода: вызовы только считаются. Так level_render_visible_area()
+// можно гонять и замерять на хосте, а число примитивов кадра сравнивать между картами.
+#ifndef RENDER_HOST_H
+#define RENDER_HOST_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t rects;          // graphics_draw_rect()
+    uint64_t sprites;        // png_draw_sprite() и png_draw_sprite_transform()
+    uint64_t modeSwitches;   // graphics_begin_plain()/graphics_begin_textured() со сменой режима
+} render_host_counters_t;
+
+extern render_host_counters_t g_render_host;
+
+#endif // RENDER_HOST_H
@@ -0,0 +1,178 @@
+// collision_lut.c - Таблица коллизий мяча с тайлом
+// Сгенерировано host/gen_collision_lut из collision_ref.c, не редактировать вручную.
+#include "collision_lut.h"
+
+const uint32_t g_collision_lut[2][COLLIDE_SHAPE_COUNT][COLLISION_LUT_SPAN] = {
+    {   // Мяч 12x12
+        [COLLIDE_SQUARE] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x01FFFC00, 0x07FFFF00, 0x0FFFFF80, 0x0FFFFF80, 0x1FFFFFC0, 0x1FFFFFC0,
+            0x1FFFFFC0, 0x1FFFFFC0, 0x1FFFFFC0, 0x1FFFFFC0, 0x1FFFFFC0, 0x1FFFFFC0,
+            0x1FFFFFC0, 0x1FFFFFC0, 0x1FFFFFC0, 0x1FFFFFC0, 0x1FFFFFC0, 0x1FFFFFC0,
+            0x1FFFFFC0, 0x0FFFFF80, 0x0FFFFF80, 0x07FFFF00, 0x01FFFC00, 0x00000000,
+        },
+        [COLLIDE_RAMP_30] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x01FFFC00, 0x07FFFF00, 0x0FFFFF80, 0x0FFFFF80, 0x1FFFFFC0, 0x1FFFFFC0,
+            0x1FFFFFC0, 0x1FFFFFC0, 0x0FFFFFC0, 0x0FFFFFC0, 0x07FFFFC0, 0x03FFFFC0,
+            0x01FFFFC0, 0x00FFFFC0, 0x007FFFC0, 0x003FFFC0, 0x001FFFC0, 0x000FFFC0,
+            0x0007FFC0, 0x0003FF80, 0x0001FF80, 0x0000FF00, 0x00003C00, 0x00000000,
+        },
+        [COLLIDE_RAMP_31] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x01FFFC00, 0x07FFFF00, 0x0FFFFF80, 0x0FFFFF80, 0x1FFFFFC0, 0x1FFFFFC0,
+            0x1FFFFFC0, 0x1FFFFFC0, 0x1FFFFF80, 0x1FFFFF80, 0x1FFFFF00, 0x1FFFFE00,
+            0x1FFFFC00, 0x1FFFF800, 0x1FFFF000, 0x1FFFE000, 0x1FFFC000, 0x1FFF8000,
+            0x1FFF0000, 0x0FFE0000, 0x0FFC0000, 0x07F80000, 0x01E00000, 0x00000000,
+        },
+        [COLLIDE_RAMP_32] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x01E00000, 0x07F80000, 0x0FFC0000, 0x0FFE0000, 0x1FFF0000, 0x1FFF8000,
+            0x1FFFC000, 0x1FFFE000, 0x1FFFF000, 0x1FFFF800, 0x1FFFFC00, 0x1FFFFE00,
+            0x1FFFFF00, 0x1FFFFF80, 0x1FFFFF80, 0x1FFFFFC0, 0x1FFFFFC0, 0x1FFFFFC0,
+            0x1FFFFFC0, 0x0FFFFF80, 0x0FFFFF80, 0x07FFFF00, 0x01FFFC00, 0x00000000,
+        },
+        [COLLIDE_RAMP_33] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00003C00, 0x0000FF00, 0x0001FF80, 0x0003FF80, 0x0007FFC0, 0x000FFFC0,
+            0x001FFFC0, 0x003FFFC0, 0x007FFFC0, 0x00FFFFC0, 0x01FFFFC0, 0x03FFFFC0,
+            0x07FFFFC0, 0x0FFFFFC0, 0x0FFFFFC0, 0x1FFFFFC0, 0x1FFFFFC0, 0x1FFFFFC0,
+            0x1FFFFFC0, 0x0FFFFF80, 0x0FFFFF80, 0x07FFFF00, 0x01FFFC00, 0x00000000,
+        },
+        [COLLIDE_THIN_VERT] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x03FFFE00,
+            0x03FFFE00, 0x03FFFE00, 0x03FFFE00, 0x03FFFE00, 0x03FFFE00, 0x03FFFE00,
+            0x03FFFE00, 0x03FFFE00, 0x03FFFE00, 0x03FFFE00, 0x03FFFE00, 0x03FFFE00,
+            0x03FFFE00, 0x03FFFE00, 0x03FFFE00, 0x03FFFE00, 0x03FFFE00, 0x03FFFE00,
+            0x03FFFE00, 0x03FFFE00, 0x03FFFE00, 0x03FFFE00, 0x03FFFE00, 0x03FFFE00,
+        },
+        [COLLIDE_THIN_HORIZ] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x00000000, 0x00000000, 0x3FFFFFE0, 0x3FFFFFE0, 0x3FFFFFE0,
+            0x3FFFFFE0, 0x3FFFFFE0, 0x3FFFFFE0, 0x3FFFFFE0, 0x3FFFFFE0, 0x3FFFFFE0,
+            0x3FFFFFE0, 0x3FFFFFE0, 0x3FFFFFE0, 0x3FFFFFE0, 0x3FFFFFE0, 0x3FFFFFE0,
+            0x3FFFFFE0, 0x3FFFFFE0, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        },
+        [COLLIDE_EDGE_TOP] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00FFF800,
+            0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800,
+            0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800,
+            0x00FFF800, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        },
+        [COLLIDE_EDGE_BOTTOM] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00FFF800, 0x00FFF800,
+            0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800,
+            0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800,
+        },
+        [COLLIDE_EDGE_LARGE_TOP] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00FFF800, 0x00FFF800,
+            0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800,
+            0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800, 0x00FFF800,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        },
+        [COLLIDE_EDGE_LEFT] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0007FFE0,
+            0x0007FFE0, 0x0007FFE0, 0x0007FFE0, 0x0007FFE0, 0x0007FFE0, 0x0007FFE0,
+            0x0007FFE0, 0x0007FFE0, 0x0007FFE0, 0x0007FFE0, 0x0007FFE0, 0x0007FFE0,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        },
+        [COLLIDE_EDGE_RIGHT] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x3FFF0000,
+            0x3FFF0000, 0x3FFF0000, 0x3FFF0000, 0x3FFF0000, 0x3FFF0000, 0x3FFF0000,
+            0x3FFF0000, 0x3FFF0000, 0x3FFF0000, 0x3FFF0000, 0x3FFF0000, 0x3FFF0000,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        },
+    },
+    {   // Мяч 16x16
+        [COLLIDE_SQUARE] = {
+            0x00000000, 0x00000000, 0x00FFFF80, 0x03FFFFE0, 0x07FFFFF0, 0x0FFFFFF8,
+            0x0FFFFFF8, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC,
+            0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC,
+            0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC,
+            0x0FFFFFF8, 0x0FFFFFF8, 0x07FFFFF0, 0x03FFFFE0, 0x00FFFF80, 0x00000000,
+        },
+        [COLLIDE_RAMP_30] = {
+            0x00000000, 0x00000000, 0x00FFFF80, 0x03FFFFE0, 0x07FFFFF0, 0x0FFFFFF8,
+            0x0FFFFFF8, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC,
+            0x1FFFFFFC, 0x0FFFFFFC, 0x0FFFFFFC, 0x07FFFFFC, 0x03FFFFFC, 0x01FFFFFC,
+            0x00FFFFFC, 0x007FFFFC, 0x003FFFFC, 0x001FFFFC, 0x000FFFFC, 0x0007FFFC,
+            0x0003FFF8, 0x0001FFF8, 0x0000FFF0, 0x00007FE0, 0x00001F80, 0x00000000,
+        },
+        [COLLIDE_RAMP_31] = {
+            0x00000000, 0x00000000, 0x00FFFF80, 0x03FFFFE0, 0x07FFFFF0, 0x0FFFFFF8,
+            0x0FFFFFF8, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC,
+            0x1FFFFFFC, 0x1FFFFFF8, 0x1FFFFFF8, 0x1FFFFFF0, 0x1FFFFFE0, 0x1FFFFFC0,
+            0x1FFFFF80, 0x1FFFFF00, 0x1FFFFE00, 0x1FFFFC00, 0x1FFFF800, 0x1FFFF000,
+            0x0FFFE000, 0x0FFFC000, 0x07FF8000, 0x03FF0000, 0x00FC0000, 0x00000000,
+        },
+        [COLLIDE_RAMP_32] = {
+            0x00000000, 0x00000000, 0x00FC0000, 0x03FF0000, 0x07FF8000, 0x0FFFC000,
+            0x0FFFE000, 0x1FFFF000, 0x1FFFF800, 0x1FFFFC00, 0x1FFFFE00, 0x1FFFFF00,
+            0x1FFFFF80, 0x1FFFFFC0, 0x1FFFFFE0, 0x1FFFFFF0, 0x1FFFFFF8, 0x1FFFFFF8,
+            0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC,
+            0x0FFFFFF8, 0x0FFFFFF8, 0x07FFFFF0, 0x03FFFFE0, 0x00FFFF80, 0x00000000,
+        },
+        [COLLIDE_RAMP_33] = {
+            0x00000000, 0x00000000, 0x00001F80, 0x00007FE0, 0x0000FFF0, 0x0001FFF8,
+            0x0003FFF8, 0x0007FFFC, 0x000FFFFC, 0x001FFFFC, 0x003FFFFC, 0x007FFFFC,
+            0x00FFFFFC, 0x01FFFFFC, 0x03FFFFFC, 0x07FFFFFC, 0x0FFFFFFC, 0x0FFFFFFC,
+            0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC, 0x1FFFFFFC,
+            0x0FFFFFF8, 0x0FFFFFF8, 0x07FFFFF0, 0x03FFFFE0, 0x00FFFF80, 0x00000000,
+        },
+        [COLLIDE_THIN_VERT] = {
+            0x00000000, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0,
+            0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0,
+            0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0,
+            0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0,
+            0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0, 0x03FFFFE0,
+        },
+        [COLLIDE_THIN_HORIZ] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x3FFFFFFE,
+            0x3FFFFFFE, 0x3FFFFFFE, 0x3FFFFFFE, 0x3FFFFFFE, 0x3FFFFFFE, 0x3FFFFFFE,
+            0x3FFFFFFE, 0x3FFFFFFE, 0x3FFFFFFE, 0x3FFFFFFE, 0x3FFFFFFE, 0x3FFFFFFE,
+            0x3FFFFFFE, 0x3FFFFFFE, 0x3FFFFFFE, 0x3FFFFFFE, 0x3FFFFFFE, 0x3FFFFFFE,
+            0x3FFFFFFE, 0x3FFFFFFE, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        },
+        [COLLIDE_EDGE_TOP] = {
+            0x00000000, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80,
+            0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80,
+            0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80,
+            0x00FFFF80, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        },
+        [COLLIDE_EDGE_BOTTOM] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80,
+            0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80,
+            0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80,
+        },
+        [COLLIDE_EDGE_LARGE_TOP] = {
+            0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80,
+            0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80,
+            0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80, 0x00FFFF80,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        },
+        [COLLIDE_EDGE_LEFT] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x0007FFFE, 0x0007FFFE, 0x0007FFFE, 0x0007FFFE, 0x0007FFFE,
+            0x0007FFFE, 0x0007FFFE, 0x0007FFFE, 0x0007FFFE, 0x0007FFFE, 0x0007FFFE,
+            0x0007FFFE, 0x0007FFFE, 0x0007FFFE, 0x0007FFFE, 0x0007FFFE, 0x0007FFFE,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        },
+        [COLLIDE_EDGE_RIGHT] = {
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+            0x00000000, 0x3FFFF000, 0x3FFFF000, 0x3FFFF000, 0x3FFFF000, 0x3FFFF000,
+            0x3FFFF000, 0x3FFFF000, 0x3FFFF000, 0x3FFFF000, 0x3FFFF000, 0x3FFFF000,
+            0x3FFFF000, 0x3FFFF000, 0x3FFFF000, 0x3FFFF000, 0x3FFFF000, 0x3FFFF000,
+            0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        },
+    },
+};
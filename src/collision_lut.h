@@ -0,0 +1,60 @@
+// collision_lut.h - Предвычисленные таблицы пиксельных коллизий мяча с тайлом
+// Таблица g_collision_lut генерируется host/gen_collision_lut из эталонных
+// циклов collision_ref.c (маски level_masks.inc + прямоугольники thin/edge).
+// Пересчитать:  make -C host lut      Проверить:  host/build/gen_collision_lut -v
+#ifndef COLLISION_LUT_H
+#define COLLISION_LUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "types.h"
+
+// Формы тайлов для коллизий мяча (одинаковые формы разных ID объединены)
+typedef enum {
+    COLLIDE_SQUARE = 0,        // Кирпич/резина 1-2 (пиксельная маска мяча)
+    COLLIDE_RAMP_30,           // Рампы 30/34 (пиксельная маска мяча на треугольник)
+    COLLIDE_RAMP_31,           // Рампы 31/35
+    COLLIDE_RAMP_32,           // Рампы 32/36
+    COLLIDE_RAMP_33,           // Рампы 33/37
+    COLLIDE_THIN_VERT,         // thinCollide: сужение по X (шипы 3/5, выход, вертикальные кольца, инфлятор пол/потолок)
+    COLLIDE_THIN_HORIZ,        // thinCollide: сужение по Y (шипы 4/6, горизонтальные кольца, инфлятор стены)
+    COLLIDE_EDGE_TOP,          // edgeCollide 13/17: верхняя кромка малого вертикального кольца
+    COLLIDE_EDGE_BOTTOM,       // edgeCollide 14/18/22/26: нижняя кромка вертикального кольца
+    COLLIDE_EDGE_LARGE_TOP,    // edgeCollide 21/25: кромка над большим вертикальным кольцом
+    COLLIDE_EDGE_LEFT,         // edgeCollide 15/19/23/27: левая кромка горизонтального кольца
+    COLLIDE_EDGE_RIGHT,        // edgeCollide 16/20/24/28: правая кромка горизонтального кольца
+    COLLIDE_SHAPE_COUNT
+} collision_shape_t;
+
+// Окно смещений мяча относительно левого-верхнего угла тайла (dx, dy в пикселях).
+// Нижняя граница: большой мяч касается кромки 21/25, стоящей на пиксель выше тайла;
+// верхняя: касание правой/нижней границы тайла (rectCollide включает границы).
+// Вне окна коллизии нет ни для одной формы.
+#define COLLISION_LUT_MIN  (-(ENLARGED_SIZE + 1))
+#define COLLISION_LUT_MAX  TILE_SIZE
+#define COLLISION_LUT_SPAN (COLLISION_LUT_MAX - COLLISION_LUT_MIN + 1)
+
+_Static_assert(COLLISION_LUT_SPAN <= 32, "one uint32_t row of g_collision_lut covers all dx");
+
+// [мяч: 0 = 12px, 1 = 16px][форма][dy - MIN], бит (dx - MIN) = коллизия
+extern const uint32_t g_collision_lut[2][COLLIDE_SHAPE_COUNT][COLLISION_LUT_SPAN];
+
+// То же по строкам одной формы g_collision_lut[мяч][форма], когда мяч и форма
+// известны заранее
+static inline bool collision_lut_test_rows(const uint32_t* rows, int dx, int dy) {
+    unsigned ux = (unsigned)(dx - COLLISION_LUT_MIN);
+    unsigned uy = (unsigned)(dy - COLLISION_LUT_MIN);
+    if (ux >= COLLISION_LUT_SPAN || uy >= COLLISION_LUT_SPAN) return false;
+    return (rows[uy] >> ux) & 1u;
+}
+
+// Коллизия мяча со смещением (dx, dy) относительно тайла формы shape: одна выборка
+static inline bool collision_lut_test(int ballSize, collision_shape_t shape, int dx, int dy) {
+    return collision_lut_test_rows(g_collision_lut[ballSize == ENLARGED_SIZE][shape], dx, dy);
+}
+
+// Эталонные циклы (collision_ref.c, только для генератора и проверки таблицы)
+bool collision_reference(int ballSize, collision_shape_t shape, int dx, int dy);
+const char* collision_shape_name(collision_shape_t shape);
+
+#endif // COLLISION_LUT_H
@@ -0,0 +1,73 @@
+// collision_ref.c - Эталонные попиксельные коллизии мяча с тайлом
+// Прямой перенос циклов squareCollide/triangleCollide и прямоугольников
+// thinCollide/edgeCollide из Ball.java. В игре не вызывается: по этим функциям
+// host/gen_collision_lut строит и проверяет таблицу g_collision_lut.
+#include "collision_lut.h"
+#include "level_masks.inc"
+
+// Прямоугольник формы в координатах тайла (границы включительно, как rectCollide)
+typedef struct {
+    int x1, y1, x2, y2;
+} collision_rect_t;
+
+static const collision_rect_t s_shape_rects[COLLIDE_SHAPE_COUNT] = {
+    [COLLIDE_THIN_VERT]      = { THIN_TILE_SIZE, 0, TILE_SIZE - THIN_TILE_SIZE, TILE_SIZE },   // i += 4, k -= 4
+    [COLLIDE_THIN_HORIZ]     = { 0, THIN_TILE_SIZE, TILE_SIZE, TILE_SIZE - THIN_TILE_SIZE },   // j += 4, m -= 4
+    [COLLIDE_EDGE_TOP]       = { 6, 0, TILE_SIZE - 6, TILE_SIZE - 11 },                          // i += 6, k -= 6, m -= 11
+    [COLLIDE_EDGE_BOTTOM]    = { 6, 11, TILE_SIZE - 6, TILE_SIZE },                              // i += 6, k -= 6, j += 11
+    [COLLIDE_EDGE_LARGE_TOP] = { 6, -1, TILE_SIZE - 6, 0 },                                      // m = j; j--
+    [COLLIDE_EDGE_LEFT]      = { 0, 6, TILE_SIZE - 11, TILE_SIZE - 6 },                          // j += 6, m -= 6, k -= 11
+    [COLLIDE_EDGE_RIGHT]     = { 11, 6, TILE_SIZE, TILE_SIZE - 6 },                              // j += 6, m -= 6, i += 11
+};
+
+static const char* const s_shape_names[COLLIDE_SHAPE_COUNT] = {
+    "COLLIDE_SQUARE", "COLLIDE_RAMP_30", "COLLIDE_RAMP_31", "COLLIDE_RAMP_32", "COLLIDE_RAMP_33",
+    "COLLIDE_THIN_VERT", "COLLIDE_THIN_HORIZ", "COLLIDE_EDGE_TOP", "COLLIDE_EDGE_BOTTOM",
+    "COLLIDE_EDGE_LARGE_TOP", "COLLIDE_EDGE_LEFT", "COLLIDE_EDGE_RIGHT"
+};
+
+const char* collision_shape_name(collision_shape_t shape) {
+    return ((unsigned)shape < COLLIDE_SHAPE_COUNT) ? s_shape_names[shape] : "?";
+}
+
+static bool mask_bit(const uint16_t* rows, int x, int y) {
+    return (rows[y] >> x) & 1u;
+}
+
+// Попиксельный обход пересечения мяча с тайлом (X-снаружи, Y-внутри, как в Java)
+static bool pixel_collide(int ballSize, const uint16_t* tileRows, int k, int m) {
+    const uint16_t* ballRows = (ballSize == ENLARGED_SIZE) ? LARGE_BALL_ROWS : SMALL_BALL_ROWS;
+
+    int x_start = (k >= 0) ? k : 0;
+    int x_end = (k >= 0) ? TILE_SIZE : ballSize + k;
+    int y_start = (m >= 0) ? m : 0;
+    int y_end = (m >= 0) ? TILE_SIZE : ballSize + m;
+    if (x_end > TILE_SIZE) x_end = TILE_SIZE;
+    if (y_end > TILE_SIZE) y_end = TILE_SIZE;
+
+    for (int x = x_start; x < x_end; x++) {
+        for (int y = y_start; y < y_end; y++) {
+            bool tileBit = tileRows ? mask_bit(tileRows, x, y) : true;
+            if (tileBit && mask_bit(ballRows, x - k, y - m)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool collision_reference(int ballSize, collision_shape_t shape, int dx, int dy) {
+    switch (shape) {
+        case COLLIDE_SQUARE:
+            return pixel_collide(ballSize, NULL, dx, dy);
+        case COLLIDE_RAMP_30: case COLLIDE_RAMP_31: case COLLIDE_RAMP_32: case COLLIDE_RAMP_33:
+            return pixel_collide(ballSize, TRI_TILE_ROWS[shape - COLLIDE_RAMP_30], dx, dy);
+        default:
+            if ((unsigned)shape >= COLLIDE_SHAPE_COUNT) return false;
+            // rectCollide(x1, y1, x2, y2, rx1, ry1, rx2, ry2) в координатах тайла
+            {
+                const collision_rect_t* r = &s_shape_rects[shape];
+                return dx <= r->x2 && dy <= r->y2 && r->x1 <= dx + ballSize && r->y1 <= dy + ballSize;
+            }
+    }
+}
@@ -8,28 +8,20 @@
 #include "sound.h"  // OTT audio support
 #include "local.h"  // Для локализации
 #include "splash.h"
+#include "rewind.h"
 #include <pspctrl.h>
 #include <stdio.h>
 #include <stdbool.h>
-#include <stdlib.h>
-
-// Forward declarations
 
 Game g_game;
+SimContext g_sim;
 
-typedef enum {
-    EXIT_CLOSED = 0,
-    EXIT_WAITING_VISIBLE,
-    EXIT_OPENING,
-    EXIT_OPEN
-} ExitState;
+// Журнал перемотки текущего уровня (L без R)
+static rewind_buffer_t s_rewind;
+// Тиков отмотки за один игровой тик: перемотка вдвое быстрее игры
+#define GAME_REWIND_SPEED 2
 
-typedef struct {
-    ExitState state;
-    int animation_offset;
-} ExitController;
-
-static ExitController s_exit = { EXIT_CLOSED, 0 };
+// Forward declarations
 
 // extern texture_t* g_tileset;
 // extern int g_tiles_per_row;
@@ -67,114 +59,7 @@ static void draw_bonus_bar(int x, int y, int bonus_value) {
     }
 }
 
-// Camera - система отслеживания игрока с мертвой зоной
-#define CAMERA_UNINITIALIZED -999
-#define CAMERA_DEADZONE_PERCENT 30   // 30% от игровой области - зона без движения камеры
-// Статическая переменная для вертикальной камеры с мертвой зоной
-static int s_currentCameraY = CAMERA_UNINITIALIZED;
-
-// HUD размеры
-#define HUD_HEIGHT 17               // Высота HUD: 2+12+2px синяя полоса + 1px разделитель
-
-// Проверка является ли уровень маленьким (ниже игровой области по высоте)
-// Такие уровни центрируются по вертикали без мертвой зоны камеры
-static inline bool is_level_small(void) {
-    int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
-    return (g_level.height * TILE_SIZE) < gameAreaHeight;
-}
-
-// Получить смещение камеры для вертикального центрирования маленького уровня
-// Возвращает отрицательное значение для центрирования уровня в игровой области
-static inline int get_center_offset(void) {
-    int levelPixelHeight = g_level.height * TILE_SIZE;
-    int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
-    return -(gameAreaHeight - levelPixelHeight) / 2;
-}
-
-// Единственный расчет камеры для игровой логики и рендера.
-static void game_calculate_camera(int* outCameraX, int* outCameraY) {
-    Player* player = &g_game.player;
-    int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
-    int cameraX = player->xPos - SCREEN_WIDTH / 2;
-
-    if (s_currentCameraY == CAMERA_UNINITIALIZED) {
-        s_currentCameraY = player->yPos - gameAreaHeight / 2;
-    }
-
-    int deadZoneTop = (gameAreaHeight * CAMERA_DEADZONE_PERCENT) / 100;
-    int deadZoneBottom = gameAreaHeight - deadZoneTop;
-
-    if (!is_level_small()) {
-        int playerScreenY = player->yPos - s_currentCameraY;
-        if (playerScreenY < deadZoneTop) {
-            s_currentCameraY = player->yPos - deadZoneTop;
-        } else if (playerScreenY > deadZoneBottom) {
-            s_currentCameraY = player->yPos - deadZoneBottom;
-        }
-    }
-
-    int cameraY = s_currentCameraY;
-    int maxCameraX = g_level.width * TILE_SIZE - SCREEN_WIDTH;
-    int maxCameraY = g_level.height * TILE_SIZE - gameAreaHeight;
-
-    if (cameraX < 0) cameraX = 0;
-    if (cameraX > maxCameraX && maxCameraX > 0) cameraX = maxCameraX;
-
-    if (is_level_small()) {
-        cameraY = get_center_offset();
-    } else {
-        if (cameraY < 0) cameraY = 0;
-        if (cameraY > maxCameraY && maxCameraY > 0) cameraY = maxCameraY;
-    }
-
-    *outCameraX = cameraX;
-    *outCameraY = cameraY;
-}
-
-static bool game_exit_is_visible(int cameraX, int cameraY) {
-    const int exitX = g_level.exitPosX * TILE_SIZE;
-    const int exitY = g_level.exitPosY * TILE_SIZE;
-    const int exitSize = 2 * TILE_SIZE;
-    const int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
-
-    return exitX < cameraX + SCREEN_WIDTH &&
-           exitX + exitSize > cameraX &&
-           exitY < cameraY + gameAreaHeight &&
-           exitY + exitSize > cameraY;
-}
-
-static void game_exit_arm(void) {
-    if (s_exit.state == EXIT_CLOSED) {
-        s_exit.state = EXIT_WAITING_VISIBLE;
-    }
-}
-
-static void game_exit_update(int cameraX, int cameraY) {
-    const bool isVisible = game_exit_is_visible(cameraX, cameraY);
-
-    if (s_exit.state == EXIT_WAITING_VISIBLE && isVisible) {
-        s_exit.state = EXIT_OPENING;
-    }
-
-    // Оригинал делает первый шаг openExit() в тот же тик,
-    // в котором дверь стала видима, и приостанавливает анимацию
-    // если дверь снова ушла за границы видимой области.
-    if (s_exit.state == EXIT_OPENING && isVisible) {
-        s_exit.animation_offset += 4;
-        if (s_exit.animation_offset >= 24) {
-            s_exit.animation_offset = 24;
-            s_exit.state = EXIT_OPEN;
-        }
-    }
-}
-
-void game_reset_camera(void) {
-    if (is_level_small()) {
-        s_currentCameraY = get_center_offset();
-    } else {
-        s_currentCameraY = CAMERA_UNINITIALIZED; // Будет инициализирована позицией игрока
-    }
-}
+// HUD размеры и камера (game_calculate_camera) определены в game.h / game_logic.c
 
 void game_init(void) {
     g_game.state = STATE_SPLASH_NOKIA;
@@ -184,19 +69,8 @@ void game_init(void) {
     // Инициализация saved game state
     g_game.saved_game_state = SAVED_GAME_NONE;
 
-    // Сброс камеры для предотвращения устаревших значений
-    game_reset_camera();
-
     // Отладочные флаги
-    g_game.invincible_cheat = false;      // Читерское бессмертие выключено по умолчанию
-    
-    // Инициализация системы колец (как в Java BounceCanvas.resetGame)
-    g_game.numRings = 0;
-    g_game.score = 0;
-    g_game.numLives = 3;        // Начинаем с 3 жизней как в оригинале
-    
-    // Сброс анимации двери
-    game_exit_reset();
+    g_sim.invincible = false;      // Читерское бессмертие выключено по умолчанию
     
     // Инициализация splash экранов
     g_game.splash_timer = 0;
@@ -206,51 +80,38 @@ void game_init(void) {
     // Инициализация меню
     menu_init();
     
-    // Загружаем уровень 1
-    if (level_load_by_number(1)) {
-        game_reset_camera();
-    }
-    
-    // Инициализация игрока из данных уровня
-    player_init(&g_game.player, g_level.startPosX, g_level.startPosY,
-                g_level.ballSize == BALL_SIZE_SMALL ? SMALL_SIZE_STATE : LARGE_SIZE_STATE);
+    // Атлас тайлов загружается один раз, до первого уровня
+    level_load_tileset();
 
-    // Устанавливаем респавн в стартовую позицию (как в Java: mBall.setRespawn())
-    // Используем исходные тайловые координаты (как в Java: mStartPosX/Y)
-    level_set_respawn(g_level.startTileX, g_level.startTileY);
+    // Загружаем уровень 1: счётчики (как в Java BounceCanvas.resetGame), дверь,
+    // камера, мяч и респавн в стартовой позиции
+    game_start_level(&g_sim, 1, GAME_START_FRESH);
+    rewind_reset(&s_rewind, &g_sim);
 }
 
-void game_start_level(int level_number, game_start_mode_t mode) {
+void game_enter_level(int level_number, game_start_mode_t mode) {
     g_game.state = STATE_GAME;
     g_game.selected_level = level_number;
 
-    if (level_load_by_number(level_number)) {
-        game_reset_camera();
-    }
-
-    // Устанавливаем респавн в стартовую позицию (как в game_init)
-    level_set_respawn(g_level.startTileX, g_level.startTileY);
-
-    if (mode == GAME_START_FRESH || mode == GAME_START_SELECTED) {
-        // Сброс счётчиков при старте уровня (как в Java BounceCanvas.startLevel)
-        g_game.numRings = 0;
-        g_game.score = 0;
-        g_game.numLives = 3;
-    } else if (mode == GAME_START_NEXT) {
-        // При переходе на следующий уровень сохраняем счет/жизни
-        g_game.numRings = 0;
-    }
-
-    // Дверь всегда должна начинать уровень закрытой
-    game_exit_reset();
-
     if (mode == GAME_START_FRESH) {
         g_game.saved_game_state = SAVED_GAME_IN_PROGRESS;
         g_game.new_best_score = false;
     }
 
-    player_init(&g_game.player, g_level.startPosX, g_level.startPosY,
-                g_level.ballSize == BALL_SIZE_SMALL ? SMALL_SIZE_STATE : LARGE_SIZE_STATE);
+    game_start_level(&g_sim, level_number, mode);
+    rewind_reset(&s_rewind, &g_sim);
+}
+
+// Итог уровня из g_sim.state: рекорды и экран результата
+static void game_finish_level(void) {
+    // Обновить рекорды если нужно (как в оригинале BounceCanvas:179-185, 440)
+    save_update_records(g_sim.levelNumber, g_sim.score);
+
+    if (g_sim.state == STATE_GAME_OVER) {
+        g_game.saved_game_state = SAVED_GAME_NONE;
+    }
+    // Экран завершения уровня или Game Over (как в Java displayLevelComplete/displayGameOver)
+    g_game.state = g_sim.state;
 }
 
 static void update_menu_common(void) {
@@ -258,88 +119,86 @@ static void update_menu_common(void) {
     menu_update_by_type(menu_type);
 }
 
+// Звуки событий тика (очередь g_sim.events заполняется внутри game_tick)
+static void game_play_events(void) {
+    for (int i = 0; i < g_sim.events.count; i++) {
+        switch ((SimEventType)g_sim.events.items[i].type) {
+            case SIM_EVENT_RING:
+                sound_play_hoop();
+                break;
+            case SIM_EVENT_CHECKPOINT:
+            case SIM_EVENT_EXTRA_LIFE:
+            case SIM_EVENT_BONUS:
+                sound_play_pickup();
+                break;
+            case SIM_EVENT_POP:
+                sound_play_pop();
+                break;
+            case SIM_EVENT_SCORE:
+            case SIM_EVENT_LEVEL_COMPLETE:
+                break;  // Счёт и экран завершения берутся из состояния g_sim
+        }
+    }
+}
+
 static void update_game(void) {
-    // Обновление направления из инпута
-    Player* player = &g_game.player;
+    // Удержание L (без R) - перемотка назад вместо обычного тика.
+    // Нажатия за время перемотки сбрасываются, чтобы не сработать после нее.
+    if (input_held(PSP_CTRL_LTRIGGER) && !input_held(PSP_CTRL_RTRIGGER)) {
+        rewind_step_back(&s_rewind, &g_sim, GAME_REWIND_SPEED);
+        input_reset_edges();
+        return;
+    }
+
+    // Маска направлений на этот тик; стартует с текущих флагов игрока
+    Player* player = &g_sim.player;
+    MoveMask input = player->direction;
 
     // Java-совместимая архитектура: ввод управляет флагами, физика их только читает
 
     // Движение ВЛЕВО — учитываем и событие press/release, и удержание
     if (input_consume_pressed(PSP_CTRL_LEFT) || input_held(PSP_CTRL_LEFT)) {
-        set_direction(player, MOVE_LEFT);
+        input |= MOVE_LEFT;
     }
     if (input_consume_released(PSP_CTRL_LEFT) || !input_held(PSP_CTRL_LEFT)) {
-        release_direction(player, MOVE_LEFT);
+        input &= (MoveMask)~MOVE_LEFT;
     }
 
     // Движение ВПРАВО — учитываем и событие press/release, и удержание
     if (input_consume_pressed(PSP_CTRL_RIGHT) || input_held(PSP_CTRL_RIGHT)) {
-        set_direction(player, MOVE_RIGHT);
+        input |= MOVE_RIGHT;
     }
     if (input_consume_released(PSP_CTRL_RIGHT) || !input_held(PSP_CTRL_RIGHT)) {
-        release_direction(player, MOVE_RIGHT);
+        input &= (MoveMask)~MOVE_RIGHT;
     }
 
     // ПРЫЖОК: 100% Java-совместимая логика
     // keyPressed -> set_direction, keyReleased -> release_direction
     if (input_consume_pressed(PSP_CTRL_CROSS)) {
-        set_direction(player, MOVE_UP);
+        input |= MOVE_UP;
     }
     // Отпускание прыжка через буфер (красивая архитектура!)
     if (input_consume_released(PSP_CTRL_CROSS) || !input_held(PSP_CTRL_CROSS)) {
-        release_direction(player, MOVE_UP);
+        input &= (MoveMask)~MOVE_UP;
     }
 
-    // Обновление физики игрока; тик 30 мс задается в main.c.
-    player_update(player);
-
-    // Обработка смерти игрока (как в Java BounceCanvas.java:569-580)
-    if (player->ballState == BALL_STATE_DEAD) {
-        // ВАЖНО: нестандартная логика жизней (как в оригинале Java Bounce):
-        // numLives: 3→2→1→0→(-1). Game Over при < 0, т.к. при 0 еще остается последняя попытка
-        // Это означает: 3 жизни = 4 попытки игры (3 обычные + 1 последняя при numLives=0)
-        if (g_game.numLives < 0) {
-            // Game Over - обновить рекорды и показать Game Over экран (как в оригинале BounceCanvas:440)
-            save_update_records(g_game.selected_level, g_game.score);
-            g_game.saved_game_state = SAVED_GAME_NONE;
-            g_game.state = STATE_GAME_OVER;
-        } else {
-            // Респаун - сохраняем ТЕКУЩИЙ размер мяча (основная цель этой задачи!)
-            BallSizeState currentSize = player->sizeState;  // СОХРАНЯЕМ размер
-
-            // Получаем координаты респауна (чекпоинта)
-            int respawnX, respawnY;
-            level_get_respawn(&respawnX, &respawnY);
-
-            // Респаун в точке чекпоинта с сохранённым размером (как в оригинале)
-            int respawnHalf = (currentSize == SMALL_SIZE_STATE) ? HALF_NORMAL_SIZE : HALF_ENLARGED_SIZE;
-            player_init(player, respawnX * TILE_SIZE + respawnHalf, respawnY * TILE_SIZE + respawnHalf, currentSize);
-
-            // Сброс камеры к игроку
-            game_reset_camera();
-
-            // После респауна удержание кнопок не должно считаться новым вводом
-            input_reset_edges();
-            input_lock_held();
-        }
+    // Физика, смерть/респаун, движущиеся объекты и дверь (game_logic.c)
+    if (game_tick(&g_sim, input)) {
+        // После респауна удержание кнопок не должно считаться новым вводом
+        input_reset_edges();
+        input_lock_held();
     }
-
-    // Обновление движущихся объектов
-    level_update_moving_objects();
-
-    // Как в оригинале: после сбора всех колец дверь ждет,
-    // пока не попадет в видимую область, и только затем открывается.
-    if (g_game.numRings == g_level.totalRings) {
-        game_exit_arm();
+    game_play_events();
+    if (g_sim.state != STATE_GAME) {
+        game_finish_level();
+    } else {
+        // Изменения за тик - в журнал перемотки
+        rewind_record(&s_rewind, &g_sim);
     }
 
-    int cameraX, cameraY;
-    game_calculate_camera(&cameraX, &cameraY);
-    game_exit_update(cameraX, cameraY);
-
     // L+R = переключить читерское бессмертие (как mInvincible в Java)
     if (input_consume_pressed(PSP_CTRL_LTRIGGER) && input_held(PSP_CTRL_RTRIGGER)) {
-        g_game.invincible_cheat = !g_game.invincible_cheat;
+        g_sim.invincible = !g_sim.invincible;
         // Звук активации чита (как в оригинале mSoundHoop.play(1))
         sound_play_hoop();
     }
@@ -358,11 +217,11 @@ static void render_menu_common(void) {
 static void render_game(void) {
     graphics_clear(BACKGROUND_COLOUR);
 
-    Player* player = &g_game.player;
+    Player* player = &g_sim.player;
 
     int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
     int cameraX, cameraY;
-    game_calculate_camera(&cameraX, &cameraY);
+    game_calculate_camera(&g_sim, &cameraX, &cameraY);
 
     // Рендерим уровень (исключая область HUD)
     level_set_ring_fg_defer(1);
@@ -462,9 +321,9 @@ static void render_game(void) {
     // Полоска бонуса (БЕЗ текстур - примитивы)
     // Вычисляем максимальный счетчик бонуса (как bonusCntrValue в Java)
     int max_bonus = 0;
-    if (g_game.player.speedBonusCntr > max_bonus) max_bonus = g_game.player.speedBonusCntr;
-    if (g_game.player.gravBonusCntr > max_bonus) max_bonus = g_game.player.gravBonusCntr;
-    if (g_game.player.jumpBonusCntr > max_bonus) max_bonus = g_game.player.jumpBonusCntr;
+    if (g_sim.player.speedBonusCntr > max_bonus) max_bonus = g_sim.player.speedBonusCntr;
+    if (g_sim.player.gravBonusCntr > max_bonus) max_bonus = g_sim.player.gravBonusCntr;
+    if (g_sim.player.jumpBonusCntr > max_bonus) max_bonus = g_sim.player.jumpBonusCntr;
 
     // HUD иконки колец (как в оригинале BounceCanvas.java:340-342)
     // Используем tileset который уже получен выше для мяча
@@ -478,7 +337,7 @@ static void render_game(void) {
         sprite_rect_t ringSprite = png_create_sprite_rect(tileset, srcX, srcY, TILE_SIZE, TILE_SIZE);
 
         // Рисуем НЕсобранные кольца (mTotalNumRings - numRings)
-        int remainingRings = g_level.totalRings - g_game.numRings;
+        int remainingRings = g_sim.level.totalRings - g_sim.numRings;
         for (int i = 0; i < remainingRings; i++) {
             int x = 5 + i * (TILE_SIZE - 1);  // 5 + i * (mUIRing.getWidth() - 1)
             int y = hudStartY + 3;  // В синей области с отступом 2px сверху
@@ -494,8 +353,8 @@ static void render_game(void) {
         int ballSrcY = 1 * TILE_SIZE;
         sprite_rect_t lifeSprite = png_create_sprite_rect(tileset, ballSrcX, ballSrcY, TILE_SIZE, TILE_SIZE);
 
-        for (int i = 0; i < g_game.numLives; i++) {
-            int x = SCREEN_WIDTH - 5 - (g_game.numLives - i) * (TILE_SIZE - 1);
+        for (int i = 0; i < g_sim.numLives; i++) {
+            int x = SCREEN_WIDTH - 5 - (g_sim.numLives - i) * (TILE_SIZE - 1);
             int y = hudStartY + 4;
             png_draw_sprite(tileset, &lifeSprite, x, y, TILE_SIZE, TILE_SIZE);
         }
@@ -506,7 +365,7 @@ static void render_game(void) {
 
     // Форматирование и отображение счёта (как в BounceCanvas.java:346)
     char score_buffer[SCORE_DIGITS+1];
-    format_score_string(g_game.score, score_buffer);
+    format_score_string(g_sim.score, score_buffer);
 
     // Белый текст по центру HUD (как в оригинале y=100, цвет 16777214)
     int score_width = graphics_measure_text(score_buffer, 9);
@@ -572,136 +431,9 @@ void game_shutdown(void) {
     }
     
     menu_cleanup();
+    level_free(&g_sim.level);
     level_cleanup();
-}
-
-void game_add_score(int points) {
-    g_game.score += points;
-}
-
-void game_add_ring(void) {
-    game_add_score(RING_POINTS);    // 1. Добавить очки за кольцо
-    g_game.numRings++;      // 2. Увеличить счетчик колец
-    
-    // 3. Анимация двери запускается из game_ring_collected()
-}
-
-void game_set_respawn(int x, int y) {
-    level_deactivate_old_checkpoint();        // Деактивируем старый чекпоинт (7->8)
-    level_set_respawn(x, y);                  // Устанавливаем новые координаты
-    level_mark_checkpoint_active(x, y);       // Активируем новый чекпоинт
-    sound_play_pickup();                      // Звук активации чекпоинта
-}
-
-void game_add_extra_life(void) {
-    // Как в оригинале Ball.java:800-810
-    game_add_score(LIFE_POINTS);           // +очки за дополнительную жизнь
-    
-    if (g_game.numLives < 5) {      // максимум 5 жизней
-        g_game.numLives++;
-    }
-    sound_play_pickup();            // Звук получения дополнительной жизни
-}
-
-void game_complete_level(void) {
-    // Добавляем бонус за завершение уровня (как в BounceConst.java)
-    game_add_score(EXIT_POINTS);
-
-    // Обновить рекорды если нужно (как в оригинале BounceCanvas:179-185)
-    save_update_records(g_game.selected_level, g_game.score);
-
-    // Переход в экран завершения уровня (как в Java displayLevelComplete)
-    g_game.state = STATE_LEVEL_COMPLETE;
-}
-
-// Универсальная функция деактивации кольца (перенесена из physics.c)
-// Вспомогательная функция для сохранения флагов при установке нового ID
-static void set_id_preserving_flags(int tx, int ty, uint8_t newID) {
-    int currentTile = level_get_tile_at(tx, ty);
-    // Извлекаем флаги (биты 6-7) из текущего тайла, сбрасывая ID (биты 0-5)
-    // ~TILE_ID_MASK = ~0x3F = 0xC0 (биты 6-7)
-    uint8_t flags = currentTile & ~TILE_ID_MASK; // Сохраняем все флаги кроме ID
-    // Устанавливаем новый ID с сохранением старых флагов
-    level_set_id(tx, ty, newID | flags);
-}
-
-static void deactivate_ring_pair(int x, int y, uint8_t tileID) {
-    if (tileID >= tile_meta_count()) return;
-    const TileMeta* meta = &tile_meta_db()[tileID];
-    
-    if (tileID >= 13 && tileID <= 14) {
-        // Маленькие вертикальные кольца (ID=13-14)
-        if (meta->orientation == ORIENT_VERT_TOP) {
-            // Верхняя часть вертикального кольца (ID=13)
-            set_id_preserving_flags(x, y, tileID + 4);     // верх → неактивный (13→17)
-            set_id_preserving_flags(x, y + 1, tileID + 5); // низ → неактивный (13→18)
-        } else if (meta->orientation == ORIENT_VERT_BOTTOM) {
-            // Нижняя часть вертикального кольца (ID=14)
-            set_id_preserving_flags(x, y, tileID + 4);     // низ → неактивный (14→18)
-            set_id_preserving_flags(x, y - 1, tileID + 3); // верх → неактивный (14→17)
-        }
-    } else if (tileID >= 21 && tileID <= 22) {
-        // Большие вертикальные кольца (ID=21-22) - логика как для 13-14
-        if (tileID == 21) {
-            // Верхняя часть большого вертикального кольца (ID=21)
-            set_id_preserving_flags(x, y, 25);     // верх → неактивный (21→25)
-            set_id_preserving_flags(x, y + 1, 26); // низ → неактивный (21→26)
-        } else if (tileID == 22) {
-            // Нижняя часть большого вертикального кольца (ID=22)
-            set_id_preserving_flags(x, y, 26);     // низ → неактивный (22→26)
-            set_id_preserving_flags(x, y - 1, 25); // верх → неактивный (22→25)
-        }
-    } else if (tileID >= 23 && tileID <= 24) {
-        // Большие горизонтальные кольца (ID=23-24) - логика как для 15-16
-        if (tileID == 23) {
-            // Левая часть большого горизонтального кольца (ID=23)
-            set_id_preserving_flags(x, y, 27);     // левая часть → неактивная левая (23→27)
-            set_id_preserving_flags(x + 1, y, 28); // правая часть → неактивная правая (23→28)
-        } else if (tileID == 24) {
-            // Правая часть большого горизонтального кольца (ID=24)
-            set_id_preserving_flags(x, y, 28);     // правая часть → неактивная правая (24→28)
-            set_id_preserving_flags(x - 1, y, 27); // левая часть → неактивная левая (24→27)
-        }
-    } else if (meta->orientation == ORIENT_HORIZ_LEFT) {
-        // Маленькие горизонтальные кольца - левая часть (ID=15)
-        set_id_preserving_flags(x, y, 19);     // левая часть → неактивная левая (19)
-        set_id_preserving_flags(x + 1, y, 20); // правая часть → неактивная правая (20)
-    } else if (meta->orientation == ORIENT_HORIZ_RIGHT) {
-        // Маленькие горизонтальные кольца - правая часть (ID=16)  
-        set_id_preserving_flags(x, y, 20);     // правая часть → неактивная правая (20)
-        set_id_preserving_flags(x - 1, y, 19); // левая часть → неактивная левая (19)
-    }
-}
-
-// Новая функция для обработки события сбора кольца
-void game_ring_collected(int tileX, int tileY, uint8_t tileID) {
-    // 1. Деактивируем кольцо на карте
-    deactivate_ring_pair(tileX, tileY, tileID);
-    
-    // 2. Добавляем очки и обновляем счетчик
-    game_add_ring();
-    
-    // 3. Воспроизводим звук кольца (up.ott)
-    sound_play_hoop();
-    
-}
-
-// === АНИМАЦИЯ ДВЕРИ ===
-
-// Сброс анимации двери при загрузке уровня
-void game_exit_reset(void) {
-    s_exit.state = EXIT_CLOSED;
-    s_exit.animation_offset = 0;
-}
-
-// Получить текущее смещение анимации двери для рендера
-int game_exit_anim_offset(void) {
-    return s_exit.animation_offset;
-}
-
-// Проверить, завершена ли анимация открытия двери
-bool game_exit_is_open(void) {
-    return s_exit.state == EXIT_OPEN;
+    level_render_cleanup();
 }
 
 // Проверить, можно ли продолжить сохраненную игру
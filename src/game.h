@@ -2,10 +2,15 @@
 #define GAME_H
 
 #include "types.h"
+#include "sim.h"
+
+// HUD размеры
+#define HUD_HEIGHT 17               // Высота HUD: 2+12+2px синяя полоса + 1px разделитель
 
 void game_init(void);
 void game_shutdown(void);
-void game_reset_camera(void);
+void game_reset_camera(SimContext* sim);
+void game_calculate_camera(SimContext* sim, int* outCameraX, int* outCameraY);
 
 typedef enum {
     GAME_START_FRESH = 0,
@@ -13,7 +18,31 @@ typedef enum {
     GAME_START_NEXT = 2
 } game_start_mode_t;
 
-void game_start_level(int level_number, game_start_mode_t mode);
+// Загрузить уровень в контекст и поставить мяч на старт (sim->state = STATE_GAME).
+// Возвращает false, если файл уровня не удалось прочитать.
+bool game_start_level(SimContext* sim, int level_number, game_start_mode_t mode);
+
+// Запуск уровня из интерфейса (game.c): game_start_level(&g_sim, ...)
+// плюс состояние экрана, выбранный уровень и флаги сохраненной игры.
+void game_enter_level(int level_number, game_start_mode_t mode);
+
+// Один фиксированный тик игрового процесса (30 мс): применяет маску направлений,
+// обновляет физику, обрабатывает смерть/респаун, движущиеся объекты и дверь.
+// Не читает ввод и не рисует, поэтому доступен и в хостовой сборке ядра.
+// Итог уровня пишется в sim->state (STATE_LEVEL_COMPLETE / STATE_GAME_OVER).
+// Возвращает true, если на этом тике мяч был респавнен.
+bool game_tick(SimContext* sim, MoveMask input);
+
+// Части game_tick() вокруг player_update() (их же вызывает пакетный шаг sim_batch.c):
+// маска направлений тика, респаун или Game Over умершего мяча (true - респаун)
+// и камера с дверью выхода.
+void game_apply_input(Player* player, MoveMask input);
+bool game_resolve_death(SimContext* sim);
+void game_update_exit(SimContext* sim);
+
+// Записывать ввод каждого тика в recorder (NULL - отключить).
+// game_start_level() начинает в нём новую запись (см. replay.h).
+void game_attach_recorder(SimContext* sim, struct replay_s* recorder);
 
 typedef enum {
     GAME_TICK_VARIABLE = 0,
@@ -31,13 +60,14 @@ void game_state_update(void);
 void game_state_render(void);
 
 // Анимация двери
-void game_exit_reset(void);
-int game_exit_anim_offset(void);
-bool game_exit_is_open(void);
+void game_exit_reset(SimContext* sim);
+int game_exit_anim_offset(const SimContext* sim);
+bool game_exit_is_open(const SimContext* sim);
 
 // Проверка состояния сохраненной игры
 bool game_can_continue(void);
 
 extern Game g_game;
+extern SimContext g_sim;   // Контекст симуляции игры на PSP (game.c)
 
 #endif
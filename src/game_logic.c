@@ -0,0 +1,374 @@
+// game_logic.c - Игровые правила и фиксированный тик симуляции (без рендера и ввода)
+// Модуль входит в ядро симуляции вместе с physics.c и level.c и собирается без PSPSDK.
+// Всё изменяемое состояние живет в SimContext (sim.h), глобальных переменных нет.
+#include "game.h"
+#include "sim.h"
+#include "types.h"
+#include "level.h"
+#include "tile_table.h"
+#include "replay.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Camera - система отслеживания игрока с мертвой зоной
+#define CAMERA_UNINITIALIZED -999
+#define CAMERA_DEADZONE_PERCENT 30   // 30% от игровой области - зона без движения камеры
+
+// Проверка является ли уровень маленьким (ниже игровой области по высоте)
+// Такие уровни центрируются по вертикали без мертвой зоны камеры
+static inline bool is_level_small(const Level* level) {
+    int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
+    return (level->height * TILE_SIZE) < gameAreaHeight;
+}
+
+// Получить смещение камеры для вертикального центрирования маленького уровня
+// Возвращает отрицательное значение для центрирования уровня в игровой области
+static inline int get_center_offset(const Level* level) {
+    int levelPixelHeight = level->height * TILE_SIZE;
+    int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
+    return -(gameAreaHeight - levelPixelHeight) / 2;
+}
+
+// Единственный расчет камеры для игровой логики и рендера.
+void game_calculate_camera(SimContext* sim, int* outCameraX, int* outCameraY) {
+    const Player* player = &sim->player;
+    const Level* level = &sim->level;
+    int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
+    int cameraX = player->xPos - SCREEN_WIDTH / 2;
+
+    if (sim->cameraY == CAMERA_UNINITIALIZED) {
+        sim->cameraY = player->yPos - gameAreaHeight / 2;
+    }
+
+    int deadZoneTop = (gameAreaHeight * CAMERA_DEADZONE_PERCENT) / 100;
+    int deadZoneBottom = gameAreaHeight - deadZoneTop;
+
+    if (!is_level_small(level)) {
+        int playerScreenY = player->yPos - sim->cameraY;
+        if (playerScreenY < deadZoneTop) {
+            sim->cameraY = player->yPos - deadZoneTop;
+        } else if (playerScreenY > deadZoneBottom) {
+            sim->cameraY = player->yPos - deadZoneBottom;
+        }
+    }
+
+    int cameraY = sim->cameraY;
+    int maxCameraX = level->width * TILE_SIZE - SCREEN_WIDTH;
+    int maxCameraY = level->height * TILE_SIZE - gameAreaHeight;
+
+    if (cameraX < 0) cameraX = 0;
+    if (cameraX > maxCameraX && maxCameraX > 0) cameraX = maxCameraX;
+
+    if (is_level_small(level)) {
+        cameraY = get_center_offset(level);
+    } else {
+        if (cameraY < 0) cameraY = 0;
+        if (cameraY > maxCameraY && maxCameraY > 0) cameraY = maxCameraY;
+    }
+
+    *outCameraX = cameraX;
+    *outCameraY = cameraY;
+}
+
+static bool game_exit_is_visible(const Level* level, int cameraX, int cameraY) {
+    const int exitX = level->exitPosX * TILE_SIZE;
+    const int exitY = level->exitPosY * TILE_SIZE;
+    const int exitSize = 2 * TILE_SIZE;
+    const int gameAreaHeight = SCREEN_HEIGHT - HUD_HEIGHT;
+
+    return exitX < cameraX + SCREEN_WIDTH &&
+           exitX + exitSize > cameraX &&
+           exitY < cameraY + gameAreaHeight &&
+           exitY + exitSize > cameraY;
+}
+
+static void game_exit_arm(ExitController* exit) {
+    if (exit->state == EXIT_CLOSED) {
+        exit->state = EXIT_WAITING_VISIBLE;
+    }
+}
+
+static void game_exit_update(SimContext* sim, int cameraX, int cameraY) {
+    ExitController* exit = &sim->exit;
+    const bool isVisible = game_exit_is_visible(&sim->level, cameraX, cameraY);
+
+    if (exit->state == EXIT_WAITING_VISIBLE && isVisible) {
+        exit->state = EXIT_OPENING;
+    }
+
+    // Оригинал делает первый шаг openExit() в тот же тик,
+    // в котором дверь стала видима, и приостанавливает анимацию
+    // если дверь снова ушла за границы видимой области.
+    if (exit->state == EXIT_OPENING && isVisible) {
+        exit->animation_offset += 4;
+        if (exit->animation_offset >= 24) {
+            exit->animation_offset = 24;
+            exit->state = EXIT_OPEN;
+        }
+    }
+}
+
+void game_reset_camera(SimContext* sim) {
+    if (is_level_small(&sim->level)) {
+        sim->cameraY = get_center_offset(&sim->level);
+    } else {
+        sim->cameraY = CAMERA_UNINITIALIZED; // Будет инициализирована позицией игрока
+    }
+}
+
+bool game_start_level(SimContext* sim, int level_number, game_start_mode_t mode) {
+    Level* level = &sim->level;
+    bool loaded = level_load_by_number(level, level_number) != 0;
+
+    sim->state = STATE_GAME;
+    sim->levelNumber = level_number;
+    sim_events_clear(sim);
+    if (loaded) {
+        game_reset_camera(sim);
+    }
+
+    // Устанавливаем респавн в стартовую позицию (как в Java: mBall.setRespawn())
+    sim->respawnX = level->startTileX;
+    sim->respawnY = level->startTileY;
+
+    if (mode == GAME_START_FRESH || mode == GAME_START_SELECTED) {
+        // Сброс счётчиков при старте уровня (как в Java BounceCanvas.startLevel)
+        sim->numRings = 0;
+        sim->score = 0;
+        sim->numLives = 3;
+    } else if (mode == GAME_START_NEXT) {
+        // При переходе на следующий уровень сохраняем счет/жизни
+        sim->numRings = 0;
+    }
+
+    // Дверь всегда должна начинать уровень закрытой
+    game_exit_reset(sim);
+
+    player_init(sim, level->startPosX, level->startPosY,
+                level->ballSize == BALL_SIZE_SMALL ? SMALL_SIZE_STATE : LARGE_SIZE_STATE);
+
+    if (sim->recorder) {
+        replay_begin(sim->recorder, level_number, mode, sim->score, sim->numLives);
+    }
+    return loaded;
+}
+
+void game_attach_recorder(SimContext* sim, replay_t* recorder) {
+    sim->recorder = recorder;
+}
+
+// Применить маску направлений тика к игроку (те же set/release, что и при вводе)
+void game_apply_input(Player* player, MoveMask input) {
+    static const MoveDirection dirs[] = { MOVE_LEFT, MOVE_RIGHT, MOVE_UP };
+    for (size_t i = 0; i < sizeof(dirs) / sizeof(dirs[0]); i++) {
+        if (input & dirs[i]) {
+            set_direction(player, dirs[i]);
+        } else {
+            release_direction(player, dirs[i]);
+        }
+    }
+}
+
+// Обработка смерти игрока (как в Java BounceCanvas.java:569-580)
+bool game_resolve_death(SimContext* sim) {
+    Player* player = &sim->player;
+    if (player->ballState == BALL_STATE_DEAD) {
+        // ВАЖНО: нестандартная логика жизней (как в оригинале Java Bounce):
+        // numLives: 3→2→1→0→(-1). Game Over при < 0, т.к. при 0 еще остается последняя попытка
+        // Это означает: 3 жизни = 4 попытки игры (3 обычные + 1 последняя при numLives=0)
+        if (sim->numLives < 0) {
+            // Game Over; рекорды и экран Game Over обновляет вызывающий код (game.c)
+            sim->state = STATE_GAME_OVER;
+        } else {
+            // Респаун - сохраняем ТЕКУЩИЙ размер мяча (основная цель этой задачи!)
+            BallSizeState currentSize = player->sizeState;  // СОХРАНЯЕМ размер
+
+            // Респаун в точке чекпоинта с сохранённым размером (как в оригинале)
+            int respawnHalf = (currentSize == SMALL_SIZE_STATE) ? HALF_NORMAL_SIZE : HALF_ENLARGED_SIZE;
+            player_init(sim, sim->respawnX * TILE_SIZE + respawnHalf,
+                        sim->respawnY * TILE_SIZE + respawnHalf, currentSize);
+
+            // Сброс камеры к игроку
+            game_reset_camera(sim);
+
+            return true;
+        }
+    }
+    return false;
+}
+
+// Камера и дверь выхода после шага физики
+void game_update_exit(SimContext* sim) {
+    // Как в оригинале: после сбора всех колец дверь ждет,
+    // пока не попадет в видимую область, и только затем открывается.
+    if (sim->numRings == sim->level.totalRings) {
+        game_exit_arm(&sim->exit);
+    }
+
+    int cameraX, cameraY;
+    game_calculate_camera(sim, &cameraX, &cameraY);
+    game_exit_update(sim, cameraX, cameraY);
+}
+
+// Фиксированный тик игрового процесса (бывшая физическая часть update_game)
+bool game_tick(SimContext* sim, MoveMask input) {
+    Player* player = &sim->player;
+
+    // События прошлого тика платформа уже разобрала (или они ей не нужны)
+    sim_events_clear(sim);
+
+    if (sim->recorder) {
+        replay_record_tick(sim->recorder, (uint8_t)(input | (sim->invincible ? REPLAY_FLAG_INVINCIBLE : 0)));
+    }
+
+    game_apply_input(player, input);
+
+    // Обновление физики игрока; тик 30 мс задается вызывающим кодом.
+    player_update(sim);
+
+    bool respawned = game_resolve_death(sim);
+
+    // Обновление движущихся объектов
+    level_update_moving_objects(&sim->level);
+
+    game_update_exit(sim);
+
+    // Хэш состояния после тика - для поиска первого расхождения при воспроизведении
+    if (sim->recorder) {
+        replay_record_hash(sim->recorder, sim_hash(sim));
+    }
+
+    return respawned;
+}
+
+void game_add_score(SimContext* sim, int points) {
+    sim->score += points;
+    sim_event_push(sim, SIM_EVENT_SCORE, 0, 0, points);
+}
+
+void game_add_ring(SimContext* sim) {
+    game_add_score(sim, RING_POINTS);    // 1. Добавить очки за кольцо
+    sim->numRings++;        // 2. Увеличить счетчик колец
+    
+    // 3. Анимация двери запускается из game_ring_collected()
+}
+
+void game_set_respawn(SimContext* sim, int x, int y) {
+    // Деактивируем старый чекпоинт перед установкой нового respawn
+    // (level_set_id сам пропускает координаты вне карты)
+    level_set_id(&sim->level, sim->respawnX, sim->respawnY, TILE_CHECKPOINT_ON);
+    sim->respawnX = x;                               // Устанавливаем новые координаты
+    sim->respawnY = y;
+    level_mark_checkpoint_active(&sim->level, x, y); // Активируем новый чекпоинт
+    sim_event_push(sim, SIM_EVENT_CHECKPOINT, x, y, 0); // Звук активации чекпоинта
+}
+
+void game_add_extra_life(SimContext* sim) {
+    // Как в оригинале Ball.java:800-810
+    game_add_score(sim, LIFE_POINTS);      // +очки за дополнительную жизнь
+    
+    if (sim->numLives < 5) {        // максимум 5 жизней
+        sim->numLives++;
+    }
+    sim_event_push(sim, SIM_EVENT_EXTRA_LIFE, 0, 0, 0); // Звук получения дополнительной жизни
+}
+
+void game_complete_level(SimContext* sim) {
+    // Добавляем бонус за завершение уровня (как в BounceConst.java)
+    game_add_score(sim, EXIT_POINTS);
+
+    // Переход в экран завершения уровня (как в Java displayLevelComplete);
+    // рекорды обновляет вызывающий код (game.c)
+    sim->state = STATE_LEVEL_COMPLETE;
+    sim_event_push(sim, SIM_EVENT_LEVEL_COMPLETE, 0, 0, 0);
+}
+
+// Универсальная функция деактивации кольца (перенесена из physics.c)
+// Вспомогательная функция для сохранения флагов при установке нового ID
+static void set_id_preserving_flags(Level* level, int tx, int ty, uint8_t newID) {
+    int currentTile = level_get_tile_at(level, tx, ty);
+    // Извлекаем флаги (биты 6-7) из текущего тайла, сбрасывая ID (биты 0-5)
+    // ~TILE_ID_MASK = ~0x3F = 0xC0 (биты 6-7)
+    uint8_t flags = currentTile & ~TILE_ID_MASK; // Сохраняем все флаги кроме ID
+    // Устанавливаем новый ID с сохранением старых флагов
+    level_set_id(level, tx, ty, newID | flags);
+}
+
+static void deactivate_ring_pair(Level* level, int x, int y, uint8_t tileID) {
+    if (tileID >= tile_meta_count()) return;
+    const TileMeta* meta = &tile_meta_db()[tileID];
+    
+    if (tileID >= 13 && tileID <= 14) {
+        // Маленькие вертикальные кольца (ID=13-14)
+        if (meta->orientation == ORIENT_VERT_TOP) {
+            // Верхняя часть вертикального кольца (ID=13)
+            set_id_preserving_flags(level, x, y, tileID + 4);     // верх → неактивный (13→17)
+            set_id_preserving_flags(level, x, y + 1, tileID + 5); // низ → неактивный (13→18)
+        } else if (meta->orientation == ORIENT_VERT_BOTTOM) {
+            // Нижняя часть вертикального кольца (ID=14)
+            set_id_preserving_flags(level, x, y, tileID + 4);     // низ → неактивный (14→18)
+            set_id_preserving_flags(level, x, y - 1, tileID + 3); // верх → неактивный (14→17)
+        }
+    } else if (tileID >= 21 && tileID <= 22) {
+        // Большие вертикальные кольца (ID=21-22) - логика как для 13-14
+        if (tileID == 21) {
+            // Верхняя часть большого вертикального кольца (ID=21)
+            set_id_preserving_flags(level, x, y, 25);     // верх → неактивный (21→25)
+            set_id_preserving_flags(level, x, y + 1, 26); // низ → неактивный (21→26)
+        } else if (tileID == 22) {
+            // Нижняя часть большого вертикального кольца (ID=22)
+            set_id_preserving_flags(level, x, y, 26);     // низ → неактивный (22→26)
+            set_id_preserving_flags(level, x, y - 1, 25); // верх → неактивный (22→25)
+        }
+    } else if (tileID >= 23 && tileID <= 24) {
+        // Большие горизонтальные кольца (ID=23-24) - логика как для 15-16
+        if (tileID == 23) {
+            // Левая часть большого горизонтального кольца (ID=23)
+            set_id_preserving_flags(level, x, y, 27);     // левая часть → неактивная левая (23→27)
+            set_id_preserving_flags(level, x + 1, y, 28); // правая часть → неактивная правая (23→28)
+        } else if (tileID == 24) {
+            // Правая часть большого горизонтального кольца (ID=24)
+            set_id_preserving_flags(level, x, y, 28);     // правая часть → неактивная правая (24→28)
+            set_id_preserving_flags(level, x - 1, y, 27); // левая часть → неактивная левая (24→27)
+        }
+    } else if (meta->orientation == ORIENT_HORIZ_LEFT) {
+        // Маленькие горизонтальные кольца - левая часть (ID=15)
+        set_id_preserving_flags(level, x, y, 19);     // левая часть → неактивная левая (19)
+        set_id_preserving_flags(level, x + 1, y, 20); // правая часть → неактивная правая (20)
+    } else if (meta->orientation == ORIENT_HORIZ_RIGHT) {
+        // Маленькие горизонтальные кольца - правая часть (ID=16)  
+        set_id_preserving_flags(level, x, y, 20);     // правая часть → неактивная правая (20)
+        set_id_preserving_flags(level, x - 1, y, 19); // левая часть → неактивная левая (19)
+    }
+}
+
+// Новая функция для обработки события сбора кольца
+void game_ring_collected(SimContext* sim, int tileX, int tileY, uint8_t tileID) {
+    // 1. Деактивируем кольцо на карте
+    deactivate_ring_pair(&sim->level, tileX, tileY, tileID);
+    
+    // 2. Добавляем очки и обновляем счетчик
+    game_add_ring(sim);
+    
+    // 3. Событие для звука кольца (up.ott)
+    sim_event_push(sim, SIM_EVENT_RING, tileX, tileY, tileID);
+    
+}
+
+// === АНИМАЦИЯ ДВЕРИ ===
+
+// Сброс анимации двери при загрузке уровня
+void game_exit_reset(SimContext* sim) {
+    sim->exit.state = EXIT_CLOSED;
+    sim->exit.animation_offset = 0;
+}
+
+// Получить текущее смещение анимации двери для рендера
+int game_exit_anim_offset(const SimContext* sim) {
+    return sim->exit.animation_offset;
+}
+
+// Проверить, завершена ли анимация открытия двери
+bool game_exit_is_open(const SimContext* sim) {
+    return sim->exit.state == EXIT_OPEN;
+}
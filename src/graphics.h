@@ -1,7 +1,7 @@
 #ifndef GRAPHICS_H
 #define GRAPHICS_H
 
-#include <psptypes.h>
+#include "platform.h"  // u32 (на PSP - из <psptypes.h>)
 #include "png.h"  // Для texture_t в batch функциях
 
 // PSP VRAM буферы должны иметь ширину кратную степени двойки для оптимизации
@@ -1,746 +1,622 @@
-// level.c - Парсер уровней + отрисовка с атласом PNG (с поддержкой трансформаций)
-#include "level.h"
-
-// Цвета фона тайлов определены в level.h (из Java BounceConst)
-#include "tile_table.h"
-#include "graphics.h"
-#include "game.h"  // Для анимации двери
-#include <string.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <stdbool.h>
-#include <stdint.h>
-#include <pspkernel.h>  // Для sceKernelDcacheWritebackRange
-
-// Статические переменные для респауна (как в оригинальном Java коде)
-static int s_respawn_x = 0, s_respawn_y = 0;
-
-typedef struct {
-    unsigned char* data;
-    int size;
-} level_cache_entry_t;
-
-static level_cache_entry_t s_level_cache[MAX_LEVEL + 1];
-static int s_level_cache_preloaded = 0;
-
-// Формат пути к файлам уровней
-#define LEVEL_PATH_FORMAT "levels/J2MElvl.%03d"
-
-// Параметры полосок EXIT тайла (двери)
-#define EXIT_STRIPE_1_X      0    // Первая полоска (фон)
-#define EXIT_STRIPE_1_WIDTH  24   // Ширина первой полоски (вся область)
-#define EXIT_STRIPE_2_X      4    // Голубая полоска
-#define EXIT_STRIPE_2_WIDTH  16   // Ширина голубой полоски
-#define EXIT_STRIPE_3_X      6    // Красная полоска
-#define EXIT_STRIPE_3_WIDTH  10   // Ширина красной полоски
-#define EXIT_STRIPE_4_X      10   // Четвертая полоска
-#define EXIT_STRIPE_4_WIDTH  4    // Ширина четвертой полоски
-
-// --- Текстуры/атлас (инкапсулированы через level_get_*) ---
-static texture_t* s_tileset = NULL;
-static int s_tiles_per_row = 0;
-
-
-// --- Dynamic sprite validation ---
-static inline int get_max_sprite_index(void) {
-    if (!s_tileset || s_tiles_per_row <= 0) return -1;
-    // actual_height используется вместо height, так как может быть больше из-за POT требований PSP
-    int tiles_per_col = s_tileset->actual_height / TILE_SIZE;
-    return s_tiles_per_row * tiles_per_col;
-}
-
-static inline bool is_sprite_valid(int sprite_idx) {
-    int max_idx = get_max_sprite_index();
-    return max_idx >= 0 && sprite_idx >= 0 && sprite_idx < max_idx;
-}
-
-// --- Ring foreground queue (draw after the ball) ---
-typedef struct { int sprite_idx; int x, y; int transform; } hoop_fg_item_t;
-static hoop_fg_item_t s_hoop_fg[RING_FG_QUEUE_MAX];
-static int s_hoop_fg_count = 0;
-static inline void hoop_fg_clear(void){ s_hoop_fg_count = 0; }
-
-static inline void hoop_fg_push(int sprite_idx, int x, int y, int transform){
-    if (s_hoop_fg_count < (int)(sizeof(s_hoop_fg)/sizeof(s_hoop_fg[0]))){
-        s_hoop_fg[s_hoop_fg_count++] = (hoop_fg_item_t){ sprite_idx, x, y, transform };
-    }
-}
-
-// Map TileTransform -> png_transform_t
-static inline png_transform_t map_tf_to_png(int tf){
-    switch (tf){
-        case TF_FLIP_X:  return PNG_TRANSFORM_FLIP_X;
-        case TF_FLIP_Y:  return PNG_TRANSFORM_FLIP_Y;
-        case TF_FLIP_XY: return PNG_TRANSFORM_ROT_180; // FLIP_X+FLIP_Y эквивалент 180°
-        case TF_ROT_90:  return PNG_TRANSFORM_ROT_90;
-        case TF_ROT_180: return PNG_TRANSFORM_ROT_180;
-        case TF_ROT_270: return PNG_TRANSFORM_ROT_270;
-        case TF_ROT_270_FLIP_X: return PNG_TRANSFORM_ROT_270_FLIP_X;
-        case TF_ROT_270_FLIP_Y: return PNG_TRANSFORM_ROT_270_FLIP_Y;
-
-        case TF_ROT_270_FLIP_XY: return PNG_TRANSFORM_ROT_270_FLIP_XY;
-        default:         return PNG_TRANSFORM_IDENTITY;
-    }
-}
-
-static void hoop_fg_flush(void){
-    if (!s_tileset || s_tiles_per_row <= 0) { s_hoop_fg_count = 0; return; }
-    for (int i = 0; i < s_hoop_fg_count; ++i){
-        int idx = s_hoop_fg[i].sprite_idx;
-        if (!is_sprite_valid(idx)) continue;
-        int col = idx % s_tiles_per_row;
-        int row = idx / s_tiles_per_row;
-        int srcX = col * TILE_SIZE;
-        int srcY = row * TILE_SIZE;
-        sprite_rect_t r = png_create_sprite_rect(s_tileset, srcX, srcY, TILE_SIZE, TILE_SIZE);
-        png_transform_t xf = map_tf_to_png(s_hoop_fg[i].transform); // alt_transform now used from queue
-        if (xf == PNG_TRANSFORM_IDENTITY){
-            png_draw_sprite(s_tileset, &r, (int)s_hoop_fg[i].x, (int)s_hoop_fg[i].y, TILE_SIZE, TILE_SIZE);
-        } else {
-            png_draw_sprite_transform(s_tileset, &r, (int)s_hoop_fg[i].x, (int)s_hoop_fg[i].y, TILE_SIZE, TILE_SIZE, xf);
-        }
-    }
-    s_hoop_fg_count = 0;
-}
-
-// Public control to get order: background -> ball -> ring foreground
-static int s_ring_fg_defer = 0;
-void level_set_ring_fg_defer(int on) { s_ring_fg_defer = on ? 1 : 0; }
-void level_flush_ring_foreground(void) { hoop_fg_flush(); }
-
-// Функции для инкапсуляции доступа к тайловому атласу
-texture_t* level_get_tileset(void) { return s_tileset; }
-int level_get_tiles_per_row(void) { return s_tiles_per_row; }
-
-
-Level g_level;
-
-// --- Текстуры/атлас (перенесены в начало файла) ---
-
-
-// --- Вспомогательное: единожды загрузить атлас ---
-static void level_load_tileset_once(void) {
-    if (s_tileset) return;
-    s_tileset = png_load_texture_vram(TILESET_PATH);
-    if (s_tileset && s_tileset->width > 0) {
-        s_tiles_per_row = s_tileset->actual_width / TILE_SIZE; // 12 px на тайл
-    } else {
-        s_tiles_per_row = 0;
-    }
-}
-
-static int level_read_file_to_buffer(const char* filename, unsigned char** out_data, int* out_size) {
-    FILE* file = util_open_file(filename, "rb");
-    if (!file) return 0;
-
-    if (fseek(file, 0, SEEK_END) != 0) {
-        fclose(file);
-        return 0;
-    }
-
-    long fileSize = ftell(file);
-    if (fileSize < 8 || fileSize > 0x7FFFFFFF) {
-        fclose(file);
-        return 0;
-    }
-
-    if (fseek(file, 0, SEEK_SET) != 0) {
-        fclose(file);
-        return 0;
-    }
-
-    unsigned char* buffer = (unsigned char*)malloc((size_t)fileSize);
-    if (!buffer) {
-        fclose(file);
-        return 0;
-    }
-
-    size_t bytesRead = fread(buffer, 1, (size_t)fileSize, file);
-    fclose(file);
-    if (bytesRead != (size_t)fileSize) {
-        free(buffer);
-        return 0;
-    }
-
-    *out_data = buffer;
-    *out_size = (int)fileSize;
-    return 1;
-}
-
-static int level_cache_load_one(int levelNumber) {
-    if (levelNumber < 1 || levelNumber > MAX_LEVEL) {
-        return 0;
-    }
-
-    if (s_level_cache[levelNumber].data && s_level_cache[levelNumber].size > 0) {
-        return 1;
-    }
-
-    char filename[256];
-    snprintf(filename, sizeof(filename), LEVEL_PATH_FORMAT, levelNumber);
-
-    unsigned char* data = NULL;
-    int size = 0;
-    if (!level_read_file_to_buffer(filename, &data, &size)) {
-        return 0;
-    }
-
-    s_level_cache[levelNumber].data = data;
-    s_level_cache[levelNumber].size = size;
-    return 1;
-}
-
-static void level_cache_preload_all_once(void) {
-    if (s_level_cache_preloaded) {
-        return;
-    }
-
-    for (int level = 1; level <= MAX_LEVEL; ++level) {
-        (void)level_cache_load_one(level);
-    }
-
-    s_level_cache_preloaded = 1;
-}
-
-// --- Загрузка уровня из файла ---
-int level_load_from_file(const char* filename) {
-    unsigned char* buffer = NULL;
-    int fileSize = 0;
-    if (!level_read_file_to_buffer(filename, &buffer, &fileSize)) {
-        return 0;
-    }
-
-    int result = level_load_from_memory((const char*)buffer, fileSize);
-    free(buffer);
-    return result;
-}
-
-// --- Загрузка уровня по номеру ---
-int level_load_by_number(int levelNumber) {
-    level_load_tileset_once();
-    if (levelNumber < 1 || levelNumber > MAX_LEVEL) {
-        return 0;
-    }
-
-    level_cache_preload_all_once();
-
-    if (level_cache_load_one(levelNumber)) {
-        return level_load_from_memory((const char*)s_level_cache[levelNumber].data,
-                                      s_level_cache[levelNumber].size);
-    }
-
-    char filename[256];
-    snprintf(filename, sizeof(filename), LEVEL_PATH_FORMAT, levelNumber);
-    return level_load_from_file(filename);
-}
-
-// --- Парсер из памяти ---
-int level_load_from_memory(const char* levelData, int dataSize) {
-    if (!levelData || dataSize < 8) return 0;
-    memset(&g_level, 0, sizeof(Level));
-
-    const unsigned char* data = (const unsigned char*)levelData;
-    int offset = 0;
-
-    int startX_tiles   = data[offset++];
-    int startY_tiles   = data[offset++];
-    g_level.ballSize   = data[offset++];
-    g_level.exitPosX   = data[offset++];
-    g_level.exitPosY   = data[offset++];
-    g_level.totalRings = data[offset++];
-    g_level.width      = data[offset++];
-    g_level.height     = data[offset++];
-
-    if (g_level.width <= 0 || g_level.height <= 0 ||
-        g_level.width  > MAX_LEVEL_WIDTH || g_level.height > MAX_LEVEL_HEIGHT) {
-        return 0;
-    }
-
-    int mapBytes = g_level.width * g_level.height;
-    if (offset + mapBytes > dataSize) return 0;
-
-    int start_half = (g_level.ballSize == BALL_SIZE_SMALL) ? HALF_NORMAL_SIZE : HALF_ENLARGED_SIZE;
-    g_level.startPosX = startX_tiles * TILE_SIZE + start_half;
-    g_level.startPosY = startY_tiles * TILE_SIZE + start_half;
-    g_level.startTileX = startX_tiles;
-    g_level.startTileY = startY_tiles;
-
-    for (int y = 0; y < g_level.height; ++y) {
-        for (int x = 0; x < g_level.width; ++x) {
-            g_level.tileMap[y][x] = data[offset++];
-        }
-    }
-
-    // Загружаем движущиеся объекты (если есть)
-    g_level.numMovingObjects = 0;
-    if (dataSize - offset >= 1) {
-        int numMoveObj = data[offset++];
-        if (numMoveObj > 0 && numMoveObj <= MAX_MOVING_OBJECTS) {
-            // Проверяем, что хватает данных для всех объектов (каждый = 8 байт)
-            int requiredBytes = numMoveObj * 8;
-            if (dataSize - offset >= requiredBytes) {
-                g_level.numMovingObjects = numMoveObj;
-                
-                // Читаем данные каждого движущегося объекта
-                for (int i = 0; i < numMoveObj; ++i) {
-                    MovingObject* obj = &g_level.movingObjects[i];
-                    
-                    // Читаем topLeft, botRight, direction, startOffset
-                    obj->topLeft[0] = data[offset++];      // X
-                    obj->topLeft[1] = data[offset++];      // Y
-                    obj->botRight[0] = data[offset++];     // X  
-                    obj->botRight[1] = data[offset++];     // Y
-                    obj->direction[0] = (short)(signed char)data[offset++];    // X direction (знаковый int8_t -> short)
-                    obj->direction[1] = (short)(signed char)data[offset++];    // Y direction (знаковый int8_t -> short)  
-                    obj->offset[0] = data[offset++];       // Start X offset
-                    obj->offset[1] = data[offset++];       // Start Y offset
-                }
-            }
-        }
-    }
-
-    return 1;
-}
-
-
-// --- Доступ к тайлам ---
-int level_get_tile_at(int tileX, int tileY) {
-    if (tileX < 0 || tileX >= g_level.width || tileY < 0 || tileY >= g_level.height) {
-        return 1; // вне карты считаем стеной
-    }
-    return g_level.tileMap[tileY][tileX];
-}
-
-// --- Проверка коллизии с треугольной рампой ---
-
-// --- Новые функции рендеринга ---
-
-// Рендер EXIT тайла: фоновые полоски (plain pass)
-static void render_exit_tile_plain(int tile_id, int destX, int destY, int worldTileX, int worldTileY) {
-    if (tile_id == 9) { // EXIT - новая логика по якорю exitPos
-        int local_x = worldTileX - g_level.exitPosX;
-        int local_y = worldTileY - g_level.exitPosY;
-
-        if (local_x == 0 && local_y == 0) {
-            // Только левый верхний тайл рисует фон для всей области 2x2
-            u32 background = BACKGROUND_COLOUR;
-            u32 first_stripe = BACKGROUND_COLOUR;
-            u32 light_stripe = EXIT_LIGHT_STRIPE_COLOUR;
-            u32 dark_stripe = EXIT_DARK_STRIPE_COLOUR;
-            u32 fourth_stripe = EXIT_FOURTH_STRIPE_COLOUR;
-
-            int area_width = 2 * TILE_SIZE;
-            int area_height = 2 * TILE_SIZE;
-
-            graphics_draw_rect(destX, destY, area_width, area_height, background);
-            graphics_draw_rect(destX + EXIT_STRIPE_1_X, destY, EXIT_STRIPE_1_WIDTH, area_height, first_stripe);
-            graphics_draw_rect(destX + EXIT_STRIPE_2_X, destY, EXIT_STRIPE_2_WIDTH, area_height, light_stripe);
-            graphics_draw_rect(destX + EXIT_STRIPE_3_X, destY, EXIT_STRIPE_3_WIDTH, area_height, dark_stripe);
-            graphics_draw_rect(destX + EXIT_STRIPE_4_X, destY, EXIT_STRIPE_4_WIDTH, area_height, fourth_stripe);
-        }
-    } else if (tile_id == 10) {
-        graphics_draw_rect(destX, destY, TILE_SIZE, TILE_SIZE, WATER_COLOUR);
-    } else {
-        graphics_draw_rect(destX, destY, TILE_SIZE, TILE_SIZE, 0xFF888888);
-    }
-}
-
-// Рендер EXIT тайла: спрайты двери (textured pass)
-static void render_exit_tile_textured(int tile_id, int destX, int destY, int worldTileX, int worldTileY) {
-    if (tile_id != 9) return;
-
-    int local_x = worldTileX - g_level.exitPosX;
-    int local_y = worldTileY - g_level.exitPosY;
-
-    if (local_x != 0 || local_y != 0) return;
-    if ((uint32_t)tile_id >= tile_meta_count()) return;
-    if (!s_tileset || s_tiles_per_row <= 0) return;
-
-    const TileMeta* t = &tile_meta_db()[tile_id];
-    const int col = t->sprite_index % s_tiles_per_row;
-    const int row = t->sprite_index / s_tiles_per_row;
-
-    int srcX = col * TILE_SIZE;
-    int srcY = row * TILE_SIZE;
-    sprite_rect_t r = png_create_sprite_rect(s_tileset, srcX, srcY, TILE_SIZE, TILE_SIZE);
-
-    int animationOffset = game_exit_anim_offset();
-    int doorX = destX;
-    int doorY = destY - animationOffset;
-    int areaTop = destY;
-
-    if (doorY < areaTop) {
-        int clipOffset = areaTop - doorY;
-        if (clipOffset < TILE_SIZE) {
-            int visibleHeight = TILE_SIZE - clipOffset;
-            sprite_rect_t clipped_r = png_create_sprite_rect(s_tileset, srcX, srcY + clipOffset, TILE_SIZE, visibleHeight);
-
-            png_draw_sprite(s_tileset, &clipped_r, doorX, areaTop, TILE_SIZE, visibleHeight);
-            png_draw_sprite_transform(s_tileset, &clipped_r, doorX + TILE_SIZE, areaTop, TILE_SIZE, visibleHeight, PNG_TRANSFORM_FLIP_X);
-
-            if (doorY + TILE_SIZE >= areaTop) {
-                png_draw_sprite_transform(s_tileset, &r, doorX, doorY + TILE_SIZE, TILE_SIZE, TILE_SIZE, PNG_TRANSFORM_FLIP_Y);
-                png_draw_sprite_transform(s_tileset, &r, doorX + TILE_SIZE, doorY + TILE_SIZE, TILE_SIZE, TILE_SIZE, PNG_TRANSFORM_ROT_180);
-            }
-        }
-    } else {
-        png_draw_sprite(s_tileset, &r, doorX, doorY, TILE_SIZE, TILE_SIZE);
-        png_draw_sprite_transform(s_tileset, &r, doorX + TILE_SIZE, doorY, TILE_SIZE, TILE_SIZE, PNG_TRANSFORM_FLIP_X);
-        png_draw_sprite_transform(s_tileset, &r, doorX, doorY + TILE_SIZE, TILE_SIZE, TILE_SIZE, PNG_TRANSFORM_FLIP_Y);
-        png_draw_sprite_transform(s_tileset, &r, doorX + TILE_SIZE, doorY + TILE_SIZE, TILE_SIZE, TILE_SIZE, PNG_TRANSFORM_ROT_180);
-    }
-}
-
-// Рендер движущихся шипов: фон тайла (plain pass)
-static void render_moving_spikes_tile_plain(int tileX, int tileY, int destX, int destY) {
-    unsigned int tile = (unsigned short)g_level.tileMap[tileY][tileX];
-    bool is_water = (tile & TILE_FLAG_WATER) ? true : false;
-    u32 bg_color = is_water ? WATER_COLOUR : BACKGROUND_COLOUR;
-    graphics_draw_rect(destX, destY, TILE_SIZE, TILE_SIZE, bg_color);
-}
-
-// Рендер движущихся шипов: спрайты (textured pass)
-static void render_moving_spikes_tile_textured(int tileX, int tileY, int destX, int destY) {
-    int objIndex = level_find_moving_object_at(tileX, tileY);
-    if (objIndex == -1) return;
-    if (!s_tileset || s_tiles_per_row <= 0) return;
-    if (10 >= tile_meta_count()) return;
-
-    MovingObject* obj = &g_level.movingObjects[objIndex];
-    int relTileX = tileX - obj->topLeft[0];
-    int relTileY = tileY - obj->topLeft[1];
-
-    int offsetX = obj->offset[0] - (relTileX * TILE_SIZE);
-    int offsetY = obj->offset[1] - (relTileY * TILE_SIZE);
-
-    if (offsetX > -3 * TILE_SIZE && offsetX < TILE_SIZE && offsetY > -3 * TILE_SIZE && offsetY < TILE_SIZE) {
-        const TileMeta* t = &tile_meta_db()[10];
-        int col = t->sprite_index % s_tiles_per_row;
-        int row = t->sprite_index / s_tiles_per_row;
-
-        for (int dy = 0; dy < 2; dy++) {
-            for (int dx = 0; dx < 2; dx++) {
-                int spriteX = destX + offsetX + (dx * TILE_SIZE);
-                int spriteY = destY + offsetY + (dy * TILE_SIZE);
-
-                if (spriteX < destX + TILE_SIZE && spriteX + TILE_SIZE > destX &&
-                    spriteY < destY + TILE_SIZE && spriteY + TILE_SIZE > destY) {
-
-                    int srcX = col * TILE_SIZE;
-                    int srcY = row * TILE_SIZE;
-                    sprite_rect_t r = png_create_sprite_rect(s_tileset, srcX, srcY, TILE_SIZE, TILE_SIZE);
-
-                    png_transform_t xf = PNG_TRANSFORM_IDENTITY;
-                    if (dx == 1 && dy == 0) xf = PNG_TRANSFORM_FLIP_X;
-                    if (dx == 0 && dy == 1) xf = PNG_TRANSFORM_FLIP_Y;
-                    if (dx == 1 && dy == 1) xf = PNG_TRANSFORM_ROT_180;
-
-                    png_draw_sprite_transform(s_tileset, &r, spriteX, spriteY, TILE_SIZE, TILE_SIZE, xf);
-                }
-            }
-        }
-    }
-}
-
-// REMOVED: render_dual_sprite_tile - was deprecated and unused
-
-// Рендер кольца-обруча: фон тайла (plain pass)
-static void render_hoop_tile_plain(int destX, int destY, int flags) {
-    u32 bg_color = (flags & TILE_FLAG_WATER) ? WATER_COLOUR : BACKGROUND_COLOUR;
-    graphics_draw_rect(destX, destY, TILE_SIZE, TILE_SIZE, bg_color);
-}
-
-// Рендер кольца-обруча: спрайты и очередь foreground (textured pass)
-static void render_hoop_tile_textured(const TileMeta* t, int destX, int destY, int tileID) {
-    if (!s_tileset || s_tiles_per_row <= 0) return;
-    if (tileID < 13 || tileID > 28 || !is_sprite_valid(t->sprite_index)) return;
-
-    int col = t->sprite_index % s_tiles_per_row;
-    int row = t->sprite_index / s_tiles_per_row;
-    int srcX = col * TILE_SIZE;
-    int srcY = row * TILE_SIZE;
-
-    sprite_rect_t r = png_create_sprite_rect(s_tileset, srcX, srcY, TILE_SIZE, TILE_SIZE);
-
-    TileTransform bg_transform = (t->orientation == ORIENT_VERT_TOP) ? TF_ROT_270_FLIP_X :
-                                (t->orientation == ORIENT_VERT_BOTTOM) ? TF_ROT_270_FLIP_XY :
-                                (t->orientation == ORIENT_HORIZ_LEFT) ? TF_FLIP_Y :
-                                (t->orientation == ORIENT_HORIZ_RIGHT) ? TF_FLIP_XY : TF_NONE;
-    png_transform_t xf = map_tf_to_png(bg_transform);
-
-    png_draw_sprite_transform(s_tileset, &r, (int)destX, (int)destY, TILE_SIZE, TILE_SIZE, xf);
-
-    TileTransform fg_transform = (t->orientation == ORIENT_VERT_TOP) ? TF_ROT_270 :
-                                (t->orientation == ORIENT_VERT_BOTTOM) ? TF_ROT_270_FLIP_Y :
-                                (t->orientation == ORIENT_HORIZ_RIGHT) ? TF_FLIP_X : TF_NONE;
-    hoop_fg_push(t->sprite_index, destX, destY, fg_transform);
-}
-
-// --- Рендер видимой области (ОБНОВЛЕНО) ---
-// ВАЖНО: После вызова функция оставляет произвольное текстурное состояние.
-// Состояние текстур управляется централизованно через graphics.c
-void level_render_visible_area(int cameraX, int cameraY, int screenWidth, int screenHeight) {
-    
-    hoop_fg_clear();
-    if (g_level.width <= 0 || g_level.height <= 0) return;
-
-    int startTileX = cameraX / TILE_SIZE;
-    int endTileX   = (cameraX + screenWidth  - 1) / TILE_SIZE;
-    int startTileY = cameraY / TILE_SIZE;
-    int endTileY   = (cameraY + screenHeight - 1) / TILE_SIZE;
-
-    if (startTileX < 0) startTileX = 0;
-    if (startTileY < 0) startTileY = 0;
-    if (endTileX >= g_level.width)   endTileX = g_level.width - 1;
-    if (endTileY >= g_level.height)  endTileY = g_level.height - 1;
-
-    // Pass 1: plain фон (минимизируем переключения режима)
-    graphics_begin_plain();
-
-    for (int y = startTileY; y <= endTileY; ++y) {
-        for (int x = startTileX; x <= endTileX; ++x) {
-            unsigned int tile = (unsigned short)g_level.tileMap[y][x];
-            bool is_water = (tile & TILE_FLAG_WATER) ? true : false;
-            int original_tile_flags = tile & TILE_FLAGS_MASK;
-
-            if (is_water) {
-                tile = tile & ~TILE_FLAG_WATER;
-            }
-
-            int tile_id = tile & TILE_ID_MASK;
-            int tile_flags = original_tile_flags;
-
-            int screenX = x * TILE_SIZE - cameraX;
-            int screenY = y * TILE_SIZE - cameraY;
-
-            if (tile_id == 0) {
-                u32 bg_color = is_water ? WATER_COLOUR : BACKGROUND_COLOUR;
-                graphics_draw_rect(screenX, screenY, TILE_SIZE, TILE_SIZE, bg_color);
-                continue;
-            }
-
-            if (tile_id < 0 || tile_id >= (int)tile_meta_count()) continue;
-
-            if (!s_tileset || s_tiles_per_row <= 0) {
-                graphics_draw_rect(screenX, screenY, TILE_SIZE, TILE_SIZE, 0xFF444444);
-                continue;
-            }
-
-            const TileMeta* t = &tile_meta_db()[tile_id];
-
-            if (tile_id == 9) {
-                if (is_water) {
-                    graphics_draw_rect(screenX, screenY, TILE_SIZE, TILE_SIZE, WATER_COLOUR);
-                }
-                render_exit_tile_plain(tile_id, screenX, screenY, x, y);
-                continue;
-            } else if (tile_id == 10) {
-                render_moving_spikes_tile_plain(x, y, screenX, screenY);
-                continue;
-            } else if (t->render_type & RENDER_COMPOSITE) {
-                if (is_water) {
-                    graphics_draw_rect(screenX, screenY, TILE_SIZE, TILE_SIZE, WATER_COLOUR);
-                }
-                render_exit_tile_plain(tile_id, screenX, screenY, x, y);
-                continue;
-            } else if (t->render_type & RENDER_HOOP) {
-                render_hoop_tile_plain(screenX, screenY, tile_flags);
-                continue;
-            }
-
-            if (is_water) {
-                graphics_draw_rect(screenX, screenY, TILE_SIZE, TILE_SIZE, WATER_COLOUR);
-            }
-
-            if (!is_sprite_valid(t->sprite_index)) {
-                graphics_draw_rect(screenX, screenY, TILE_SIZE, TILE_SIZE, 0xFF444444);
-            }
-        }
-    }
-
-    // Pass 2: текстуры (спрайты)
-    graphics_begin_textured();
-
-    for (int y = startTileY; y <= endTileY; ++y) {
-        for (int x = startTileX; x <= endTileX; ++x) {
-            unsigned int tile = (unsigned short)g_level.tileMap[y][x];
-            bool is_water = (tile & TILE_FLAG_WATER) ? true : false;
-
-            if (is_water) {
-                tile = tile & ~TILE_FLAG_WATER;
-            }
-
-            int tile_id = tile & TILE_ID_MASK;
-
-            if (tile_id == 0) continue;
-            if (tile_id < 0 || tile_id >= (int)tile_meta_count()) continue;
-            if (!s_tileset || s_tiles_per_row <= 0) continue;
-
-            const TileMeta* t = &tile_meta_db()[tile_id];
-
-            int screenX = x * TILE_SIZE - cameraX;
-            int screenY = y * TILE_SIZE - cameraY;
-
-            if (tile_id == 9) {
-                render_exit_tile_textured(tile_id, screenX, screenY, x, y);
-                continue;
-            } else if (tile_id == 10) {
-                render_moving_spikes_tile_textured(x, y, screenX, screenY);
-                continue;
-            } else if (t->render_type & RENDER_COMPOSITE) {
-                render_exit_tile_textured(tile_id, screenX, screenY, x, y);
-                continue;
-            } else if (t->render_type & RENDER_HOOP) {
-                render_hoop_tile_textured(t, screenX, screenY, tile_id);
-                continue;
-            }
-
-            if (is_sprite_valid(t->sprite_index)) {
-                int col = t->sprite_index % s_tiles_per_row;
-                int row = t->sprite_index / s_tiles_per_row;
-                int srcX = col * TILE_SIZE;
-                int srcY = row * TILE_SIZE;
-
-                png_transform_t xf = map_tf_to_png(t->transform);
-                sprite_rect_t r = png_create_sprite_rect(s_tileset, srcX, srcY, TILE_SIZE, TILE_SIZE);
-                if (xf == PNG_TRANSFORM_IDENTITY) {
-                    png_draw_sprite(s_tileset, &r, (int)screenX, (int)screenY, TILE_SIZE, TILE_SIZE);
-                } else {
-                    png_draw_sprite_transform(s_tileset, &r, (int)screenX, (int)screenY, TILE_SIZE, TILE_SIZE, xf);
-                }
-            }
-        }
-    }
-    if (!s_ring_fg_defer) hoop_fg_flush();
-}
-
-// --- Функции для движущихся объектов ---
-
-// Обновление позиций движущихся объектов (логика из Java updateMovingSpikeObj)
-// ПРИМЕЧАНИЕ: Делитель 30 FPS теперь управляется из game.c
-void level_update_moving_objects(void) {
-    
-    for (int i = 0; i < g_level.numMovingObjects; ++i) {
-        MovingObject* obj = &g_level.movingObjects[i];
-        
-        // Обновляем X offset
-        obj->offset[0] += obj->direction[0];
-        
-        // Вычисляем границы движения (в пикселях)
-        int maxOffsetX = (obj->botRight[0] - obj->topLeft[0] - 2) * TILE_SIZE;
-        int maxOffsetY = (obj->botRight[1] - obj->topLeft[1] - 2) * TILE_SIZE;
-        
-        // Проверяем границы по X и отражаем направление при достижении
-        if (obj->offset[0] <= 0) {
-            obj->offset[0] = 0;
-            obj->direction[0] = -obj->direction[0];
-        } else if (obj->offset[0] >= maxOffsetX) {
-            obj->offset[0] = (short)maxOffsetX;
-            obj->direction[0] = -obj->direction[0];
-        }
-        
-        // Обновляем Y offset  
-        obj->offset[1] += obj->direction[1];
-        
-        // Проверяем границы по Y и отражаем направление при достижении
-        if (obj->offset[1] <= 0) {
-            obj->offset[1] = 0;
-            obj->direction[1] = -obj->direction[1];
-        } else if (obj->offset[1] >= maxOffsetY) {
-            obj->offset[1] = (short)maxOffsetY;
-            obj->direction[1] = -obj->direction[1];
-        }
-    }
-}
-
-// Поиск движущегося объекта в данном тайле (аналог findSpikeIndex)
-int level_find_moving_object_at(int tileX, int tileY) {
-    for (int i = 0; i < g_level.numMovingObjects; ++i) {
-        MovingObject* obj = &g_level.movingObjects[i];
-        
-        // Проверяем, входит ли тайл в область движущегося объекта
-        if (obj->topLeft[0] <= tileX && obj->botRight[0] > tileX &&
-            obj->topLeft[1] <= tileY && obj->botRight[1] > tileY) {
-            return i;
-        }
-    }
-    return -1;  // Не найдено
-}
-
-MovingObject* level_get_moving_object(int index) {
-    if (index >= 0 && index < g_level.numMovingObjects) {
-        return &g_level.movingObjects[index];
-    }
-    return NULL;
-}
-
-// ============================================================================
-// ОПЕРАЦИИ С ТАЙЛАМИ КАРТЫ (для событийной системы)
-// ============================================================================
-
-// Временно удаляем - переместим в начало файла
-
-// Получить ID тайла (без флагов)
-uint8_t level_get_id(int tx, int ty) {
-    if (tx < 0 || tx >= g_level.width || ty < 0 || ty >= g_level.height) {
-        return 0; // За пределами карты - пустой тайл
-    }
-    return (uint8_t)(g_level.tileMap[ty][tx] & TILE_ID_MASK);
-}
-
-// Установить ID тайла (сохраняя флаги)
-void level_set_id(int tx, int ty, uint8_t id) {
-    if (tx >= 0 && tx < g_level.width && ty >= 0 && ty < g_level.height) {
-        short old_tile = g_level.tileMap[ty][tx];
-        short flags = old_tile & ~TILE_ID_MASK;  // Сохраняем все флаги
-        g_level.tileMap[ty][tx] = flags | (id & TILE_ID_MASK);  // Объединяем с новым ID
-    }
-}
-
-
-// Деактивировать старый чекпоинт перед установкой нового respawn.
-void level_deactivate_old_checkpoint(void) {
-    if (s_respawn_x >= 0 && s_respawn_x < g_level.width && s_respawn_y >= 0 && s_respawn_y < g_level.height) {
-        level_set_id(s_respawn_x, s_respawn_y, TILE_CHECKPOINT_ON);
+// level.c - Парсер оригинальных уровней Bounce + runtime-операции с тайлами
+// Рендер уровня вынесен в level_render.c, чтобы этот модуль собирался без PSPSDK.
+#include "level.h"
+#include "tile_table.h"
+#include "zobrist.h"
+#include "solid_bitmap.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Кэш файлов уровней общий для всех контекстов симуляции: заполняется при
+// первом level_load_by_number() и дальше только читается.
+typedef struct {
+    unsigned char* data;
+    int size;
+} level_cache_entry_t;
+
+static level_cache_entry_t s_level_cache[MAX_LEVEL + 1];
+static int s_level_cache_preloaded = 0;
+
+// Формат пути к файлам уровней
+#define LEVEL_PATH_FORMAT "levels/J2MElvl.%03d"
+
+static int level_read_file_to_buffer(const char* filename, unsigned char** out_data, int* out_size) {
+    FILE* file = util_open_file(filename, "rb");
+    if (!file) return 0;
+
+    if (fseek(file, 0, SEEK_END) != 0) {
+        fclose(file);
+        return 0;
     }
+
+    long fileSize = ftell(file);
+    if (fileSize < 8 || fileSize > 0x7FFFFFFF) {
+        fclose(file);
+        return 0;
+    }
+
+    if (fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return 0;
+    }
+
+    unsigned char* buffer = (unsigned char*)malloc((size_t)fileSize);
+    if (!buffer) {
+        fclose(file);
+        return 0;
+    }
+
+    size_t bytesRead = fread(buffer, 1, (size_t)fileSize, file);
+    fclose(file);
+    if (bytesRead != (size_t)fileSize) {
+        free(buffer);
+        return 0;
+    }
+
+    *out_data = buffer;
+    *out_size = (int)fileSize;
+    return 1;
+}
+
+static int level_cache_load_one(int levelNumber) {
+    if (levelNumber < 1 || levelNumber > MAX_LEVEL) {
+        return 0;
+    }
+
+    if (s_level_cache[levelNumber].data && s_level_cache[levelNumber].size > 0) {
+        return 1;
+    }
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), LEVEL_PATH_FORMAT, levelNumber);
+
+    unsigned char* data = NULL;
+    int size = 0;
+    if (!level_read_file_to_buffer(filename, &data, &size)) {
+        return 0;
+    }
+
+    s_level_cache[levelNumber].data = data;
+    s_level_cache[levelNumber].size = size;
+    return 1;
+}
+
+static void level_cache_preload_all_once(void) {
+    if (s_level_cache_preloaded) {
+        return;
+    }
+
+    for (int level = 1; level <= MAX_LEVEL; ++level) {
+        (void)level_cache_load_one(level);
+    }
+
+    s_level_cache_preloaded = 1;
+}
+
+// Тайлы, которые игра может заменить через level_set_id(): кристалл чекпоинта
+// и активный чекпоинт, кольца (активные и неактивные половины), доп. жизнь
+static bool level_tile_is_mutable(int tileID) {
+    return tileID == TILE_CHECKPOINT || tileID == TILE_CHECKPOINT_ON ||
+           (tileID >= 13 && tileID <= 28) || tileID == TILE_EXTRA_LIFE;
+}
+
+_Static_assert(MAX_MOVING_OBJECTS < 256, "Level::movingObjectAt stores object index + 1 in uint8_t");
+
+// XOR ключей всех движущихся объектов (Level::movingHash) с нуля
+static uint64_t level_moving_hash(const Level* level) {
+    uint64_t hash = 0;
+    for (int i = 0; i < level->numMovingObjects; ++i) {
+        const MovingObject* obj = &level->movingObjects[i];
+        hash ^= zobrist_moving_key(i, obj->offset, obj->direction);
+    }
+    return hash;
+}
+
+// Сетка Level::movingObjectAt. При пересечении областей ячейка остается за объектом
+// с меньшим индексом - как при линейном поиске в порядке объектов.
+static void level_build_moving_object_index(Level* level) {
+    memset(level->movingObjectAt, 0, (size_t)level->width * (size_t)level->height);
+    for (int i = 0; i < level->numMovingObjects; ++i) {
+        const MovingObject* obj = &level->movingObjects[i];
+        int x0 = obj->topLeft[0] < 0 ? 0 : obj->topLeft[0];
+        int y0 = obj->topLeft[1] < 0 ? 0 : obj->topLeft[1];
+        int x1 = obj->botRight[0] > level->width ? level->width : obj->botRight[0];
+        int y1 = obj->botRight[1] > level->height ? level->height : obj->botRight[1];
+        for (int y = y0; y < y1; ++y) {
+            for (int x = x0; x < x1; ++x) {
+                if (level->movingObjectAt[y * level->stride + x] == 0) {
+                    level->movingObjectAt[y * level->stride + x] = (uint8_t)(i + 1);
+                }
+            }
+        }
+    }
+}
+
+// Одна строка прохода расстояния Чебышёва: row[x] не больше, чем у соседей
+// слева/справа в row (по направлению прохода) и трех соседей в prev, + 1.
+// Массивы с отступом в одну ячейку по краям (значение CLEARANCE_MAX).
+static void level_clearance_row(uint8_t* row, const uint8_t* prev, int width, int step) {
+    int x = (step > 0) ? 1 : width;
+    int last = row[x - step];
+    for (int i = 0; i < width; ++i, x += step) {
+        int n = (prev[x - 1] < prev[x]) ? prev[x - 1] : prev[x];
+        n = (prev[x + 1] < n) ? prev[x + 1] : n;
+        n = (last < n) ? last : n;
+        last = (row[x] < n + 1) ? row[x] : n + 1;
+        row[x] = (uint8_t)last;
+    }
+}
+
+// Поле Level::clearance: расстояния Чебышёва двумя проходами (вниз и вверх по
+// карте) по 8 соседям. Изменяемые ячейки (Level::mutableTiles) считаются особыми
+// при любом содержимом: поле не зависит от собранных колец и снимков.
+void level_build_clearance(Level* level) {
+    int w = level->width;
+    int cells = level->width * level->height;
+    for (int i = 0; i < cells; ++i) {
+        uint8_t cls = level->collisionClass[i];
+        bool isSolid = (cls == TILE_CLASS_BRICK || cls == TILE_CLASS_RUBBER);
+        uint8_t solid = isSolid ? CLEARANCE_MAX : 0;
+        uint8_t special = (isSolid || cls == TILE_CLASS_NONE) ? CLEARANCE_MAX : 0;
+        level->clearance[i] = (uint8_t)(solid | (special << 4));
+    }
+    for (int i = 0; i < level->numMutableTiles; ++i) {
+        level->clearance[level->mutableTiles[i]] &= 0x0F;
+    }
+
+    uint8_t solid[2][MAX_LEVEL_WIDTH + 2];
+    uint8_t special[2][MAX_LEVEL_WIDTH + 2];
+    for (int pass = 0; pass < 2; ++pass) {
+        int step = pass ? -1 : 1;
+        memset(solid, CLEARANCE_MAX, sizeof(solid));
+        memset(special, CLEARANCE_MAX, sizeof(special));
+        for (int i = 0; i < level->height; ++i) {
+            int y = pass ? level->height - 1 - i : i;
+            uint8_t* b = solid[i & 1];
+            uint8_t* s = special[i & 1];
+            uint8_t* row = &level->clearance[y * level->stride];
+            for (int x = 0; x < w; ++x) {
+                b[x + 1] = CLEARANCE_SOLID(row[x]);
+                s[x + 1] = CLEARANCE_SPECIAL(row[x]);
+            }
+            level_clearance_row(b, solid[(i + 1) & 1], w, step);
+            level_clearance_row(s, special[(i + 1) & 1], w, step);
+            for (int x = 0; x < w; ++x) {
+                row[x] = (uint8_t)(b[x + 1] | (s[x + 1] << 4));
+            }
+        }
+    }
+    level->clearanceReady = true;
+}
+
+_Static_assert(MAX_LEVEL_WIDTH * MAX_LEVEL_HEIGHT <= 65536, "Level::mutableTiles stores cell indices in uint16_t");
+
+// Список изменяемых ячеек для sim_snapshot() (в порядке обхода карты)
+static void level_build_mutable_tiles(Level* level) {
+    int count = 0;
+    for (int y = 0; y < level->height; ++y) {
+        for (int x = 0; x < level->width; ++x) {
+            bool isStart = (x == level->startTileX && y == level->startTileY);
+            if (!isStart && !level_tile_is_mutable(level_tile(level, x, y) & TILE_ID_MASK)) {
+                continue;
+            }
+            if (count == MAX_MUTABLE_TILES) {
+                level->numMutableTiles = -1;
+                return;
+            }
+            level->mutableTiles[count++] = (uint16_t)(y * level->stride + x);
+        }
+    }
+    level->numMutableTiles = count;
+}
+
+// Байтовые сетки в начале блока (tiles, collisionClass, movingObjectAt, clearance)
+#define LEVEL_GRID_COUNT 4
+
+static size_t level_grid_bytes(int width, int height) {
+    return (size_t)width * (size_t)height * LEVEL_GRID_COUNT;
+}
+
+// Смещение таблицы строк пиксельной карты: за сетками, с выравниванием под указатель
+static size_t level_rows_offset(int width, int height) {
+    size_t align = sizeof(uint32_t*);
+    return (level_grid_bytes(width, height) + align - 1) / align * align;
+}
+
+// Блок сеток на width x height ячеек и таблицы строк пиксельной карты на height
+// строк, указатели в нем. Таблица пуста: строки карты строятся заново.
+// Блок прежнего уровня остается, если его хватает.
+static bool level_alloc_grids(Level* level, int width, int height) {
+    size_t cells = (size_t)width * (size_t)height;
+    size_t size = level_rows_offset(width, height) + (size_t)height * sizeof(uint32_t*);
+    if (size > level->gridCapacity) {
+        uint8_t* block = (uint8_t*)malloc(size);
+        if (!block) return false;
+        free(level->tiles);
+        level->tiles = block;
+        level->gridCapacity = size;
+    }
+    level->stride = width;
+    level->collisionClass = level->tiles + cells;
+    level->movingObjectAt = level->collisionClass + cells;
+    level->clearance = level->movingObjectAt + cells;
+    level->solidRows = (uint32_t**)(void*)(level->tiles + level_rows_offset(width, height));
+    memset(level->solidRows, 0, (size_t)height * sizeof(uint32_t*));
+    return true;
+}
+
+bool level_copy(Level* dst, const Level* src) {
+    uint8_t* block = dst->tiles;
+    size_t capacity = dst->gridCapacity;
+    solid_bitmap_free(dst);
+    *dst = *src;
+    dst->tiles = block;
+    dst->gridCapacity = capacity;
+    dst->solidRows = NULL;  // Таблицу строк дает блок dst (level_alloc_grids)
+    if (!src->tiles) {
+        level_free(dst);  // Уровень не загружен: сеток нет
+        return true;
+    }
+    if (!level_alloc_grids(dst, src->width, src->height)) {
+        level_free(dst);
+        return false;
+    }
+    // Строки пиксельной карты не копируются: копия построит свои по мере надобности
+    memcpy(dst->tiles, src->tiles, level_grid_bytes(src->width, src->height));
+    return true;
+}
+
+void level_free(Level* level) {
+    solid_bitmap_free(level);
+    free(level->tiles);
+    level->tiles = NULL;
+    level->collisionClass = NULL;
+    level->movingObjectAt = NULL;
+    level->clearance = NULL;
+    level->solidRows = NULL;
+    level->gridCapacity = 0;
+    level->stride = 0;
+    level->width = 0;
+    level->height = 0;
+}
+
+// --- Загрузка уровня из файла ---
+int level_load_from_file(Level* level, const char* filename) {
+    unsigned char* buffer = NULL;
+    int fileSize = 0;
+    if (!level_read_file_to_buffer(filename, &buffer, &fileSize)) {
+        return 0;
+    }
+
+    int result = level_load_from_memory(level, (const char*)buffer, fileSize);
+    free(buffer);
+    return result;
+}
+
+// --- Загрузка уровня по номеру ---
+int level_load_by_number(Level* level, int levelNumber) {
+    if (levelNumber < 1 || levelNumber > MAX_LEVEL) {
+        return 0;
+    }
+
+    level_cache_preload_all_once();
+
+    if (level_cache_load_one(levelNumber)) {
+        return level_load_from_memory(level, (const char*)s_level_cache[levelNumber].data,
+                                      s_level_cache[levelNumber].size);
+    }
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), LEVEL_PATH_FORMAT, levelNumber);
+    return level_load_from_file(level, filename);
+}
+
+// --- Парсер из памяти ---
+int level_load_from_memory(Level* level, const char* levelData, int dataSize) {
+    if (!levelData || dataSize < 8) return 0;
+    // Сетки карты заполняются ниже: очищаются только поля до них. Строки
+    // пиксельной карты прежнего уровня освобождаются, карта нового строится заново.
+    solid_bitmap_free(level);
+    memset(level, 0, offsetof(Level, stride));
+
+    const unsigned char* data = (const unsigned char*)levelData;
+    int offset = 0;
+
+    int startX_tiles   = data[offset++];
+    int startY_tiles   = data[offset++];
+    level->ballSize   = data[offset++];
+    level->exitPosX   = data[offset++];
+    level->exitPosY   = data[offset++];
+    level->totalRings = data[offset++];
+    int width         = data[offset++];
+    int height        = data[offset++];
+
+    if (width <= 0 || height <= 0 || width > MAX_LEVEL_WIDTH || height > MAX_LEVEL_HEIGHT) {
+        return 0;
+    }
+
+    int mapBytes = width * height;
+    if (offset + mapBytes > dataSize) return 0;
+    if (!level_alloc_grids(level, width, height)) return 0;
+    level->width = width;
+    level->height = height;
+
+    int start_half = (level->ballSize == BALL_SIZE_SMALL) ? HALF_NORMAL_SIZE : HALF_ENLARGED_SIZE;
+    level->startPosX = startX_tiles * TILE_SIZE + start_half;
+    level->startPosY = startY_tiles * TILE_SIZE + start_half;
+    level->startTileX = startX_tiles;
+    level->startTileY = startY_tiles;
+
+    memcpy(level->tiles, data + offset, (size_t)mapBytes);
+    offset += mapBytes;
+    for (int i = 0; i < mapBytes; ++i) {
+        level->collisionClass[i] = tile_collision_class(level->tiles[i] & TILE_ID_MASK);
+    }
+
+    // Загружаем движущиеся объекты (если есть)
+    level->numMovingObjects = 0;
+    if (dataSize - offset >= 1) {
+        int numMoveObj = data[offset++];
+        if (numMoveObj > 0 && numMoveObj <= MAX_MOVING_OBJECTS) {
+            // Проверяем, что хватает данных для всех объектов (каждый = 8 байт)
+            int requiredBytes = numMoveObj * 8;
+            if (dataSize - offset >= requiredBytes) {
+                level->numMovingObjects = numMoveObj;
+                
+                // Читаем данные каждого движущегося объекта
+                for (int i = 0; i < numMoveObj; ++i) {
+                    MovingObject* obj = &level->movingObjects[i];
+                    
+                    // Читаем topLeft, botRight, direction, startOffset
+                    obj->topLeft[0] = data[offset++];      // X
+                    obj->topLeft[1] = data[offset++];      // Y
+                    obj->botRight[0] = data[offset++];     // X  
+                    obj->botRight[1] = data[offset++];     // Y
+                    obj->direction[0] = (short)(signed char)data[offset++];    // X direction (знаковый int8_t -> short)
+                    obj->direction[1] = (short)(signed char)data[offset++];    // Y direction (знаковый int8_t -> short)  
+                    obj->offset[0] = data[offset++];       // Start X offset
+                    obj->offset[1] = data[offset++];       // Start Y offset
+                    level->movingObjectsStart[i] = *obj;
+                }
+            }
+        }
+    }
+
+    level_build_mutable_tiles(level);
+    level_build_moving_object_index(level);
+    solid_bitmap_init(level);
+    level->hash = level_compute_hash(level);
+    level->movingHash = level_moving_hash(level);
+    return 1;
+}
+
+
+// --- Доступ к тайлам ---
+int level_get_tile_at(const Level* level, int tileX, int tileY) {
+    if (tileX < 0 || tileX >= level->width || tileY < 0 || tileY >= level->height) {
+        return 1; // вне карты считаем стеной
+    }
+    return level_tile(level, tileX, tileY);
+}
+
+uint64_t level_compute_hash(const Level* level) {
+    uint64_t hash = 0;
+    for (int y = 0; y < level->height; ++y) {
+        for (int x = 0; x < level->width; ++x) {
+            hash ^= zobrist_tile_key(x, y, level_tile(level, x, y));
+        }
+    }
+    return hash;
+}
+
+
+// --- Функции для движущихся объектов ---
+
+// Обновление позиций движущихся объектов (логика из Java updateMovingSpikeObj)
+// ПРИМЕЧАНИЕ: Делитель 30 FPS теперь управляется из game.c
+void level_update_moving_objects(Level* level) {
+    
+    for (int i = 0; i < level->numMovingObjects; ++i) {
+        MovingObject* obj = &level->movingObjects[i];
+        uint64_t oldKey = zobrist_moving_key(i, obj->offset, obj->direction);
+        
+        // Обновляем X offset
+        obj->offset[0] += obj->direction[0];
+        
+        // Вычисляем границы движения (в пикселях)
+        int maxOffsetX = (obj->botRight[0] - obj->topLeft[0] - 2) * TILE_SIZE;
+        int maxOffsetY = (obj->botRight[1] - obj->topLeft[1] - 2) * TILE_SIZE;
+        
+        // Проверяем границы по X и отражаем направление при достижении
+        if (obj->offset[0] <= 0) {
+            obj->offset[0] = 0;
+            obj->direction[0] = -obj->direction[0];
+        } else if (obj->offset[0] >= maxOffsetX) {
+            obj->offset[0] = (short)maxOffsetX;
+            obj->direction[0] = -obj->direction[0];
+        }
+        
+        // Обновляем Y offset  
+        obj->offset[1] += obj->direction[1];
+        
+        // Проверяем границы по Y и отражаем направление при достижении
+        if (obj->offset[1] <= 0) {
+            obj->offset[1] = 0;
+            obj->direction[1] = -obj->direction[1];
+        } else if (obj->offset[1] >= maxOffsetY) {
+            obj->offset[1] = (short)maxOffsetY;
+            obj->direction[1] = -obj->direction[1];
+        }
+        level->movingHash ^= oldKey ^ zobrist_moving_key(i, obj->offset, obj->direction);
+    }
+    level->movingTick++;
+}
+
+// Один шаг оси - та же логика, что в level_update_moving_objects()
+static void moving_axis_step(int* offset, int* dir, int maxOffset) {
+    *offset += *dir;
+    if (*offset <= 0) {
+        *offset = 0;
+        *dir = -*dir;
+    } else if (*offset >= maxOffset) {
+        *offset = maxOffset;
+        *dir = -*dir;
+    }
+}
+
+// Ось через ticks шагов. После первого шага смещение лежит в [0, max], и при
+// скорости s > 0 движение периодично с периодом 2K, K = ceil(max / s):
+// фаза 0 - (0, +s), фазы 1..K-1 - (p*s, +s), фаза K - (max, -s),
+// фазы K+1..2K-1 - (max - (p-K)*s, -s). До первого упора - прямая.
+static void moving_axis_at_tick(int offset, int dir, int maxOffset, uint32_t ticks,
+                                short* outOffset, short* outDir) {
+    if (ticks > 0) {
+        moving_axis_step(&offset, &dir, maxOffset);
+        ticks--;
+    }
+    int speed = abs(dir);
+    if (speed == 0 || maxOffset <= 0) {
+        // Вырожденные случаи: неподвижный объект или область не шире шипов.
+        // Смещение уже в {0, max}: не больше трех шагов до цикла из двух состояний
+        // (или неподвижной точки), дальше важна только четность.
+        if (ticks > 4) {
+            ticks = 3 + ((ticks - 3) & 1u);
+        }
+        for (; ticks > 0; ticks--) {
+            moving_axis_step(&offset, &dir, maxOffset);
+        }
+        *outOffset = (short)offset;
+        *outDir = (short)dir;
+        return;
+    }
+
+    uint32_t k = (uint32_t)((maxOffset + speed - 1) / speed);
+    uint32_t phase;
+    if (dir > 0) {
+        uint32_t toEdge = offset >= maxOffset ? 1 : (uint32_t)((maxOffset - offset + speed - 1) / speed);
+        if (ticks < toEdge) {
+            *outOffset = (short)(offset + (int)ticks * speed);
+            *outDir = (short)dir;
+            return;
+        }
+        ticks -= toEdge;
+        phase = k;
+    } else {
+        uint32_t toEdge = offset <= 0 ? 1 : (uint32_t)((offset + speed - 1) / speed);
+        if (ticks < toEdge) {
+            *outOffset = (short)(offset - (int)ticks * speed);
+            *outDir = (short)dir;
+            return;
+        }
+        ticks -= toEdge;
+        phase = 0;
+    }
+
+    phase = (uint32_t)(((uint64_t)phase + ticks) % (2 * (uint64_t)k));
+    if (phase < k) {
+        *outOffset = (short)((int)phase * speed);
+        *outDir = (short)speed;
+    } else {
+        *outOffset = (short)(phase == k ? maxOffset : maxOffset - (int)(phase - k) * speed);
+        *outDir = (short)-speed;
+    }
+}
+
+void level_moving_object_at_tick(const MovingObject* start, uint32_t tick, MovingObject* out) {
+    *out = *start;
+    int maxOffsetX = (start->botRight[0] - start->topLeft[0] - 2) * TILE_SIZE;
+    int maxOffsetY = (start->botRight[1] - start->topLeft[1] - 2) * TILE_SIZE;
+    moving_axis_at_tick(start->offset[0], start->direction[0], maxOffsetX, tick,
+                        &out->offset[0], &out->direction[0]);
+    moving_axis_at_tick(start->offset[1], start->direction[1], maxOffsetY, tick,
+                        &out->offset[1], &out->direction[1]);
+}
+
+void level_seek_moving_objects(Level* level, uint32_t tick) {
+    for (int i = 0; i < level->numMovingObjects; ++i) {
+        level_moving_object_at_tick(&level->movingObjectsStart[i], tick, &level->movingObjects[i]);
+    }
+    level->movingTick = tick;
+    level->movingHash = level_moving_hash(level);
+}
+
+// Поиск движущегося объекта в данном тайле (аналог findSpikeIndex): одна выборка
+// из сетки, построенной при загрузке, вместо перебора всех объектов
+int level_find_moving_object_at(const Level* level, int tileX, int tileY) {
+    if (tileX < 0 || tileX >= level->width || tileY < 0 || tileY >= level->height) {
+        return -1;
+    }
+    return (int)level->movingObjectAt[tileY * level->stride + tileX] - 1;  // -1 - не найдено
+}
+
+MovingObject* level_get_moving_object(Level* level, int index) {
+    if (index >= 0 && index < level->numMovingObjects) {
+        return &level->movingObjects[index];
+    }
+    return NULL;
+}
+
+// ============================================================================
+// ОПЕРАЦИИ С ТАЙЛАМИ КАРТЫ (для событийной системы)
+// ============================================================================
+
+// Временно удаляем - переместим в начало файла
+
+// Получить ID тайла (без флагов)
+uint8_t level_get_id(const Level* level, int tx, int ty) {
+    if (tx < 0 || tx >= level->width || ty < 0 || ty >= level->height) {
+        return 0; // За пределами карты - пустой тайл
+    }
+    return (uint8_t)(level_tile(level, tx, ty) & TILE_ID_MASK);
+}
+
+// Установить ID тайла (сохраняя флаги)
+void level_set_id(Level* level, int tx, int ty, uint8_t id) {
+    if (tx >= 0 && tx < level->width && ty >= 0 && ty < level->height) {
+        int cell = ty * level->stride + tx;
+        uint8_t* tile = &level->tiles[cell];
+        uint8_t old_tile = *tile;
+        uint8_t flags = old_tile & ~TILE_ID_MASK;  // Сохраняем все флаги
+        *tile = (uint8_t)(flags | (id & TILE_ID_MASK));  // Объединяем с новым ID
+        level->hash ^= zobrist_tile_key(tx, ty, old_tile) ^ zobrist_tile_key(tx, ty, *tile);
+        uint8_t oldClass = level->collisionClass[cell];
+        level->collisionClass[cell] = tile_collision_class(id & TILE_ID_MASK);
+        solid_bitmap_update_tile(level, tx, ty);
+        level->tileWindow.valid = false;
+        // Игра меняет только ячейки, уже учтенные в Level::clearance как особые;
+        // другие изменения карты сбрасывают поле до следующего построения
+        uint8_t newClass = level->collisionClass[cell];
+        bool oldSolid = (oldClass == TILE_CLASS_BRICK || oldClass == TILE_CLASS_RUBBER);
+        bool newSolid = (newClass == TILE_CLASS_BRICK || newClass == TILE_CLASS_RUBBER);
+        if (level->clearanceReady &&
+            (oldSolid != newSolid ||
+             (newClass != TILE_CLASS_NONE && !newSolid &&
+              CLEARANCE_SPECIAL(level->clearance[cell]) != 0))) {
+            level->clearanceReady = false;
+        }
+    }
+}
+
+
+// Активировать чекпоинт ((id&0x7F)|0x88) - соответствует Java: tileMap[paramInt1][paramInt2] = 136
+void level_mark_checkpoint_active(Level* level, int tx, int ty) {
+    if (tx >= 0 && tx < level->width && ty >= 0 && ty < level->height) {
+        uint8_t id = level_get_id(level, tx, ty);
+        id = TILE_CHECKPOINT_ON; // Просто 8, без dirty бита (ТЕСТ)
+        level_set_id(level, tx, ty, id);
+    }
+}
+
+// --- Cleanup function for resource deallocation ---
+void level_cleanup(void) {
+    for (int level = 1; level <= MAX_LEVEL; ++level) {
+        free(s_level_cache[level].data);
+        s_level_cache[level].data = NULL;
+        s_level_cache[level].size = 0;
+    }
+    s_level_cache_preloaded = 0;
 }
-
-// Активировать чекпоинт ((id&0x7F)|0x88) - соответствует Java: tileMap[paramInt1][paramInt2] = 136
-void level_mark_checkpoint_active(int tx, int ty) {
-    if (tx >= 0 && tx < g_level.width && ty >= 0 && ty < g_level.height) {
-        uint8_t id = level_get_id(tx, ty);
-        id = TILE_CHECKPOINT_ON; // Просто 8, без dirty бита (ТЕСТ)
-        level_set_id(tx, ty, id);
-    }
-}
-
-// Установить новую точку респауна (соответствует Java: setRespawn)
-// ВАЖНО: Эта функция только сохраняет координаты. Управление визуальным состоянием
-// чекпоинтов (деактивация старого, активация нового) должно выполняться вызывающим кодом.
-// См. game_set_respawn() для полного алгоритма активации чекпоинта.
-void level_set_respawn(int tx, int ty) {
-    s_respawn_x = tx;
-    s_respawn_y = ty;
-}
-
-// Получить текущую позицию респауна
-void level_get_respawn(int* tx, int* ty) {
-    if (tx) *tx = s_respawn_x;
-    if (ty) *ty = s_respawn_y;
-}
-
-// --- Cleanup function for resource deallocation ---
-void level_cleanup(void) {
-    for (int level = 1; level <= MAX_LEVEL; ++level) {
-        free(s_level_cache[level].data);
-        s_level_cache[level].data = NULL;
-        s_level_cache[level].size = 0;
-    }
-    s_level_cache_preloaded = 0;
-
-    if (s_tileset) {
-        png_free_texture(s_tileset);
-        s_tileset = NULL;
-        s_tiles_per_row = 0;
-    }
-}
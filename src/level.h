@@ -1,132 +1,228 @@
-// level.h - Парсер оригинальных уровней Bounce
-#ifndef LEVEL_H
-#define LEVEL_H
-
-#include <psptypes.h>
-#include "tile_table.h"
-#include "png.h"  // Включаем png.h для полного определения texture_t
-#include "types.h" // Для Player структуры
-
-// Константы тайлов (из оригинального TileCanvas.java)
-
-/* --- Ring foreground control (for proper draw order) --- */
-#define RING_FG_QUEUE_MAX 128  // Максимальное количество колец для отложенного рендера (хватит для любого уровня)
-void level_set_ring_fg_defer(int on);
-void level_flush_ring_foreground(void);
-
-/* --- Tile flags and masks --- */
-// Структура байта тайла (8 бит):
-// 7   6   5-0
-// |   |   |---- ID тайла (0-63)
-// |   |-------- Водный флаг
-// |------------ Неиспользуемый бит
-#define TILE_FLAG_WATER    0x40  // Флаг водного тайла (как в Java) - бит 6
+// level.h - Парсер оригинальных уровней Bounce
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include "platform.h"
+#include "tile_table.h"
+#include "png.h"  // Включаем png.h для полного определения texture_t
+#include "types.h" // Для Player структуры
+
+// Константы тайлов (из оригинального TileCanvas.java)
+
+/* --- Ring foreground control (for proper draw order) --- */
+#define RING_FG_QUEUE_MAX 128  // Максимальное количество колец для отложенного рендера (хватит для любого уровня)
+void level_set_ring_fg_defer(int on);
+void level_flush_ring_foreground(void);
+
+/* --- Tile flags and masks --- */
+// Структура байта тайла (8 бит):
+// 7   6   5-0
+// |   |   |---- ID тайла (0-63)
+// |   |-------- Водный флаг
+// |------------ Неиспользуемый бит
+#define TILE_FLAG_WATER    0x40  // Флаг водного тайла (как в Java) - бит 6
 #define TILE_ID_MASK       (~TILE_FLAG_WATER & ~0x80)  // Убрать флаги бит 6,7 (как Java: tile & ~64 & ~128)
-#define TILE_FLAGS_MASK    0x40  // Только флаг воды, без TILE_FLAG_MISC
-
-/* ---------------------------------------------------------------------------
-   ФОРМУЛА КОНВЕРТАЦИИ Java → PSP цветов:
-   
-   1. Java десятичное → hex: 545706₁₀ = 0x085300 (24-бит RGB)
-   2. Извлечь каналы RGB: R=0x08, G=0x53, B=0xAA  
-   3. Переставить в ABGR: A=0xFF, B=Java_B, G=Java_G, R=Java_R
-   4. Результат PSP: 0xFFAA5308
-   
-   Примеры:
-   - Java: 545706 = 0x085300 → R=08,G=53,B=AA → PSP: 0xFFAA5308 (HUD)
-   - Java: 1073328 = 0x1060B0 → R=10,G=60,B=B0 → PSP: 0xFFB06010 (синий)
-   
-   Исключения (баги Java палитры):
-   - Java: 11591920 → PSP: 0xFFE3D3A2 (не по формуле, legacy значение)
---------------------------------------------------------------------------- */
-#define BACKGROUND_COLOUR     0xFFE3D3A2  // голубой
-#define WATER_COLOUR          0xFFB06010  // синий
-#define HUD_COLOUR            0xFFAA5308  // темно-синий HUD (Java 545706)
-#define ABOUT_BACKGROUND_COLOUR 0xFFFBFF6C  // Особый фон для About экрана
-
-// Exit door stripe colors (Java createExitImage)
-#define EXIT_LIGHT_STRIPE_COLOUR  0xFF9E9DFC  // Java 16555422 = 0xFC9D9E RGB → ABGR
-#define EXIT_DARK_STRIPE_COLOUR   0xFF3F3AE3  // Java 14891583 = 0xE33A3F RGB → ABGR
-#define EXIT_FOURTH_STRIPE_COLOUR 0xFF8E84C2  // Java 12747918 = 0xC2848E RGB → ABGR
-
-// Цвета для меню и текста
-#define COLOR_SELECTION_BG    0xFF2135FF  // Красно-фиолетовый фон выделения
-#define COLOR_TEXT_NORMAL     0xFF000000  // Черный обычный текст
-#define COLOR_WHITE_ABGR      0xFFFFFFFF  // Белый цвет
-#define COLOR_TEXT_SELECTED   0xFFFFFFFF  // Белый выделенный текст
-#define COLOR_TEXT_HELP       0xFF333333  // Темно-серый текст подсказки
-#define COLOR_DISABLED        0xFF808080  // Серый цвет для недоступных элементов
-#define COLOR_TEXT_HIGHLIGHT  0xFF800000  // Темно-красный цвет для выделения (новый рекорд)
-#define COLOR_BONUS_BAR       0xFF037FFF  // Оранжевый цвет полоски бонуса (Java: 16750611)
-#define COLOR_BONUS_FRAME     0xFFFFFFFF  // Белая рамка полоски бонуса
-
-/* --- Resource paths (following Java BounceConst pattern) --- */
-#define TILESET_PATH          "icons/objects_nm.png"  // Основной атлас тайлов
-
-// Кольца для сбора (13-28 в оригинале)
-
-// Размеры
-#define MAX_LEVEL_WIDTH 255
-#define MAX_LEVEL_HEIGHT 255
-#define MAX_MOVING_OBJECTS 16
-
-// Структура движущегося объекта (шипов)
-typedef struct {
-    short topLeft[2];       // Верхний левый угол области движения (в тайлах)  
-    short botRight[2];      // Нижний правый угол области движения (в тайлах)
-    short direction[2];     // Направление движения по X,Y
-    short offset[2];        // Текущее смещение внутри области (в пикселях)
-} MovingObject;
-
-// Структура уровня
-typedef struct {
-    int width;              // Ширина карты в тайлах
-    int height;             // Высота карты в тайлах
-    int startPosX;          // Стартовая позиция игрока X (в пикселях)
-    int startPosY;          // Стартовая позиция игрока Y (в пикселях)
-    int startTileX;         // Стартовая позиция игрока X (в тайлах)
-    int startTileY;         // Стартовая позиция игрока Y (в тайлах)
-    int ballSize;           // Размер мяча (0=маленький, 1=большой)
-    int exitPosX;           // Позиция выхода X (в тайлах)
-    int exitPosY;           // Позиция выхода Y (в тайлах)
-    int totalRings;         // Общее количество колец для сбора
-    
-    // Движущиеся объекты
-    int numMovingObjects;   // Количество движущихся объектов
-    MovingObject movingObjects[MAX_MOVING_OBJECTS];
-    
-    // Карта тайлов
-    short tileMap[MAX_LEVEL_HEIGHT][MAX_LEVEL_WIDTH];
-} Level;
-
-// Глобальный уровень
-extern Level g_level;
-
-// Функции для доступа к тайловому атласу
-texture_t* level_get_tileset(void);
-int level_get_tiles_per_row(void);
-
-// Функции
-int level_load_from_memory(const char* levelData, int dataSize);
-int level_load_from_file(const char* filename);
-int level_load_by_number(int levelNumber);
-int level_get_tile_at(int tileX, int tileY);
-void level_render_visible_area(int cameraX, int cameraY, int screenWidth, int screenHeight);
-
-// Функции для движущихся объектов
-void level_update_moving_objects(void);
-int level_find_moving_object_at(int tileX, int tileY);
-MovingObject* level_get_moving_object(int index);  // Получить движущийся объект по индексу
-
-// Операции с тайлами карты (для событийной системы)
-uint8_t level_get_id(int tx, int ty);              // Получить ID тайла (без флагов)
-void level_set_id(int tx, int ty, uint8_t id);     // Установить ID тайла (с флагами)
-void level_deactivate_old_checkpoint(void);        // Деактивировать старый чекпоинт (7->8)
-void level_mark_checkpoint_active(int tx, int ty); // Активировать чекпоинт ((id&0x7F)|0x88)
-void level_set_respawn(int tx, int ty);            // Установить новую точку респауна
-void level_get_respawn(int* tx, int* ty);           // Получить текущую позицию респауна
-
-// Cleanup
-void level_cleanup(void);
-
+#define TILE_FLAGS_MASK    0x40  // Только флаг воды, без TILE_FLAG_MISC
+
+/* ---------------------------------------------------------------------------
+   ФОРМУЛА КОНВЕРТАЦИИ Java → PSP цветов:
+   
+   1. Java десятичное → hex: 545706₁₀ = 0x085300 (24-бит RGB)
+   2. Извлечь каналы RGB: R=0x08, G=0x53, B=0xAA  
+   3. Переставить в ABGR: A=0xFF, B=Java_B, G=Java_G, R=Java_R
+   4. Результат PSP: 0xFFAA5308
+   
+   Примеры:
+   - Java: 545706 = 0x085300 → R=08,G=53,B=AA → PSP: 0xFFAA5308 (HUD)
+   - Java: 1073328 = 0x1060B0 → R=10,G=60,B=B0 → PSP: 0xFFB06010 (синий)
+   
+   Исключения (баги Java палитры):
+   - Java: 11591920 → PSP: 0xFFE3D3A2 (не по формуле, legacy значение)
+--------------------------------------------------------------------------- */
+#define BACKGROUND_COLOUR     0xFFE3D3A2  // голубой
+#define WATER_COLOUR          0xFFB06010  // синий
+#define HUD_COLOUR            0xFFAA5308  // темно-синий HUD (Java 545706)
+#define ABOUT_BACKGROUND_COLOUR 0xFFFBFF6C  // Особый фон для About экрана
+
+// Exit door stripe colors (Java createExitImage)
+#define EXIT_LIGHT_STRIPE_COLOUR  0xFF9E9DFC  // Java 16555422 = 0xFC9D9E RGB → ABGR
+#define EXIT_DARK_STRIPE_COLOUR   0xFF3F3AE3  // Java 14891583 = 0xE33A3F RGB → ABGR
+#define EXIT_FOURTH_STRIPE_COLOUR 0xFF8E84C2  // Java 12747918 = 0xC2848E RGB → ABGR
+
+// Цвета для меню и текста
+#define COLOR_SELECTION_BG    0xFF2135FF  // Красно-фиолетовый фон выделения
+#define COLOR_TEXT_NORMAL     0xFF000000  // Черный обычный текст
+#define COLOR_WHITE_ABGR      0xFFFFFFFF  // Белый цвет
+#define COLOR_TEXT_SELECTED   0xFFFFFFFF  // Белый выделенный текст
+#define COLOR_TEXT_HELP       0xFF333333  // Темно-серый текст подсказки
+#define COLOR_DISABLED        0xFF808080  // Серый цвет для недоступных элементов
+#define COLOR_TEXT_HIGHLIGHT  0xFF800000  // Темно-красный цвет для выделения (новый рекорд)
+#define COLOR_BONUS_BAR       0xFF037FFF  // Оранжевый цвет полоски бонуса (Java: 16750611)
+#define COLOR_BONUS_FRAME     0xFFFFFFFF  // Белая рамка полоски бонуса
+
+/* --- Resource paths (following Java BounceConst pattern) --- */
+#define TILESET_PATH          "icons/objects_nm.png"  // Основной атлас тайлов
+
+// Кольца для сбора (13-28 в оригинале)
+
+// Размеры
+#define MAX_LEVEL_WIDTH 255
+#define MAX_LEVEL_HEIGHT 255
+#define MAX_MOVING_OBJECTS 16
+#define MAX_MUTABLE_TILES 512   // Ячеек, которые может изменить игра (в оригинальных уровнях до 50)
+
+// Упаковка ячейки Level::clearance
+#define CLEARANCE_MAX 15
+#define CLEARANCE_SOLID(c)   ((c) & 0x0F)
+#define CLEARANCE_SPECIAL(c) ((c) >> 4)
+
+// Структура движущегося объекта (шипов)
+typedef struct {
+    short topLeft[2];       // Верхний левый угол области движения (в тайлах)  
+    short botRight[2];      // Нижний правый угол области движения (в тайлах)
+    short direction[2];     // Направление движения по X,Y
+    short offset[2];        // Текущее смещение внутри области (в пикселях)
+} MovingObject;
+
+// Окно тайлов последнего collisionDetection() (physics.c). За подшаг мяч сдвигается
+// на пиксель, и окно меняется примерно раз в 12 подшагов: классы и ID его тайлов
+// берутся из кэша, а не заново из карты. Сбрасывается при загрузке, в
+// level_set_id() и sim_restore().
+#define TILE_WINDOW_MAX 9           // Окно мяча - не больше 3x3 тайлов
+#define TILE_WINDOW_OFF_MAP 0xFF    // cls тайла за картой
+
+typedef struct {
+    bool valid;
+    short x0, y0, x1, y1;           // Тайлы [x0, x1) x [y0, y1)
+    uint8_t count;                  // (x1 - x0) * (y1 - y0)
+    uint16_t busyMask;              // Непустые тайлы и тайлы за картой (бит e - тайл e)
+    uint8_t cls[TILE_WINDOW_MAX];   // В порядке обхода collisionDetection: X снаружи, Y внутри
+    uint8_t id[TILE_WINDOW_MAX];    // ID без флагов
+} TileWindowCache;
+
+// Структура уровня
+typedef struct {
+    int width;              // Ширина карты в тайлах
+    int height;             // Высота карты в тайлах
+    int startPosX;          // Стартовая позиция игрока X (в пикселях)
+    int startPosY;          // Стартовая позиция игрока Y (в пикселях)
+    int startTileX;         // Стартовая позиция игрока X (в тайлах)
+    int startTileY;         // Стартовая позиция игрока Y (в тайлах)
+    int ballSize;           // Размер мяча (0=маленький, 1=большой)
+    int exitPosX;           // Позиция выхода X (в тайлах)
+    int exitPosY;           // Позиция выхода Y (в тайлах)
+    int totalRings;         // Общее количество колец для сбора
+    
+    // Движущиеся объекты
+    int numMovingObjects;   // Количество движущихся объектов
+    MovingObject movingObjects[MAX_MOVING_OBJECTS];
+    MovingObject movingObjectsStart[MAX_MOVING_OBJECTS];  // Состояние при загрузке
+    uint32_t movingTick;    // Вызовов level_update_moving_objects() с загрузки
+    // XOR ключей движущихся объектов для sim_hash() (zobrist_moving_key). Считается
+    // при загрузке и в level_seek_moving_objects(), сдвиг шипов обновляет его на месте.
+    uint64_t movingHash;
+
+    TileWindowCache tileWindow;  // Кэш окна collisionDetection() (не входит в снимок и хэш)
+
+    // Ячейки, которые меняет level_set_id(): кольца, чекпоинты, доп. жизни и
+    // стартовая точка (первый respawn). Индекс ячейки в сетках = y * stride + x.
+    // Строится при загрузке; -1, если таких ячеек больше MAX_MUTABLE_TILES.
+    int numMutableTiles;
+    uint16_t mutableTiles[MAX_MUTABLE_TILES];
+
+    // Поле зазоров Level::clearance построено (см. ниже)
+    bool clearanceReady;
+
+    // Zobrist-хэш карты (zobrist.h). Считается при загрузке и дальше
+    // обновляется на месте в level_set_id(), без обхода карты.
+    uint64_t hash;
+
+    // Шаг строки пикселей Level::solidRows в словах (solid_bitmap.h);
+    // 0 - уровень не загружен
+    int solidStride;
+
+    // Все поля выше обнуляются при загрузке.
+
+    // Сетки карты по width * height байт, строки подряд с шагом stride == width:
+    // ячейка (x, y) во всех сетках - индекс y * stride + x. Сетки и таблица строк
+    // пиксельной карты лежат одним блоком в куче размером по уровню (у
+    // оригинального уровня - до 40 КБ); загрузка уровня не больше прежнего
+    // переиспользует блок.
+    // Блок освобождает level_free(), копию уровня со своим блоком дает level_copy().
+    int stride;
+    size_t gridCapacity;       // Байт в блоке сеток (начинается с tiles)
+
+    // Карта тайлов: байт на тайл (ID, TILE_FLAG_WATER и бит 0x80). Карта
+    // оригинального уровня - до 10 КБ подряд и целиком помещается в D-кэш PSP.
+    // Читается через level_get_tile_at()/level_get_id() (level_tile() - без
+    // проверки границ), меняется только через level_set_id().
+    uint8_t* tiles;
+
+    // Класс коллизии каждого тайла (TileCollisionClass) для testTile.
+    // Заполняется при загрузке и обновляется в level_set_id() вместе с tiles.
+    uint8_t* collisionClass;
+
+    // Индекс движущегося объекта + 1, в область которого входит тайл (0 - ни в чью).
+    // Строится при загрузке: области объектов неподвижны, меняется только смещение.
+    uint8_t* movingObjectAt;
+
+    // Поле зазоров для enlarge_ball(), два расстояния Чебышёва в тайлах (до 15):
+    // CLEARANCE_SOLID - до ближайшего тайла карты, который не кирпич и не резина
+    // (за картой - кирпич); CLEARANCE_SPECIAL - до ближайшего тайла, кроме пустого,
+    // кирпича и резины, или ячейки из числа изменяемых. Строится при первом долгом поиске места
+    // в enlarge_ball() (level_build_clearance), а не при загрузке: нужно редко.
+    uint8_t* clearance;
+
+    // Пиксельная карта кирпича, резины и рамп (solid_bitmap.h), 1 бит на пиксель:
+    // строка пикселей - solidStride слов, бит (x & 31) слова x >> 5 - пиксель x.
+    // Таблица на height строк тайлов: solidRows[ty] - TILE_SIZE строк пикселей
+    // строки ty в своем блоке кучи, который выделяется при первом построении
+    // строки (NULL - еще не нужна). Изменяемые ячейки в карту не попадают,
+    // поэтому sim_restore() ее не трогает; тайл построенной строки
+    // перерисовывается в level_set_id(). Строки освобождает solid_bitmap_free().
+    uint32_t** solidRows;
+} Level;
+
+// Уровень принадлежит контексту симуляции (SimContext::level, sim.h)
+
+// Функции для доступа к тайловому атласу (level_render.c)
+void level_load_tileset(void);
+texture_t* level_get_tileset(void);
+int level_get_tiles_per_row(void);
+
+// Функции
+int level_load_from_memory(Level* level, const char* levelData, int dataSize);
+int level_load_from_file(Level* level, const char* filename);
+int level_load_by_number(Level* level, int levelNumber);
+bool level_copy(Level* dst, const Level* src);    // Копия в dst со своими сетками (false - нет памяти)
+void level_free(Level* level);                    // Освободить сетки (уровень становится пустым)
+int level_get_tile_at(const Level* level, int tileX, int tileY);
+uint64_t level_compute_hash(const Level* level);  // Полный пересчет Level::hash (для проверки)
+void level_build_clearance(Level* level);         // Построить Level::clearance
+void level_render_visible_area(int cameraX, int cameraY, int screenWidth, int screenHeight);
+
+// Функции для движущихся объектов
+void level_update_moving_objects(Level* level);
+// Положение объектов после tick обновлений с загрузки - за O(1) на объект,
+// без пошагового прогона (для восстановления снимков и перемотки)
+void level_seek_moving_objects(Level* level, uint32_t tick);
+void level_moving_object_at_tick(const MovingObject* start, uint32_t tick, MovingObject* out);
+int level_find_moving_object_at(const Level* level, int tileX, int tileY);
+MovingObject* level_get_moving_object(Level* level, int index);  // Получить движущийся объект по индексу
+
+// Тайл клетки внутри карты (с флагами) без проверки границ - для циклов,
+// уже ограниченных размером уровня; вне карты - level_get_tile_at()
+static inline uint8_t level_tile(const Level* level, int tx, int ty) {
+    return level->tiles[ty * level->stride + tx];
+}
+
+// Операции с тайлами карты (для событийной системы)
+uint8_t level_get_id(const Level* level, int tx, int ty);          // Получить ID тайла (без флагов)
+void level_set_id(Level* level, int tx, int ty, uint8_t id);       // Установить ID тайла (с флагами)
+void level_mark_checkpoint_active(Level* level, int tx, int ty);   // Активировать чекпоинт ((id&0x7F)|0x88)
+
+// Cleanup
+void level_cleanup(void);          // Кэш уровней (level.c)
+void level_render_cleanup(void);   // Атлас тайлов (level_render.c)
+
 #endif
@@ -0,0 +1,416 @@
+// level_render.c - Отрисовка уровня с атласом PNG (с поддержкой трансформаций)
+// Данные уровня и runtime-операции с тайлами находятся в level.c; этот модуль
+// только читает уровень игрового контекста g_sim и не участвует в симуляции.
+#include "level.h"
+#include "tile_table.h"
+#include "graphics.h"
+#include "game.h"  // g_sim и анимация двери
+#include <stdbool.h>
+#include <stdint.h>
+
+// Параметры полосок EXIT тайла (двери)
+#define EXIT_STRIPE_1_X      0    // Первая полоска (фон)
+#define EXIT_STRIPE_1_WIDTH  24   // Ширина первой полоски (вся область)
+#define EXIT_STRIPE_2_X      4    // Голубая полоска
+#define EXIT_STRIPE_2_WIDTH  16   // Ширина голубой полоски
+#define EXIT_STRIPE_3_X      6    // Красная полоска
+#define EXIT_STRIPE_3_WIDTH  10   // Ширина красной полоски
+#define EXIT_STRIPE_4_X      10   // Четвертая полоска
+#define EXIT_STRIPE_4_WIDTH  4    // Ширина четвертой полоски
+
+// --- Текстуры/атлас (инкапсулированы через level_get_*) ---
+static texture_t* s_tileset = NULL;
+static int s_tiles_per_row = 0;
+
+
+// --- Dynamic sprite validation ---
+static inline int get_max_sprite_index(void) {
+    if (!s_tileset || s_tiles_per_row <= 0) return -1;
+    // actual_height используется вместо height, так как может быть больше из-за POT требований PSP
+    int tiles_per_col = s_tileset->actual_height / TILE_SIZE;
+    return s_tiles_per_row * tiles_per_col;
+}
+
+static inline bool is_sprite_valid(int sprite_idx) {
+    int max_idx = get_max_sprite_index();
+    return max_idx >= 0 && sprite_idx >= 0 && sprite_idx < max_idx;
+}
+
+// --- Ring foreground queue (draw after the ball) ---
+typedef struct { int sprite_idx; int x, y; int transform; } hoop_fg_item_t;
+static hoop_fg_item_t s_hoop_fg[RING_FG_QUEUE_MAX];
+static int s_hoop_fg_count = 0;
+static inline void hoop_fg_clear(void){ s_hoop_fg_count = 0; }
+
+static inline void hoop_fg_push(int sprite_idx, int x, int y, int transform){
+    if (s_hoop_fg_count < (int)(sizeof(s_hoop_fg)/sizeof(s_hoop_fg[0]))){
+        s_hoop_fg[s_hoop_fg_count++] = (hoop_fg_item_t){ sprite_idx, x, y, transform };
+    }
+}
+
+// Map TileTransform -> png_transform_t
+static inline png_transform_t map_tf_to_png(int tf){
+    switch (tf){
+        case TF_FLIP_X:  return PNG_TRANSFORM_FLIP_X;
+        case TF_FLIP_Y:  return PNG_TRANSFORM_FLIP_Y;
+        case TF_FLIP_XY: return PNG_TRANSFORM_ROT_180; // FLIP_X+FLIP_Y эквивалент 180°
+        case TF_ROT_90:  return PNG_TRANSFORM_ROT_90;
+        case TF_ROT_180: return PNG_TRANSFORM_ROT_180;
+        case TF_ROT_270: return PNG_TRANSFORM_ROT_270;
+        case TF_ROT_270_FLIP_X: return PNG_TRANSFORM_ROT_270_FLIP_X;
+        case TF_ROT_270_FLIP_Y: return PNG_TRANSFORM_ROT_270_FLIP_Y;
+
+        case TF_ROT_270_FLIP_XY: return PNG_TRANSFORM_ROT_270_FLIP_XY;
+        default:         return PNG_TRANSFORM_IDENTITY;
+    }
+}
+
+static void hoop_fg_flush(void){
+    if (!s_tileset || s_tiles_per_row <= 0) { s_hoop_fg_count = 0; return; }
+    for (int i = 0; i < s_hoop_fg_count; ++i){
+        int idx = s_hoop_fg[i].sprite_idx;
+        if (!is_sprite_valid(idx)) continue;
+        int col = idx % s_tiles_per_row;
+        int row = idx / s_tiles_per_row;
+        int srcX = col * TILE_SIZE;
+        int srcY = row * TILE_SIZE;
+        sprite_rect_t r = png_create_sprite_rect(s_tileset, srcX, srcY, TILE_SIZE, TILE_SIZE);
+        png_transform_t xf = map_tf_to_png(s_hoop_fg[i].transform); // alt_transform now used from queue
+        if (xf == PNG_TRANSFORM_IDENTITY){
+            png_draw_sprite(s_tileset, &r, (int)s_hoop_fg[i].x, (int)s_hoop_fg[i].y, TILE_SIZE, TILE_SIZE);
+        } else {
+            png_draw_sprite_transform(s_tileset, &r, (int)s_hoop_fg[i].x, (int)s_hoop_fg[i].y, TILE_SIZE, TILE_SIZE, xf);
+        }
+    }
+    s_hoop_fg_count = 0;
+}
+
+// Public control to get order: background -> ball -> ring foreground
+static int s_ring_fg_defer = 0;
+void level_set_ring_fg_defer(int on) { s_ring_fg_defer = on ? 1 : 0; }
+void level_flush_ring_foreground(void) { hoop_fg_flush(); }
+
+// Функции для инкапсуляции доступа к тайловому атласу
+texture_t* level_get_tileset(void) { return s_tileset; }
+int level_get_tiles_per_row(void) { return s_tiles_per_row; }
+
+// --- Единожды загрузить атлас ---
+void level_load_tileset(void) {
+    if (s_tileset) return;
+    s_tileset = png_load_texture_vram(TILESET_PATH);
+    if (s_tileset && s_tileset->width > 0) {
+        s_tiles_per_row = s_tileset->actual_width / TILE_SIZE; // 12 px на тайл
+    } else {
+        s_tiles_per_row = 0;
+    }
+}
+
+// --- Новые функции рендеринга ---
+
+// Рендер EXIT тайла: фоновые полоски (plain pass)
+static void render_exit_tile_plain(int tile_id, int destX, int destY, int worldTileX, int worldTileY) {
+    if (tile_id == 9) { // EXIT - новая логика по якорю exitPos
+        int local_x = worldTileX - g_sim.level.exitPosX;
+        int local_y = worldTileY - g_sim.level.exitPosY;
+
+        if (local_x == 0 && local_y == 0) {
+            // Только левый верхний тайл рисует фон для всей области 2x2
+            u32 background = BACKGROUND_COLOUR;
+            u32 first_stripe = BACKGROUND_COLOUR;
+            u32 light_stripe = EXIT_LIGHT_STRIPE_COLOUR;
+            u32 dark_stripe = EXIT_DARK_STRIPE_COLOUR;
+            u32 fourth_stripe = EXIT_FOURTH_STRIPE_COLOUR;
+
+            int area_width = 2 * TILE_SIZE;
+            int area_height = 2 * TILE_SIZE;
+
+            graphics_draw_rect(destX, destY, area_width, area_height, background);
+            graphics_draw_rect(destX + EXIT_STRIPE_1_X, destY, EXIT_STRIPE_1_WIDTH, area_height, first_stripe);
+            graphics_draw_rect(destX + EXIT_STRIPE_2_X, destY, EXIT_STRIPE_2_WIDTH, area_height, light_stripe);
+            graphics_draw_rect(destX + EXIT_STRIPE_3_X, destY, EXIT_STRIPE_3_WIDTH, area_height, dark_stripe);
+            graphics_draw_rect(destX + EXIT_STRIPE_4_X, destY, EXIT_STRIPE_4_WIDTH, area_height, fourth_stripe);
+        }
+    } else if (tile_id == 10) {
+        graphics_draw_rect(destX, destY, TILE_SIZE, TILE_SIZE, WATER_COLOUR);
+    } else {
+        graphics_draw_rect(destX, destY, TILE_SIZE, TILE_SIZE, 0xFF888888);
+    }
+}
+
+// Рендер EXIT тайла: спрайты двери (textured pass)
+static void render_exit_tile_textured(int tile_id, int destX, int destY, int worldTileX, int worldTileY) {
+    if (tile_id != 9) return;
+
+    int local_x = worldTileX - g_sim.level.exitPosX;
+    int local_y = worldTileY - g_sim.level.exitPosY;
+
+    if (local_x != 0 || local_y != 0) return;
+    if ((uint32_t)tile_id >= tile_meta_count()) return;
+    if (!s_tileset || s_tiles_per_row <= 0) return;
+
+    const TileMeta* t = &tile_meta_db()[tile_id];
+    const int col = t->sprite_index % s_tiles_per_row;
+    const int row = t->sprite_index / s_tiles_per_row;
+
+    int srcX = col * TILE_SIZE;
+    int srcY = row * TILE_SIZE;
+    sprite_rect_t r = png_create_sprite_rect(s_tileset, srcX, srcY, TILE_SIZE, TILE_SIZE);
+
+    int animationOffset = game_exit_anim_offset(&g_sim);
+    int doorX = destX;
+    int doorY = destY - animationOffset;
+    int areaTop = destY;
+
+    if (doorY < areaTop) {
+        int clipOffset = areaTop - doorY;
+        if (clipOffset < TILE_SIZE) {
+            int visibleHeight = TILE_SIZE - clipOffset;
+            sprite_rect_t clipped_r = png_create_sprite_rect(s_tileset, srcX, srcY + clipOffset, TILE_SIZE, visibleHeight);
+
+            png_draw_sprite(s_tileset, &clipped_r, doorX, areaTop, TILE_SIZE, visibleHeight);
+            png_draw_sprite_transform(s_tileset, &clipped_r, doorX + TILE_SIZE, areaTop, TILE_SIZE, visibleHeight, PNG_TRANSFORM_FLIP_X);
+
+            if (doorY + TILE_SIZE >= areaTop) {
+                png_draw_sprite_transform(s_tileset, &r, doorX, doorY + TILE_SIZE, TILE_SIZE, TILE_SIZE, PNG_TRANSFORM_FLIP_Y);
+                png_draw_sprite_transform(s_tileset, &r, doorX + TILE_SIZE, doorY + TILE_SIZE, TILE_SIZE, TILE_SIZE, PNG_TRANSFORM_ROT_180);
+            }
+        }
+    } else {
+        png_draw_sprite(s_tileset, &r, doorX, doorY, TILE_SIZE, TILE_SIZE);
+        png_draw_sprite_transform(s_tileset, &r, doorX + TILE_SIZE, doorY, TILE_SIZE, TILE_SIZE, PNG_TRANSFORM_FLIP_X);
+        png_draw_sprite_transform(s_tileset, &r, doorX, doorY + TILE_SIZE, TILE_SIZE, TILE_SIZE, PNG_TRANSFORM_FLIP_Y);
+        png_draw_sprite_transform(s_tileset, &r, doorX + TILE_SIZE, doorY + TILE_SIZE, TILE_SIZE, TILE_SIZE, PNG_TRANSFORM_ROT_180);
+    }
+}
+
+// Рендер движущихся шипов: фон тайла (plain pass)
+static void render_moving_spikes_tile_plain(int tileX, int tileY, int destX, int destY) {
+    unsigned int tile = level_tile(&g_sim.level, tileX, tileY);
+    bool is_water = (tile & TILE_FLAG_WATER) ? true : false;
+    u32 bg_color = is_water ? WATER_COLOUR : BACKGROUND_COLOUR;
+    graphics_draw_rect(destX, destY, TILE_SIZE, TILE_SIZE, bg_color);
+}
+
+// Рендер движущихся шипов: спрайты (textured pass)
+static void render_moving_spikes_tile_textured(int tileX, int tileY, int destX, int destY) {
+    int objIndex = level_find_moving_object_at(&g_sim.level, tileX, tileY);
+    if (objIndex == -1) return;
+    if (!s_tileset || s_tiles_per_row <= 0) return;
+    if (10 >= tile_meta_count()) return;
+
+    MovingObject* obj = &g_sim.level.movingObjects[objIndex];
+    int relTileX = tileX - obj->topLeft[0];
+    int relTileY = tileY - obj->topLeft[1];
+
+    int offsetX = obj->offset[0] - (relTileX * TILE_SIZE);
+    int offsetY = obj->offset[1] - (relTileY * TILE_SIZE);
+
+    if (offsetX > -3 * TILE_SIZE && offsetX < TILE_SIZE && offsetY > -3 * TILE_SIZE && offsetY < TILE_SIZE) {
+        const TileMeta* t = &tile_meta_db()[10];
+        int col = t->sprite_index % s_tiles_per_row;
+        int row = t->sprite_index / s_tiles_per_row;
+
+        for (int dy = 0; dy < 2; dy++) {
+            for (int dx = 0; dx < 2; dx++) {
+                int spriteX = destX + offsetX + (dx * TILE_SIZE);
+                int spriteY = destY + offsetY + (dy * TILE_SIZE);
+
+                if (spriteX < destX + TILE_SIZE && spriteX + TILE_SIZE > destX &&
+                    spriteY < destY + TILE_SIZE && spriteY + TILE_SIZE > destY) {
+
+                    int srcX = col * TILE_SIZE;
+                    int srcY = row * TILE_SIZE;
+                    sprite_rect_t r = png_create_sprite_rect(s_tileset, srcX, srcY, TILE_SIZE, TILE_SIZE);
+
+                    png_transform_t xf = PNG_TRANSFORM_IDENTITY;
+                    if (dx == 1 && dy == 0) xf = PNG_TRANSFORM_FLIP_X;
+                    if (dx == 0 && dy == 1) xf = PNG_TRANSFORM_FLIP_Y;
+                    if (dx == 1 && dy == 1) xf = PNG_TRANSFORM_ROT_180;
+
+                    png_draw_sprite_transform(s_tileset, &r, spriteX, spriteY, TILE_SIZE, TILE_SIZE, xf);
+                }
+            }
+        }
+    }
+}
+
+// REMOVED: render_dual_sprite_tile - was deprecated and unused
+
+// Рендер кольца-обруча: фон тайла (plain pass)
+static void render_hoop_tile_plain(int destX, int destY, int flags) {
+    u32 bg_color = (flags & TILE_FLAG_WATER) ? WATER_COLOUR : BACKGROUND_COLOUR;
+    graphics_draw_rect(destX, destY, TILE_SIZE, TILE_SIZE, bg_color);
+}
+
+// Рендер кольца-обруча: спрайты и очередь foreground (textured pass)
+static void render_hoop_tile_textured(const TileMeta* t, int destX, int destY, int tileID) {
+    if (!s_tileset || s_tiles_per_row <= 0) return;
+    if (tileID < 13 || tileID > 28 || !is_sprite_valid(t->sprite_index)) return;
+
+    int col = t->sprite_index % s_tiles_per_row;
+    int row = t->sprite_index / s_tiles_per_row;
+    int srcX = col * TILE_SIZE;
+    int srcY = row * TILE_SIZE;
+
+    sprite_rect_t r = png_create_sprite_rect(s_tileset, srcX, srcY, TILE_SIZE, TILE_SIZE);
+
+    TileTransform bg_transform = (t->orientation == ORIENT_VERT_TOP) ? TF_ROT_270_FLIP_X :
+                                (t->orientation == ORIENT_VERT_BOTTOM) ? TF_ROT_270_FLIP_XY :
+                                (t->orientation == ORIENT_HORIZ_LEFT) ? TF_FLIP_Y :
+                                (t->orientation == ORIENT_HORIZ_RIGHT) ? TF_FLIP_XY : TF_NONE;
+    png_transform_t xf = map_tf_to_png(bg_transform);
+
+    png_draw_sprite_transform(s_tileset, &r, (int)destX, (int)destY, TILE_SIZE, TILE_SIZE, xf);
+
+    TileTransform fg_transform = (t->orientation == ORIENT_VERT_TOP) ? TF_ROT_270 :
+                                (t->orientation == ORIENT_VERT_BOTTOM) ? TF_ROT_270_FLIP_Y :
+                                (t->orientation == ORIENT_HORIZ_RIGHT) ? TF_FLIP_X : TF_NONE;
+    hoop_fg_push(t->sprite_index, destX, destY, fg_transform);
+}
+
+// --- Рендер видимой области (ОБНОВЛЕНО) ---
+// ВАЖНО: После вызова функция оставляет произвольное текстурное состояние.
+// Состояние текстур управляется централизованно через graphics.c
+void level_render_visible_area(int cameraX, int cameraY, int screenWidth, int screenHeight) {
+    
+    hoop_fg_clear();
+    if (g_sim.level.width <= 0 || g_sim.level.height <= 0) return;
+
+    int startTileX = cameraX / TILE_SIZE;
+    int endTileX   = (cameraX + screenWidth  - 1) / TILE_SIZE;
+    int startTileY = cameraY / TILE_SIZE;
+    int endTileY   = (cameraY + screenHeight - 1) / TILE_SIZE;
+
+    if (startTileX < 0) startTileX = 0;
+    if (startTileY < 0) startTileY = 0;
+    if (endTileX >= g_sim.level.width)   endTileX = g_sim.level.width - 1;
+    if (endTileY >= g_sim.level.height)  endTileY = g_sim.level.height - 1;
+
+    // Pass 1: plain фон (минимизируем переключения режима)
+    graphics_begin_plain();
+
+    for (int y = startTileY; y <= endTileY; ++y) {
+        for (int x = startTileX; x <= endTileX; ++x) {
+            unsigned int tile = level_tile(&g_sim.level, x, y);
+            bool is_water = (tile & TILE_FLAG_WATER) ? true : false;
+            int original_tile_flags = tile & TILE_FLAGS_MASK;
+
+            if (is_water) {
+                tile = tile & ~TILE_FLAG_WATER;
+            }
+
+            int tile_id = tile & TILE_ID_MASK;
+            int tile_flags = original_tile_flags;
+
+            int screenX = x * TILE_SIZE - cameraX;
+            int screenY = y * TILE_SIZE - cameraY;
+
+            if (tile_id == 0) {
+                u32 bg_color = is_water ? WATER_COLOUR : BACKGROUND_COLOUR;
+                graphics_draw_rect(screenX, screenY, TILE_SIZE, TILE_SIZE, bg_color);
+                continue;
+            }
+
+            if (tile_id < 0 || tile_id >= (int)tile_meta_count()) continue;
+
+            if (!s_tileset || s_tiles_per_row <= 0) {
+                graphics_draw_rect(screenX, screenY, TILE_SIZE, TILE_SIZE, 0xFF444444);
+                continue;
+            }
+
+            const TileMeta* t = &tile_meta_db()[tile_id];
+
+            if (tile_id == 9) {
+                if (is_water) {
+                    graphics_draw_rect(screenX, screenY, TILE_SIZE, TILE_SIZE, WATER_COLOUR);
+                }
+                render_exit_tile_plain(tile_id, screenX, screenY, x, y);
+                continue;
+            } else if (tile_id == 10) {
+                render_moving_spikes_tile_plain(x, y, screenX, screenY);
+                continue;
+            } else if (t->render_type & RENDER_COMPOSITE) {
+                if (is_water) {
+                    graphics_draw_rect(screenX, screenY, TILE_SIZE, TILE_SIZE, WATER_COLOUR);
+                }
+                render_exit_tile_plain(tile_id, screenX, screenY, x, y);
+                continue;
+            } else if (t->render_type & RENDER_HOOP) {
+                render_hoop_tile_plain(screenX, screenY, tile_flags);
+                continue;
+            }
+
+            if (is_water) {
+                graphics_draw_rect(screenX, screenY, TILE_SIZE, TILE_SIZE, WATER_COLOUR);
+            }
+
+            if (!is_sprite_valid(t->sprite_index)) {
+                graphics_draw_rect(screenX, screenY, TILE_SIZE, TILE_SIZE, 0xFF444444);
+            }
+        }
+    }
+
+    // Pass 2: текстуры (спрайты)
+    graphics_begin_textured();
+
+    for (int y = startTileY; y <= endTileY; ++y) {
+        for (int x = startTileX; x <= endTileX; ++x) {
+            unsigned int tile = level_tile(&g_sim.level, x, y);
+            bool is_water = (tile & TILE_FLAG_WATER) ? true : false;
+
+            if (is_water) {
+                tile = tile & ~TILE_FLAG_WATER;
+            }
+
+            int tile_id = tile & TILE_ID_MASK;
+
+            if (tile_id == 0) continue;
+            if (tile_id < 0 || tile_id >= (int)tile_meta_count()) continue;
+            if (!s_tileset || s_tiles_per_row <= 0) continue;
+
+            const TileMeta* t = &tile_meta_db()[tile_id];
+
+            int screenX = x * TILE_SIZE - cameraX;
+            int screenY = y * TILE_SIZE - cameraY;
+
+            if (tile_id == 9) {
+                render_exit_tile_textured(tile_id, screenX, screenY, x, y);
+                continue;
+            } else if (tile_id == 10) {
+                render_moving_spikes_tile_textured(x, y, screenX, screenY);
+                continue;
+            } else if (t->render_type & RENDER_COMPOSITE) {
+                render_exit_tile_textured(tile_id, screenX, screenY, x, y);
+                continue;
+            } else if (t->render_type & RENDER_HOOP) {
+                render_hoop_tile_textured(t, screenX, screenY, tile_id);
+                continue;
+            }
+
+            if (is_sprite_valid(t->sprite_index)) {
+                int col = t->sprite_index % s_tiles_per_row;
+                int row = t->sprite_index / s_tiles_per_row;
+                int srcX = col * TILE_SIZE;
+                int srcY = row * TILE_SIZE;
+
+                png_transform_t xf = map_tf_to_png(t->transform);
+                sprite_rect_t r = png_create_sprite_rect(s_tileset, srcX, srcY, TILE_SIZE, TILE_SIZE);
+                if (xf == PNG_TRANSFORM_IDENTITY) {
+                    png_draw_sprite(s_tileset, &r, (int)screenX, (int)screenY, TILE_SIZE, TILE_SIZE);
+                } else {
+                    png_draw_sprite_transform(s_tileset, &r, (int)screenX, (int)screenY, TILE_SIZE, TILE_SIZE, xf);
+                }
+            }
+        }
+    }
+    if (!s_ring_fg_defer) hoop_fg_flush();
+}
+
+// --- Освобождение атласа ---
+void level_render_cleanup(void) {
+    if (s_tileset) {
+        png_free_texture(s_tileset);
+        s_tileset = NULL;
+        s_tiles_per_row = 0;
+    }
+}
@@ -259,7 +259,7 @@ static void menu_update(void) {
             }
         } else if(g_game.menu_selection == MENU_NEW_GAME) {
             // NEW GAME - новая игра с уровня 1
-            game_start_level(1, GAME_START_FRESH);
+            game_enter_level(1, GAME_START_FRESH);
         } else if(g_game.menu_selection == MENU_SELECT_LEVEL) {
             // SELECT LEVEL
             g_game.state = STATE_LEVEL_SELECT;
@@ -426,7 +426,7 @@ static void level_select_update(void) {
     
     // Выбор уровня
     if(input_pressed(PSP_CTRL_CROSS)) {
-        game_start_level(g_game.selected_level, GAME_START_SELECTED);
+        game_enter_level(g_game.selected_level, GAME_START_SELECTED);
     }
     
     // Возврат в меню
@@ -550,7 +550,7 @@ static void game_over_render(void) {
     text_y = panel.y + 60;
 
     // Только число счёта, без "Score:" - красный, шрифт 24 (BounceUI.java:136)
-    draw_modal_score(&panel, text_y, g_game.score, COLOR_SELECTION_BG);
+    draw_modal_score(&panel, text_y, g_sim.score, COLOR_SELECTION_BG);
 
     // Кнопка "X - OK" - фиксированная позиция внизу панели (Local.getText(19), BounceUI.java:125)
     text_y = panel.y + panel.h - 25;  // 25px от низа панели
@@ -566,7 +566,7 @@ static void level_complete_update(void) {
     if(input_pressed(PSP_CTRL_CROSS)) {
         // Проверяем если не последний уровень (до 11) - переходим на следующий
         if(g_game.selected_level < MAX_LEVEL) {
-            game_start_level(g_game.selected_level + 1, GAME_START_NEXT);
+            game_enter_level(g_game.selected_level + 1, GAME_START_NEXT);
         } else {
             // Последний уровень пройден - Game Over экран (как в оригинале BounceCanvas:539)
             g_game.saved_game_state = SAVED_GAME_COMPLETED;
@@ -600,7 +600,7 @@ static void level_complete_render(void) {
 
     // Счёт - чёрный, шрифт 24, фиксированная позиция (BounceUI.java:152)
     text_y = panel.y + 60;
-    draw_modal_score(&panel, text_y, g_game.score, COLOR_TEXT_NORMAL);
+    draw_modal_score(&panel, text_y, g_sim.score, COLOR_TEXT_NORMAL);
 
     // Кнопка "X - Continue" - фиксированная позиция внизу панели (Local.getText(8), BounceUI.java:147)
     text_y = panel.y + panel.h - 25;  // 25px от низа панели (как в Game Over)
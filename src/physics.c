@@ -1,19 +1,25 @@
 // physics.c - Портированная физика из Ball.java (с подводной физикой)
+#include "sim.h"
 #include "types.h"
 #include "level.h"
 #include "tile_table.h"
 #include "game.h"        // Для событийного API
-#include "sound.h"       // Для звуковых эффектов
+#include "collision_lut.h"
+#include "solid_bitmap.h"
 #include <stdlib.h>
+#include <limits.h>
 #include <assert.h>
+#include <string.h>
 
-// Битовые маски для пиксельных коллизий.
+// Пиксельные коллизии берутся из предвычисленной таблицы collision_lut.c.
 _Static_assert(TILE_SIZE == 12, "TILE_SIZE must stay 12; collision masks in level_masks.inc are tied to 12x12 tiles.");
-#include "level_masks.inc"
 
 // Forward declarations
-static bool collisionDetection(Player* p, int testX, int testY);
-static bool testTile(Player* p, int tileY, int tileX, bool canMove);
+static bool collisionDetection(SimContext* sim, int testX, int testY);
+static int enlarge_blocked_run(const SimContext* sim, int x, int y, int dx, int dy);
+static void enlarge_run_flags(SimContext* sim, int x, int y, int dx, int dy, int count);
+static bool testTile(SimContext* sim, int tileY, int tileX, bool canMove);
+static bool test_tile_class(SimContext* sim, int tileY, int tileX, uint8_t cls, int tileID, bool canMove);
 static bool squareCollide(Player* p, int tileRow, int tileCol);
 static bool triangleCollide(Player* p, int tileRow, int tileCol, int tileID);
 static bool thinCollide(Player* p, int tileRow, int tileCol, int tileID);
@@ -27,24 +33,29 @@ static inline void player_center_tile(const Player* p, int* tileX, int* tileY) {
 }
 static bool edgeCollide(Player* p, int tileRow, int tileCol, int tileID);
 static void redirectBall(Player* p, int tileID);
-static void clip_to_tile_bounds(int relPos, int ballSize, int* startBound, int* endBound);
 static void clamp_speed(Player* p);
 
 
+// Счетчики SimContext::stats; без PHYSICS_STATS макрос ничего не вычисляет
+#ifdef PHYSICS_STATS
+#define PHYSICS_STAT(sim, field, n) ((sim)->stats.field += (uint64_t)(n))
+#define PHYSICS_STAT_MAX(sim, field, n) \
+    ((sim)->stats.field = (sim)->stats.field > (uint64_t)(n) ? (sim)->stats.field : (uint64_t)(n))
+#else
+#define PHYSICS_STAT(sim, field, n) ((void)0)
+#define PHYSICS_STAT_MAX(sim, field, n) ((void)0)
+#endif
+
 // Размер области движущихся шипов
 #define MOVING_SPIKE_PX (2 * TILE_SIZE)
 
 
-// Helper для вычисления границ пересечения мяча с тайлом (устраняет дублирование)
-// Используется в squareCollide и triangleCollide для одинаковой логики clipping
-static void clip_to_tile_bounds(int relPos, int ballSize, int* startBound, int* endBound) {
-    if (relPos >= 0) {
-        *startBound = relPos;
-        *endBound = TILE_SIZE;
-    } else {
-        *startBound = 0;
-        *endBound = ballSize + relPos;
-    }
+// Коллизия мяча с формой тайла: одна выборка из g_collision_lut по смещению
+// мяча относительно левого-верхнего угла тайла
+static inline bool shapeCollide(const Player* p, int tileRow, int tileCol, collision_shape_t shape) {
+    return collision_lut_test(p->ballSize, shape,
+                              p->globalBallX - tileCol * TILE_SIZE,
+                              p->globalBallY - tileRow * TILE_SIZE);
 }
 
 // Ограничение скорости мяча (аналог Java Ball.java:971-977)
@@ -63,7 +74,8 @@ static bool rectCollide(int x1, int y1, int x2, int y2, int rx1, int ry1, int rx
 // Константы перенесены в types.h для централизации
 
 // Инициализация игрока
-void player_init(Player* p, int x, int y, BallSizeState sizeState) {
+void player_init(SimContext* sim, int x, int y, BallSizeState sizeState) {
+    Player* p = &sim->player;
     p->xPos = x;
     p->yPos = y;
     p->globalBallX = 0;
@@ -97,62 +109,105 @@ void player_init(Player* p, int x, int y, BallSizeState sizeState) {
     p->isInWater = false;
     
     // Подталкивание большого мяча при инициализации в тесном месте, как в оригинале.
-    if (p->sizeState == LARGE_SIZE_STATE && !collisionDetection(p, p->xPos, p->yPos)) {
+    if (p->sizeState == LARGE_SIZE_STATE && !collisionDetection(sim, p->xPos, p->yPos)) {
         int offset = STUCK_BALL_OFFSET;
         
         // Порядок приоритета: влево, вверх, влево-вверх.
-        if (collisionDetection(p, p->xPos - offset, p->yPos)) {
+        if (collisionDetection(sim, p->xPos - offset, p->yPos)) {
             p->xPos -= offset;
-        } else if (collisionDetection(p, p->xPos, p->yPos - offset)) {
+        } else if (collisionDetection(sim, p->xPos, p->yPos - offset)) {
             p->yPos -= offset;
-        } else if (collisionDetection(p, p->xPos - offset, p->yPos - offset)) {
+        } else if (collisionDetection(sim, p->xPos - offset, p->yPos - offset)) {
             p->xPos -= offset;
             p->yPos -= offset;
         }
     }
 }
 
+// Кандидаты enlarge_ball() в порядке приоритета оригинала: вверх, влево-вверх,
+// вправо-вверх, вниз, влево-вниз, вправо-вниз
+#define ENLARGE_CANDIDATES 6
+#define ENLARGE_GONE INT_MAX
+static const signed char s_enlarge_dirs[ENLARGE_CANDIDATES][2] = {
+    { 0, -1 }, { -1, -1 }, { 1, -1 }, { 0, 1 }, { -1, 1 }, { 1, 1 }
+};
+
 // Увеличение мяча (портировано из enlargeBall())
-void enlarge_ball(Player* p) {
+void enlarge_ball(SimContext* sim) {
+    Player* p = &sim->player;
     if (p->sizeState == LARGE_SIZE_STATE) return; // Уже большой
     
     p->sizeState = LARGE_SIZE_STATE;
     p->ballSize = ENLARGED_SIZE;
     p->mHalfBallSize = HALF_ENLARGED_SIZE;
     
-    // Полная логика поиска свободного места как в оригинале
+    // Поиск свободного места как в оригинале: смещение растет на пиксель, на каждом
+    // по порядку проверяются шесть кандидатов. Кандидаты, которые заведомо дают
+    // коллизию (enlarge_blocked_run), не проверяются - от них остаются только флаги
+    // (enlarge_run_flags), а смещения, где так заведомо для всех шести,
+    // пропускаются целиком.
     int offset = 2;
-    int found_free_space = 0;
-    
-    while (!found_free_space) {
-        found_free_space = 1;
-        
+    for (;;) {
+        PHYSICS_STAT(sim, enlargeSearch, 1);
+        int ballSize = p->ballSize;
+        int skip = INT_MAX;
+        int runs[ENLARGE_CANDIDATES];
+
         // Порядок приоритета направлений совпадает с оригиналом.
-        if (collisionDetection(p, p->xPos, p->yPos - offset)) {
-            p->yPos -= offset;
-        } else if (collisionDetection(p, p->xPos - offset, p->yPos - offset)) {
-            p->xPos -= offset;
-            p->yPos -= offset;
-        } else if (collisionDetection(p, p->xPos + offset, p->yPos - offset)) {
-            p->xPos += offset;
-            p->yPos -= offset;
-        } else if (collisionDetection(p, p->xPos, p->yPos + offset)) {
-            p->yPos += offset;
-        } else if (collisionDetection(p, p->xPos - offset, p->yPos + offset)) {
-            p->xPos -= offset;
-            p->yPos += offset;
-        } else if (collisionDetection(p, p->xPos + offset, p->yPos + offset)) {
-            p->xPos += offset;
-            p->yPos += offset;
-        } else {
-            found_free_space = 0;
-            offset++;
+        for (int d = 0; d < ENLARGE_CANDIDATES; d++) {
+            int dx = s_enlarge_dirs[d][0];
+            int dy = s_enlarge_dirs[d][1];
+            int x = p->xPos + dx * offset;
+            int y = p->yPos + dy * offset;
+            int run = enlarge_blocked_run(sim, x, y, dx, dy);
+            if (run == 0) {
+                if (collisionDetection(sim, x, y)) {
+                    PHYSICS_STAT_MAX(sim, enlargeRadius, offset);
+                    p->xPos = x;
+                    p->yPos = y;
+                    return;
+                }
+                run = 1;
+            } else if (run != ENLARGE_GONE) {
+                enlarge_run_flags(sim, x, y, dx, dy, 1);
+            }
+            runs[d] = run;
+            if (run < skip) skip = run;
+        }
+
+        // collisionDetection() не вызывался: флаги за остальные пропускаемые смещения
+        if (skip > 1 && skip != ENLARGE_GONE) {
+            for (int d = 0; d < ENLARGE_CANDIDATES; d++) {
+                if (runs[d] == ENLARGE_GONE) continue;
+                int dx = s_enlarge_dirs[d][0];
+                int dy = s_enlarge_dirs[d][1];
+                enlarge_run_flags(sim, p->xPos + dx * (offset + 1), p->yPos + dy * (offset + 1),
+                                  dx, dy, skip - 1);
+            }
+        }
+
+        if (skip == ENLARGE_GONE) {
+            // Все кандидаты ушли за карту или мяч лопнул: оригинал здесь
+            // зацикливается навсегда. Мяч остается на месте.
+            PHYSICS_STAT_MAX(sim, enlargeRadius, offset);
+            p->globalBallX = p->xPos - p->mHalfBallSize;
+            p->globalBallY = p->yPos - p->mHalfBallSize;
+            return;
         }
+        // Поиск ушел глубже тайла: поле окупит свое построение (проход по всей
+        // карте), а на коротком поиске дешевле проверить кандидатов
+        if (!sim->level.clearanceReady && offset >= TILE_SIZE) {
+            level_build_clearance(&sim->level);
+        }
+        // Размер мог смениться внутри collisionDetection (дефлятор/инфлятор):
+        // тогда оценки, снятые до смены, на следующие смещения не переносятся
+        offset += (p->ballSize == ballSize) ? skip : 1;
     }
 }
 
 // Уменьшение мяча (портировано из shrinkBall())
-void shrink_ball(Player* p) {
+void shrink_ball(SimContext* sim) {
+    Player* p = &sim->player;
     if (p->sizeState == SMALL_SIZE_STATE) return; // Уже маленький
     
     p->sizeState = SMALL_SIZE_STATE;
@@ -161,24 +216,25 @@ void shrink_ball(Player* p) {
     
     // Проверка позиции после уменьшения как в оригинале
     int offset = 2;
-    if (collisionDetection(p, p->xPos, p->yPos + offset)) {
+    if (collisionDetection(sim, p->xPos, p->yPos + offset)) {
         p->yPos += offset;
-    } else if (collisionDetection(p, p->xPos, p->yPos - offset)) {
+    } else if (collisionDetection(sim, p->xPos, p->yPos - offset)) {
         p->yPos -= offset;
     }
     // Если оба направления заняты - остаемся на месте
 }
 
 // Лопание мяча (портировано из popBall())
-void pop_ball(Player* p) {
+void pop_ball(SimContext* sim) {
+    Player* p = &sim->player;
     // Проверка читерского бессмертия (как в оригинале Java !mCanvas.mInvincible)
-    if (g_game.invincible_cheat) return;
+    if (sim->invincible) return;
     
     p->ballState = BALL_STATE_POPPED;
     p->popCntr = POPPED_FRAMES;  // Анимация лопания (как в Java)
     
-    // Воспроизводим звук лопания мяча
-    sound_play_pop();
+    // Звук лопания мяча - через очередь событий тика
+    sim_event_push(sim, SIM_EVENT_POP, 0, 0, 0);
     
     // Сброс бонусов (как в Java)
     p->speedBonusCntr = 0;
@@ -186,7 +242,7 @@ void pop_ball(Player* p) {
     p->jumpBonusCntr = 0;
     
     // Уменьшаем жизни (как в Java)
-    g_game.numLives--;
+    sim->numLives--;
 }
 
 // Установка направления (битовые флаги)
@@ -205,131 +261,21 @@ void release_direction(Player* p, MoveDirection dir) {
     }
 }
 
-// Пиксельная коллизия с квадратным тайлом; структура близка к оригиналу.
+// Пиксельная коллизия с квадратным тайлом (маска мяча на весь тайл).
 static bool squareCollide(Player* p, int tileRow, int tileCol) {
-    int i = tileCol * 12;
-    int j = tileRow * 12;
-
-    int k = p->globalBallX - i;
-    int m = p->globalBallY - j;
-
-    int x_start, x_end, y_start, y_end;
-
-    if (k >= 0) {
-        x_start = k;
-        x_end = 12;
-    } else {
-        x_start = 0;
-        x_end = p->ballSize + k;
-    }
-
-    if (m >= 0) {
-        y_start = m;
-        y_end = 12;
-    } else {
-        y_start = 0;
-        y_end = p->ballSize + m;
-    }
-
-    if (x_end > 12) x_end = 12;
-    if (y_end > 12) y_end = 12;
-
-    if (p->ballSize == 16) {
-        const uint8_t (*largeBallData)[16] = (const uint8_t (*)[16])LARGE_BALL_DATA;
-        for (int b3 = x_start; b3 < x_end; b3++) {
-            for (int b = y_start; b < y_end; b++) {
-                if (largeBallData[b - m][b3 - k] != 0) {
-                    return true;
-                }
-            }
-        }
-    } else {
-        const uint8_t (*smallBallData)[12] = (const uint8_t (*)[12])SMALL_BALL_DATA;
-        for (int b3 = x_start; b3 < x_end; b3++) {
-            for (int b = y_start; b < y_end; b++) {
-                if (smallBallData[b - m][b3 - k] != 0) {
-                    return true;
-                }
-            }
-        }
-    }
-
-    return false;
+    return shapeCollide(p, tileRow, tileCol, COLLIDE_SQUARE);
 }
 
 // Коллизия с треугольной рампой, поведенчески эквивалентная оригиналу.
+// Ориентации 30-37 отражены заранее: 30/34, 31/35, 32/36, 33/37 - одна форма.
 static bool triangleCollide(Player* p, int tileRow, int tileCol, int tileID) {
-    // Координаты тайла в пикселях.
-    int i = tileCol * TILE_SIZE;  // paramInt2 * 12
-    int j = tileRow * TILE_SIZE;  // paramInt1 * 12
-    
-    // Локальные координаты шара в тайле
-    int k = p->globalBallX - i;
-    int m = p->globalBallY - j;
-    
-    // Смещения ориентации.
-    int b1 = 0, b2 = 0;
-    switch (tileID) {
-        case 30: case 34:
-            b2 = 11; b1 = 11;
-            break;
-        case 31: case 35:
-            b2 = 11;
-            break;
-        case 33: case 37:
-            b1 = 11;
-            break;
-        // case 32: case 36: без смещений
-    }
-    
-    // Границы цикла.
-    int b3, n, b4, i1;
-
-    // Вычисляем границы пересечения мяча с тайлом (используем общий helper)
-    clip_to_tile_bounds(k, p->ballSize, &b3, &n);
-    clip_to_tile_bounds(m, p->ballSize, &b4, &i1);
-    
-    // Обрезка границ.
-    if (n > TILE_SIZE) n = TILE_SIZE;
-    if (i1 > TILE_SIZE) i1 = TILE_SIZE;
-    
-    // Выбор данных мяча с правильными типами
-    if (p->ballSize == ENLARGED_SIZE) {
-        const uint8_t (*largeBallData)[ENLARGED_SIZE] = (const uint8_t (*)[ENLARGED_SIZE])LARGE_BALL_DATA;
-        // Двойной цикл точно как в Java
-        for (int b5 = b3; b5 < n; b5++) {
-            for (int b = b4; b < i1; b++) {
-                // Точная формула из Java: Math.abs() и обращение к ballData[b-m][b5-k]
-                int ballY = b - m;
-                int ballX = b5 - k;
-                if (ballY >= 0 && ballY < ENLARGED_SIZE && ballX >= 0 && ballX < ENLARGED_SIZE &&
-                    (TRI_TILE_DATA[abs(b - b2)][abs(b5 - b1)] & largeBallData[ballY][ballX]) != 0) {
-                    if (!p->mGroundedFlag) {
-                        redirectBall(p, tileID);
-                    }
-                    return true;
-                }
-            }
-        }
-    } else {
-        const uint8_t (*smallBallData)[NORMAL_SIZE] = (const uint8_t (*)[NORMAL_SIZE])SMALL_BALL_DATA;
-        // Двойной цикл точно как в Java
-        for (int b5 = b3; b5 < n; b5++) {
-            for (int b = b4; b < i1; b++) {
-                // Точная формула из Java: Math.abs() и обращение к ballData[b-m][b5-k]
-                int ballY = b - m;
-                int ballX = b5 - k;
-                if (ballY >= 0 && ballY < NORMAL_SIZE && ballX >= 0 && ballX < NORMAL_SIZE &&
-                    (TRI_TILE_DATA[abs(b - b2)][abs(b5 - b1)] & smallBallData[ballY][ballX]) != 0) {
-                    if (!p->mGroundedFlag) {
-                        redirectBall(p, tileID);
-                    }
-                    return true;
-                }
-            }
+    collision_shape_t shape = (collision_shape_t)(COLLIDE_RAMP_30 + ((tileID - 30) & 3));
+    if (shapeCollide(p, tileRow, tileCol, shape)) {
+        if (!p->mGroundedFlag) {
+            redirectBall(p, tileID);
         }
+        return true;
     }
-    
     return false;
 }
 
@@ -372,237 +318,799 @@ static void redirectBall(Player* p, int tileID) {
     }
 }
 
-// Полная функция проверки коллизий (портировано из Ball.java)
-static bool collisionDetection(Player* p, int testX, int testY) {
-    // Временно обновляем глобальные координаты для тестирования
+// Диапазон тайлов [x0,x1) x [y0,y1), которые collisionDetection проверяет для центра
+// мяча (testX, testY) (как в Java i,j,k,m). Границы монотонно не убывают по testX/testY.
+static inline void collision_tile_range_half(int half, int testX, int testY,
+                                             int* x0, int* y0, int* x1, int* y1) {
     int b = 0;
     if (testY < 0) {
         b = 12;
     }
-    
-    // Определяем диапазон тайлов для проверки (как в Java i,j,k,m в порядке Java)
-    int i = (testX - p->mHalfBallSize) / TILE_SIZE;
-    int j = (testY - b - p->mHalfBallSize) / TILE_SIZE;
+    *x0 = (testX - half) / TILE_SIZE;
+    *y0 = (testY - b - half) / TILE_SIZE;
+    *x1 = (testX - 1 + half) / TILE_SIZE + 1;
+    *y1 = (testY - b - 1 + half) / TILE_SIZE + 1;
+}
+
+static inline void collision_tile_range(const Player* p, int testX, int testY,
+                                        int* x0, int* y0, int* x1, int* y1) {
+    collision_tile_range_half(p->mHalfBallSize, testX, testY, x0, y0, x1, y1);
+}
+
+// Сколько смещений подряд, начиная с центра (x, y) и дальше по (dx, dy), кандидат
+// enlarge_ball() заведомо дает коллизию:
+//   ENLARGE_GONE - все тайлы диапазона за картой (testTile сразу возвращает false,
+//                  ничего не меняя), и с ростом смещения диапазон только удаляется,
+//                  или мяч лопнул (шипом по ходу поиска): тогда collisionDetection
+//                  дает коллизию, не глядя на тайлы, на любом смещении;
+//   N > 0        - по Level::clearance на N позициях центр мяча лежит в кирпиче
+//                  или резине, а в диапазоне только пустота, кирпич, резина и край
+//                  карты. collisionDetection() там меняет только mCDRampFlag и
+//                  mCDRubberFlag - их выставляет enlarge_run_flags();
+//   0            - результат неизвестен, нужен collisionDetection().
+// Особые тайлы (рампы, шипы, кольца, инфляторы...) так не пропускаются: их
+// проверка у кандидата может лопнуть мяч, сменить его размер или карту, и
+// оригинал делает ее на каждом смещении.
+static int enlarge_blocked_run(const SimContext* sim, int x, int y, int dx, int dy) {
+    const Player* p = &sim->player;
+    const Level* level = &sim->level;
+    if (p->ballState == BALL_STATE_POPPED) return ENLARGE_GONE;
+    int x0, y0, x1, y1;
+    collision_tile_range(p, x, y, &x0, &y0, &x1, &y1);
+    if ((dx < 0 && x1 <= 0) || (dx > 0 && x0 >= level->width) ||
+        (dy < 0 && y1 <= 0) || (dy > 0 && y0 >= level->height)) {
+        return ENLARGE_GONE;
+    }
+
+    // При x, y >= mHalfBallSize диапазон - тайлы не дальше одного от тайла центра
+    if (!level->clearanceReady || x < p->mHalfBallSize || y < p->mHalfBallSize) {
+        return 0;
+    }
+    int tx = x / TILE_SIZE;
+    int ty = y / TILE_SIZE;
+    if (tx >= level->width || ty >= level->height) return 0;
+
+    // Тайл центра может уйти на столько тайлов, что сам он остается кирпичом
+    // или резиной, а его соседи - не особыми тайлами
+    uint8_t c = level->clearance[ty * level->stride + tx];
+    int tiles = CLEARANCE_SOLID(c) - 1;
+    if (CLEARANCE_SPECIAL(c) - 2 < tiles) tiles = CLEARANCE_SPECIAL(c) - 2;
+    if (tiles < 0) return 0;
+
+    int reach = tiles * TILE_SIZE;
+    int run = INT_MAX;
+    if (dx < 0) {
+        run = reach + x % TILE_SIZE;
+        if (x - p->mHalfBallSize < run) run = x - p->mHalfBallSize;
+    } else if (dx > 0) {
+        run = reach + TILE_SIZE - 1 - x % TILE_SIZE;
+    }
+    if (dy < 0) {
+        int ry = reach + y % TILE_SIZE;
+        if (y - p->mHalfBallSize < ry) ry = y - p->mHalfBallSize;
+        if (ry < run) run = ry;
+    } else if (dy > 0) {
+        int ry = reach + TILE_SIZE - 1 - y % TILE_SIZE;
+        if (ry < run) run = ry;
+    }
+    return run + 1;  // Текущая позиция и еще run пикселей
+}
+
+// Флаги, которые выставили бы collisionDetection() кандидатов на count позициях
+// от (x, y) по (dx, dy) внутри пробега enlarge_blocked_run() > 0: кирпич и резина
+// без касания - mCDRampFlag, резина с касанием - mCDRubberFlag. collisionDetection
+// флаги только выставляет и не читает, поэтому порядок позиций не важен, а
+// проверка кончается, как только выставлять больше нечего.
+static void enlarge_run_flags(SimContext* sim, int x, int y, int dx, int dy, int count) {
+    Player* p = &sim->player;
+    const Level* level = &sim->level;
+
+    // Резина в объединении диапазонов первой и последней позиции
+    bool rubber = false;
+    if (!p->mCDRubberFlag) {
+        int x0, y0, x1, y1, bx0, by0, bx1, by1;
+        collision_tile_range(p, x, y, &x0, &y0, &x1, &y1);
+        collision_tile_range(p, x + dx * (count - 1), y + dy * (count - 1), &bx0, &by0, &bx1, &by1);
+        if (bx0 < x0) x0 = bx0;
+        if (by0 < y0) y0 = by0;
+        if (bx1 > x1) x1 = bx1;
+        if (by1 > y1) y1 = by1;
+        if (x1 > level->width) x1 = level->width;
+        if (y1 > level->height) y1 = level->height;
+        for (int ty = y0; ty < y1 && !rubber; ty++) {
+            for (int tx = x0; tx < x1; tx++) {
+                if (level->collisionClass[ty * level->stride + tx] == TILE_CLASS_RUBBER) {
+                    rubber = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    const uint32_t* square = g_collision_lut[p->ballSize == ENLARGED_SIZE][COLLIDE_SQUARE];
+    for (int k = 0; k < count && (!p->mCDRampFlag || (rubber && !p->mCDRubberFlag)); k++) {
+        int cx = x + dx * k;
+        int cy = y + dy * k;
+        int x0, y0, x1, y1;
+        collision_tile_range(p, cx, cy, &x0, &y0, &x1, &y1);
+        if (x1 > level->width) x1 = level->width;    // За картой флаги не ставятся
+        if (y1 > level->height) y1 = level->height;
+        for (int n = x0; n < x1; n++) {
+            for (int i1 = y0; i1 < y1; i1++) {
+                uint8_t cls = level->collisionClass[i1 * level->stride + n];
+                if (cls != TILE_CLASS_BRICK && cls != TILE_CLASS_RUBBER) continue;
+                if (collision_lut_test_rows(square, cx - p->mHalfBallSize - n * TILE_SIZE,
+                                            cy - p->mHalfBallSize - i1 * TILE_SIZE)) {
+                    if (cls == TILE_CLASS_RUBBER) p->mCDRubberFlag = true;
+                } else {
+                    p->mCDRampFlag = true;
+                }
+            }
+        }
+    }
+}
+
+// Заполнить Level::tileWindow для окна [x0, x1) x [y0, y1)
+static void tile_window_fill(Level* level, int x0, int y0, int x1, int y1) {
+    TileWindowCache* w = &level->tileWindow;
+    w->valid = true;
+    w->x0 = (short)x0;
+    w->y0 = (short)y0;
+    w->x1 = (short)x1;
+    w->y1 = (short)y1;
+    w->busyMask = 0;
+    int e = 0;
+    for (int x = x0; x < x1; x++) {
+        for (int y = y0; y < y1; y++, e++) {
+            uint8_t cls = TILE_WINDOW_OFF_MAP;
+            uint8_t id = 0;
+            if (x >= 0 && x < level->width && y >= 0 && y < level->height) {
+                cls = level->collisionClass[y * level->stride + x];
+                id = (uint8_t)(level_tile(level, x, y) & TILE_ID_MASK);
+            }
+            w->cls[e] = cls;
+            w->id[e] = id;
+            if (cls != TILE_CLASS_NONE) {
+                w->busyMask |= (uint16_t)(1u << e);
+            }
+        }
+    }
+    w->count = (uint8_t)e;
+}
+
+// Полная функция проверки коллизий (портировано из Ball.java) для мяча размера
+// size. size - константа в обоих вызовах из collisionDetection(), поэтому
+// компилятор строит две копии с постоянными полуразмером, границами окна и
+// строкой g_collision_lut. Классы и ID тайлов окна берутся из Level::tileWindow.
+// Обработчики особых тайлов могут лопнуть мяч, сменить его размер (инфлятор,
+// дефлятор, со своими collisionDetection) или карту - тогда остаток окна
+// проверяется через testTile(), как в исходном цикле.
+static inline bool collision_detection_sized(SimContext* sim, int testX, int testY, const int size) {
+    Player* p = &sim->player;
+    Level* level = &sim->level;
+    TileWindowCache* w = &level->tileWindow;
+    const int half = size / 2;
+    const uint32_t* square = g_collision_lut[size == ENLARGED_SIZE][COLLIDE_SQUARE];
+    PHYSICS_STAT(sim, collisionCalls, 1);
+
+    // Определяем диапазон тайлов для проверки (как в Java i,j,k,m в порядке Java),
+    // те же формулы, что в collision_tile_range()
+    int b = (testY < 0) ? 12 : 0;
+    int i = (testX - half) / TILE_SIZE;
+    int j = (testY - b - half) / TILE_SIZE;
+    int k = (testX - 1 + half) / TILE_SIZE + 1;
+    int m = (testY - b - 1 + half) / TILE_SIZE + 1;
     
     // Устанавливаем globalBallX/Y для squareCollide/triangleCollide
-    p->globalBallX = testX - p->mHalfBallSize;
-    p->globalBallY = testY - p->mHalfBallSize;
+    p->globalBallX = testX - half;
+    p->globalBallY = testY - half;
     
     // Смещения прокрутки экрана (в C нет прокрутки, добавляем 0 для соответствия Java)
     // В Java: if (this.xPos < this.mCanvas.divisorLine) { this.globalBallX += this.mCanvas.tileX * 12; ... }
     // В C нет прокрутки экрана, поэтому добавляем 0 (как если бы tileX=tileY=0)
-    
-    // Определяем конец диапазона
-    int k = (testX - 1 + p->mHalfBallSize) / TILE_SIZE + 1;
-    int m = (testY - b - 1 + p->mHalfBallSize) / TILE_SIZE + 1;
+
+    if (!w->valid || w->x0 != i || w->y0 != j || w->x1 != k || w->y1 != m) {
+        tile_window_fill(level, i, j, k, m);
+    }
+    if (p->ballState != BALL_STATE_POPPED && w->busyMask == 0) {
+        PHYSICS_STAT(sim, tileTests, w->count);
+        PHYSICS_STAT(sim, classTests[TILE_CLASS_NONE], w->count);
+        return true;  // Все тайлы окна пустые
+    }
     
     bool canMove = true;
+    bool cached = true;
 
     // Проверяем все пересекающиеся тайлы (как в Java n, i1)
     // Порядок обхода как в Java: X-снаружи, Y-внутри
     // НЕ прерываем при canMove == false, чтобы корректно выставлялись флаги
+    int e = 0;
     for (int n = i; n < k; n++) {
-        for (int i1 = j; i1 < m; i1++) {
-            canMove = testTile(p, i1, n, canMove);
+        for (int i1 = j; i1 < m; i1++, e++) {
+            if (!cached) {
+                canMove = testTile(sim, i1, n, canMove);
+                continue;
+            }
+
+            PHYSICS_STAT(sim, tileTests, 1);
+            uint8_t cls = w->cls[e];
+            if (cls == TILE_WINDOW_OFF_MAP || p->ballState == BALL_STATE_POPPED) {
+                canMove = false;  // Как testTile(): за картой или лопнутый мяч
+                continue;
+            }
+            PHYSICS_STAT(sim, classTests[cls], 1);
+            if (cls == TILE_CLASS_NONE) continue;
+            if (cls == TILE_CLASS_BRICK || cls == TILE_CLASS_RUBBER) {
+                // Как tile_brick/tile_rubber
+                if (collision_lut_test_rows(square, p->globalBallX - n * TILE_SIZE,
+                                            p->globalBallY - i1 * TILE_SIZE)) {
+                    if (cls == TILE_CLASS_RUBBER) p->mCDRubberFlag = true;
+                    canMove = false;
+                } else {
+                    p->mCDRampFlag = true;
+                }
+                continue;
+            }
+
+            canMove = test_tile_class(sim, i1, n, cls, w->id[e], canMove);
+            cached = w->valid && w->x0 == i && w->y0 == j && w->x1 == k && w->y1 == m &&
+                     p->ballSize == size;
         }
     }
     
     return canMove;
 }
 
-// Проверка конкретного тайла (портировано из Ball.java testTile)
-static bool testTile(Player* p, int tileY, int tileX, bool canMove) {
-    if (tileY >= g_level.height || tileY < 0 || tileX >= g_level.width || tileX < 0) {
-        return false;  // За пределами карты - коллизия
+static bool collisionDetection(SimContext* sim, int testX, int testY) {
+    if (sim->player.ballSize == ENLARGED_SIZE) {
+        return collision_detection_sized(sim, testX, testY, ENLARGED_SIZE);
     }
-    
+    return collision_detection_sized(sim, testX, testY, NORMAL_SIZE);
+}
+
+// --- Свободный полет ---
+// Если все тайлы, которые затронут steps подшагов (dx, dy) от текущей позиции,
+// лежат внутри карты и ни один collisionDetection в цикле не даст коллизии,
+// серию можно выполнить одним сдвигом. Пустые тайлы проходимы без побочных
+// эффектов; кирпич, резина и рампы проверяются по пиксельной карте уровня
+// (solid_bitmap.h), и без касания кирпич и резина только выставляют mCDRampFlag.
+
+// Диапазон тайлов [x0, x1) x [y0, y1) внутри карты и содержит не только пустоту
+static bool free_flight_solid_clear(Level* level, Player* p, int dx, int dy, int steps,
+                                    int x0, int y0, int x1, int y1) {
+    bool rampFlag = false;
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            uint8_t cls = level->collisionClass[y * level->stride + x];
+            if (cls == TILE_CLASS_BRICK || cls == TILE_CLASS_RUBBER) {
+                rampFlag = true;
+            } else if (cls != TILE_CLASS_NONE && cls != TILE_CLASS_RAMP) {
+                return false;
+            }
+        }
+    }
+
+    // Пиксели мяча левее или выше карты в пиксельной карте не представлены
+    int gx = p->xPos - p->mHalfBallSize;
+    int gy = p->yPos - p->mHalfBallSize;
+    if (gx + ((dx < 0) ? dx * steps : 0) < 0 || gy + ((dy < 0) ? dy * steps : 0) < 0 ||
+        solid_bitmap_sweep_hits(level, p->ballSize, gx, gy, dx, dy, steps)) {
+        return false;
+    }
+    if (rampFlag) {
+        p->mCDRampFlag = true;  // Как tile_brick/tile_rubber без касания
+    }
+    return true;
+}
+
+// Тайлы пути мяча из (x, y) на steps шагов (dx, dy): объединение диапазонов первой
+// и последней позиции покрывает все промежуточные. false, если путь задевает край
+// карты (там testTile дает коллизию).
+static inline bool free_flight_box(const Level* level, int half, int x, int y, int dx, int dy, int steps,
+                                   int* x0, int* y0, int* x1, int* y1) {
+    int ax0, ay0, ax1, ay1, bx0, by0, bx1, by1;
+    collision_tile_range_half(half, x + dx, y + dy, &ax0, &ay0, &ax1, &ay1);
+    collision_tile_range_half(half, x + dx * steps, y + dy * steps, &bx0, &by0, &bx1, &by1);
+    *x0 = (ax0 < bx0) ? ax0 : bx0;
+    *y0 = (ay0 < by0) ? ay0 : by0;
+    *x1 = (ax1 > bx1) ? ax1 : bx1;
+    *y1 = (ay1 > by1) ? ay1 : by1;
+    return *x0 >= 0 && *y0 >= 0 && *x1 <= level->width && *y1 <= level->height;
+}
+
+static bool free_flight_clear(Level* level, Player* p, int dx, int dy, int steps) {
     if (p->ballState == BALL_STATE_POPPED) {
-        return false;  // Лопнутый мяч не двигается и упирается в любое препятствие.
+        return false;  // testTile для лопнутого мяча всегда возвращает false
     }
-    
-    int tile = g_level.tileMap[tileY][tileX];
-    int tileID = tile & TILE_ID_MASK;  // Убираем флаги
-    
-    // Валидация ID против таблицы метаданных: неизвестные тайлы пропускаем.
-    if ((uint32_t)tileID >= tile_meta_count()) {
-        return canMove; // Неизвестный тайл - пропускаем
+
+    int x0, y0, x1, y1;
+    if (!free_flight_box(level, p->mHalfBallSize, p->xPos, p->yPos, dx, dy, steps, &x0, &y0, &x1, &y1)) {
+        return false;
     }
-    
-    // Прямая обработка коллизий по ID тайла (убран избыточный collision_type)
-    if (tileID == 1) {
-        // Кирпич ID 1 - точная копия Java case 1
-        if (squareCollide(p, tileY, tileX)) {
-            canMove = false;
-            // В оригинале Java: сразу break, без дополнительных действий
-        } else {
-            // Только если НЕТ коллизии - устанавливаем mCDRampFlag
-            p->mCDRampFlag = true;
-        }
-    } else if (tileID == 2) {
-        // Резиновый блок ID 2 - точная копия Java case 2
-        if (squareCollide(p, tileY, tileX)) {
-            p->mCDRubberFlag = true;
-            canMove = false;
-            // В оригинале Java: сразу break, без дополнительных действий
-        } else {
-            // В оригинале Java: mCDRampFlag = true ТОЛЬКО для case 2 при отсутствии коллизии
-            p->mCDRampFlag = true;
-        }
-    } else if (tileID >= 3 && tileID <= 6) {
-        // Шипы - используют thinCollide с ориентацией
-        if (thinCollide(p, tileY, tileX, tileID)) {
-            canMove = false;
-            pop_ball(p);  // Шипы лопают мяч (как в Java case 3,4,5,6)
-        }
-    } else if (tileID == 10) {
-        // Движущиеся шипы - коллизия с движущимся объектом
-        int objIndex = level_find_moving_object_at(tileX, tileY);
-        if (objIndex != -1) {
-            MovingObject* obj = level_get_moving_object(objIndex);
-            if (obj) {
-                // Вычисляем реальные координаты шипов как в Java
-                int spikeX = obj->topLeft[0] * TILE_SIZE + obj->offset[0];
-                int spikeY = obj->topLeft[1] * TILE_SIZE + obj->offset[1];
-                
-                // Проверяем пересечение мяча с областью шипов
-                if (rectCollide(p->globalBallX, p->globalBallY, 
-                               p->globalBallX + p->ballSize, p->globalBallY + p->ballSize,
-                               spikeX, spikeY, spikeX + MOVING_SPIKE_PX, spikeY + MOVING_SPIKE_PX)) {
-                    canMove = false;
-                    pop_ball(p);  // Движущиеся шипы лопают мяч (как в Java case 10)
-                }
+
+    // Проверка по пиксельной карте стоит примерно как один collisionDetection,
+    // поэтому для одного подшага она не окупается
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            if (level->collisionClass[y * level->stride + x] != TILE_CLASS_NONE) {
+                return steps > 1 && free_flight_solid_clear(level, p, dx, dy, steps, x0, y0, x1, y1);
             }
         }
-    } else if (tileID >= 13 && tileID <= 24) {
-        // Кольца (13-24) - используют thinCollide с специальной логикой
-        if (thinCollide(p, tileY, tileX, tileID)) {
-            // Большой мяч не может пройти через маленькие кольца (как в Java ballSize == 16)
-            if ((tileID == 13 || tileID == 14 || tileID == 15 || tileID == 16 || tileID == 17 || tileID == 18 || tileID == 19 || tileID == 20) && p->sizeState == LARGE_SIZE_STATE) {
+    }
+    return true;
+}
+
+// Вертикальная фаза целиком за один шаг (эквивалент Y-цикла без коллизий)
+static bool free_flight_y(Level* level, Player* p) {
+    int steps = abs(p->ySpeed) / MOVEMENT_STEP_DIVISOR;
+    if (steps == 0) return false;
+    int yStep = (p->ySpeed < 0) ? -1 : 1;
+    if (!free_flight_clear(level, p, 0, yStep, steps)) return false;
+
+    p->yPos += yStep * steps;
+    p->mGroundedFlag = false;
+    // Как после последнего collisionDetection цикла
+    p->globalBallX = p->xPos - p->mHalfBallSize;
+    p->globalBallY = p->yPos - p->mHalfBallSize;
+    return true;
+}
+
+// Горизонтальная фаза целиком за один шаг (эквивалент X-цикла без коллизий)
+static bool free_flight_x(Level* level, Player* p, int steps) {
+    if (steps == 0) return false;
+    int xStep = (p->xSpeed < 0) ? -1 : 1;
+    if (!free_flight_clear(level, p, xStep, 0, steps)) return false;
+
+    p->xPos += xStep * steps;
+    p->globalBallX = p->xPos - p->mHalfBallSize;
+    p->globalBallY = p->yPos - p->mHalfBallSize;
+    return true;
+}
+
+#ifdef PHYSICS_CHECK_FAST_PATH
+// Отладочный режим: быстрый путь считается на копии, игра идет по эталонному
+// циклу, и после каждой фазы состояния сравниваются побайтно.
+static void check_fast_path(const Player* fast, const Player* ref, const char* phase) {
+    if (memcmp(fast, ref, sizeof(Player)) != 0) {
+        fprintf(stderr, "physics: free-flight %s mismatch: fast pos=(%d,%d) ref pos=(%d,%d)\n",
+                phase, fast->xPos, fast->yPos, ref->xPos, ref->yPos);
+        abort();
+    }
+}
+#endif
+
+// --- Обработчики testTile по классам коллизий (TileCollisionClass) ---
+// Каждый обработчик получает текущий canMove и возвращает новый, как ветка
+// исходного if/else + switch из Ball.java testTile.
+
+// Кирпич ID 1 - точная копия Java case 1
+static bool tile_brick(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    (void)tileID;
+    if (squareCollide(p, tileY, tileX)) {
+        return false;  // В оригинале Java: сразу break, без дополнительных действий
+    }
+    // Только если НЕТ коллизии - устанавливаем mCDRampFlag
+    p->mCDRampFlag = true;
+    return canMove;
+}
+
+// Резиновый блок ID 2 - точная копия Java case 2
+static bool tile_rubber(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    (void)tileID;
+    if (squareCollide(p, tileY, tileX)) {
+        p->mCDRubberFlag = true;
+        return false;
+    }
+    // В оригинале Java: mCDRampFlag = true ТОЛЬКО для case 2 при отсутствии коллизии
+    p->mCDRampFlag = true;
+    return canMove;
+}
+
+// Шипы - используют thinCollide с ориентацией
+static bool tile_spike(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    if (thinCollide(p, tileY, tileX, tileID)) {
+        canMove = false;
+        pop_ball(sim);  // Шипы лопают мяч (как в Java case 3,4,5,6)
+    }
+    return canMove;
+}
+
+// Движущиеся шипы - коллизия с движущимся объектом
+static bool tile_moving_spike(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    (void)tileID;
+    int objIndex = level_find_moving_object_at(&sim->level, tileX, tileY);
+    if (objIndex != -1) {
+        MovingObject* obj = level_get_moving_object(&sim->level, objIndex);
+        if (obj) {
+            // Вычисляем реальные координаты шипов как в Java
+            int spikeX = obj->topLeft[0] * TILE_SIZE + obj->offset[0];
+            int spikeY = obj->topLeft[1] * TILE_SIZE + obj->offset[1];
+
+            // Проверяем пересечение мяча с областью шипов
+            if (rectCollide(p->globalBallX, p->globalBallY,
+                           p->globalBallX + p->ballSize, p->globalBallY + p->ballSize,
+                           spikeX, spikeY, spikeX + MOVING_SPIKE_PX, spikeY + MOVING_SPIKE_PX)) {
                 canMove = false;
-            } else {
-                // Нижняя половина вертикального кольца пропускает мяч без твердой кромки.
-                if (tileID == 14 || tileID == 18 || tileID == 22) {
-                    // Свободный проход через нижнюю часть кольца
-                    if (tileID == 14 || tileID == 22) {
-                        // Активные кольца - засчитываем проход
-                        game_ring_collected(tileX, tileY, tileID);
-                    }
-                    // Неактивная нижняя половина кольца дает только проход без сбора.
-                } else {
-                    // Остальные кольца проверяют edgeCollide для блокировки при касании края
-                    bool edgeHit = edgeCollide(p, tileY, tileX, tileID);
-                    if (edgeHit) {
-                        canMove = false;
-                    }
-                    // ID 23: Pattern A — сбор только если НЕТ касания края (Java офсет 652-661)
-                    // ID 13,15,16,21,24: Pattern B — сбор всегда, независимо от края (Java офсет 1087-1093 и аналоги)
-                    if (tileID == 23) {
-                        if (!edgeHit) {
-                            game_ring_collected(tileX, tileY, tileID);
-                        }
-                    } else if ((tileID >= 13 && tileID <= 16) || (tileID >= 21 && tileID <= 24)) {
-                        game_ring_collected(tileX, tileY, tileID);
-                    }
-                }
-                // canMove может быть false если попали в край кольца
+                pop_ball(sim);  // Движущиеся шипы лопают мяч (как в Java case 10)
             }
         }
-    } else if (tileID == 25 || tileID == 27 || tileID == 28) {
-        // Большие неактивные кольца (Java case 25,27,28) - ТОЛЬКО edgeCollide
-        if (edgeCollide(p, tileY, tileX, tileID)) {
-            canMove = false; // Java: paramBoolean = false
+    }
+    return canMove;
+}
+
+// Кольца (13-24) - используют thinCollide с специальной логикой
+static bool tile_hoop(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    if (!thinCollide(p, tileY, tileX, tileID)) {
+        return canMove;
+    }
+
+    // Большой мяч не может пройти через маленькие кольца (как в Java ballSize == 16)
+    if (tileID <= 20 && p->sizeState == LARGE_SIZE_STATE) {
+        return false;
+    }
+
+    // Нижняя половина вертикального кольца пропускает мяч без твердой кромки.
+    if (tileID == 14 || tileID == 18 || tileID == 22) {
+        // Свободный проход через нижнюю часть кольца
+        if (tileID == 14 || tileID == 22) {
+            // Активные кольца - засчитываем проход
+            game_ring_collected(sim, tileX, tileY, tileID);
+        }
+        // Неактивная нижняя половина кольца дает только проход без сбора.
+        return canMove;
+    }
+
+    // Остальные кольца проверяют edgeCollide для блокировки при касании края
+    bool edgeHit = edgeCollide(p, tileY, tileX, tileID);
+    if (edgeHit) {
+        canMove = false;
+    }
+    // ID 23: Pattern A — сбор только если НЕТ касания края (Java офсет 652-661)
+    // ID 13,15,16,21,24: Pattern B — сбор всегда, независимо от края (Java офсет 1087-1093 и аналоги)
+    if (tileID == 23) {
+        if (!edgeHit) {
+            game_ring_collected(sim, tileX, tileY, tileID);
+        }
+    } else if ((tileID >= 13 && tileID <= 16) || (tileID >= 21 && tileID <= 24)) {
+        game_ring_collected(sim, tileX, tileY, tileID);
+    }
+    // canMove может быть false если попали в край кольца
+    return canMove;
+}
+
+// Большие неактивные кольца (Java case 25,27,28) - ТОЛЬКО edgeCollide
+static bool tile_hoop_edge(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    if (edgeCollide(p, tileY, tileX, tileID)) {
+        canMove = false; // Java: paramBoolean = false
+    }
+    return canMove;
+}
+
+// Рампы - используют triangleCollide
+static bool tile_ramp(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    if (triangleCollide(p, tileY, tileX, tileID)) {
+        canMove = false;
+        p->mCDRampFlag = true;
+
+        // Резиновые рампы ID 34-37 устанавливают mCDRubberFlag (как в Java case 34,35,36,37)
+        if (tileID >= 34) {
+            p->mCDRubberFlag = true;
+        }
+    }
+    return canMove;
+}
+
+// Тайл бонуса скорости
+static bool tile_speed(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    (void)canMove;
+    p->speedBonusCntr = BONUS_DURATION; // Java: this.speedBonusCntr = 300
+    sim_event_push(sim, SIM_EVENT_BONUS, tileX, tileY, tileID); // Java: sound = this.mCanvas.mSoundPickup
+    return false; // Java: paramBoolean = false
+}
+
+// Тайлы уменьшения мяча (deflator) - блокируют движение
+static bool tile_deflator(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    (void)tileY; (void)tileX; (void)tileID; (void)canMove;
+    if (p->ballSize == ENLARGED_SIZE) { // Java: только большой мяч
+        shrink_ball(sim);
+    }
+    return false; // Java: paramBoolean = false
+}
+
+// Тайлы увеличения мяча (inflator) - используют thinCollide как в Java
+static bool tile_inflator(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    if (thinCollide(p, tileY, tileX, tileID)) {
+        canMove = false; // Java: paramBoolean = false
+        if (p->ballSize == NORMAL_SIZE) { // Java: только маленький мяч (ballSize == 12)
+            enlarge_ball(sim);
         }
-    } else if (tileID >= 30 && tileID <= 37) {
-        // Рампы - используют triangleCollide
-        if (triangleCollide(p, tileY, tileX, tileID)) {
+    }
+    return canMove;
+}
+
+// Чекпоинт (Java case 7: строки 633-639)
+static bool tile_checkpoint(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    (void)tileID;
+    game_add_score(sim, 200);             // add2Score(200) - как в оригинале!
+    game_set_respawn(sim, tileX, tileY);  // Событие: чекпоинт активирован
+    return canMove;
+}
+
+// Выход (Java case 9, офсет 1372-1415: сначала thinCollide, потом проверка двери)
+static bool tile_exit(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    if (thinCollide(p, tileY, tileX, tileID)) {
+        if (game_exit_is_open(sim)) {
+            game_complete_level(sim);
+        } else {
             canMove = false;
-            p->mCDRampFlag = true;
-            
-            // Резиновые рампы ID 34-37 устанавливают mCDRubberFlag (как в Java case 34,35,36,37)
-            if (tileID >= 34 && tileID <= 37) {
-                p->mCDRubberFlag = true;
-            }
         }
     }
-    // Остальные тайлы (ID 0, 7-9, 17-20, 25-29, etc.) - проходимые, без коллизий
+    return canMove;
+}
+
+// Дополнительная жизнь (Java case 29: Ball.java:800-810)
+static bool tile_extra_life(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    (void)tileID;
+    game_add_extra_life(sim);  // Событие: дополнительная жизнь собрана
+    level_set_id(&sim->level, tileX, tileY, 0);  // Убираем тайл (Java: = 128, у нас 0 = пустота)
+    return canMove;
+}
+
+// Бонусы гравитации (Java case 47-50: gravBonusCntr = 300)
+static bool tile_gravity(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    (void)canMove;
+    p->gravBonusCntr = BONUS_DURATION; // Java: this.gravBonusCntr = 300
+    sim_event_push(sim, SIM_EVENT_BONUS, tileX, tileY, tileID);
+    return false; // Java: paramBoolean = false
+}
+
+// Бонусы прыжков (Java case 51-54: jumpBonusCntr = 300)
+static bool tile_jump(SimContext* sim, int tileY, int tileX, int tileID, bool canMove) {
+    Player* p = &sim->player;
+    (void)canMove;
+    p->jumpBonusCntr = BONUS_DURATION; // Java: this.jumpBonusCntr = 300
+    sim_event_push(sim, SIM_EVENT_BONUS, tileX, tileY, tileID);
+    return false; // Java: paramBoolean = false
+}
+
+// Обработчик тайла по уже известному классу и ID (без флагов)
+static bool test_tile_class(SimContext* sim, int tileY, int tileX, uint8_t cls, int tileID, bool canMove) {
+    if (cls == TILE_CLASS_NONE) {
+        return canMove;  // Проходимый тайл (включая неизвестные ID) - без действий
+    }
+    switch ((TileCollisionClass)cls) {
+        case TILE_CLASS_BRICK:        return tile_brick(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_RUBBER:       return tile_rubber(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_SPIKE:        return tile_spike(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_CHECKPOINT:   return tile_checkpoint(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_EXIT:         return tile_exit(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_MOVING_SPIKE: return tile_moving_spike(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_HOOP:         return tile_hoop(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_HOOP_EDGE:    return tile_hoop_edge(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_EXTRA_LIFE:   return tile_extra_life(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_RAMP:         return tile_ramp(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_SPEED:        return tile_speed(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_DEFLATOR:     return tile_deflator(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_INFLATOR:     return tile_inflator(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_GRAVITY:      return tile_gravity(sim, tileY, tileX, tileID, canMove);
+        case TILE_CLASS_JUMP:         return tile_jump(sim, tileY, tileX, tileID, canMove);
+        default:                      return canMove;
+    }
+}
+
+// Проверка конкретного тайла (портировано из Ball.java testTile)
+// Класс тайла берется из sim->level.collisionClass, построенного при загрузке уровня:
+// пустые тайлы и кирпич проверяются первыми, остальные классы - плотный switch,
+// который компилятор сводит к таблице переходов.
+static bool testTile(SimContext* sim, int tileY, int tileX, bool canMove) {
+    const Level* level = &sim->level;
+    PHYSICS_STAT(sim, tileTests, 1);
+    if (tileY >= level->height || tileY < 0 || tileX >= level->width || tileX < 0) {
+        return false;  // За пределами карты - коллизия
+    }
     
-    // Специальная логика для specific тайлов (не зависит от коллизии)
-    switch (tileID) {
-            
-        // Тайл бонуса скорости
-        case TILE_SPEED_BONUS:
-            canMove = false; // Java: paramBoolean = false
-            p->speedBonusCntr = BONUS_DURATION; // Java: this.speedBonusCntr = 300
-            sound_play_pickup(); // Java: sound = this.mCanvas.mSoundPickup
-            break;
+    if (sim->player.ballState == BALL_STATE_POPPED) {
+        return false;  // Лопнутый мяч не двигается и упирается в любое препятствие.
+    }
+    
+    uint8_t cls = level->collisionClass[tileY * level->stride + tileX];
+    PHYSICS_STAT(sim, classTests[cls], 1);
+    if (cls == TILE_CLASS_NONE) {
+        return canMove;
+    }
+    if (cls == TILE_CLASS_BRICK) {
+        return tile_brick(sim, tileY, tileX, TILE_BRICK_RED, canMove);
+    }
+    
+    int tileID = level_tile(level, tileX, tileY) & TILE_ID_MASK;  // Убираем флаги
+    return test_tile_class(sim, tileY, tileX, cls, tileID, canMove);
+}
+
+
+// Фаза Y: подшаги по вертикали с коллизиями. tileX - столбец центра мяча в начале
+// тика (по нему подводный большой мяч проверяет выход из воды, как m в Java).
+static void player_move_y(SimContext* sim, int gravity, bool reverseGrav, int tileX) {
+    Player* p = &sim->player;
+    Level* level = &sim->level;
+    // Свободный полет выполняется одним сдвигом; подводный большой мяч проверяет
+    // воду на каждом подшаге, поэтому всегда идет по циклу.
+    bool fastY = false;
+#ifdef PHYSICS_CHECK_FAST_PATH
+    Player checkY;
+    memcpy(&checkY, p, sizeof(Player));
+    bool checkFastY = (gravity != UWATER_LARGE_MAX_GRAVITY) && free_flight_y(level, &checkY);
+#else
+    fastY = (gravity != UWATER_LARGE_MAX_GRAVITY) && free_flight_y(level, p);
+#endif
+    if (fastY) PHYSICS_STAT(sim, fastSubstepsY, abs(p->ySpeed) / MOVEMENT_STEP_DIVISOR);
+    for (int i = 0; !fastY && i < abs(p->ySpeed) / MOVEMENT_STEP_DIVISOR; i++) {
+        int yStep = 0;
+        if (p->ySpeed != 0) {
+            yStep = (p->ySpeed < 0) ? -1 : 1;
+        }
+        PHYSICS_STAT(sim, substepsY, 1);
+        
+        // Попытка движения (Java 989)
+        bool canMoveY = collisionDetection(sim, p->xPos, p->yPos + yStep);
+        if (canMoveY) {
+            p->yPos += yStep;
+            p->mGroundedFlag = false;
             
-        // Тайлы уменьшения мяча (deflator) - блокируют движение
-        case TILE_DEFLATOR_FLOOR: case TILE_DEFLATOR_LEFT_WALL: case TILE_DEFLATOR_CEILING: case TILE_DEFLATOR_RIGHT_WALL:
-            canMove = false; // Java: paramBoolean = false
-            if (p->ballSize == ENLARGED_SIZE) { // Java: только большой мяч
-                shrink_ball(p);
+            // Специальная логика для подводного большого мяча (Java 995-1006)
+            if (gravity == UWATER_LARGE_MAX_GRAVITY) { // Подводный большой мяч
+                // Java 996: n = this.mCanvas.tileY + this.yPos / 12
+                // Пересчитывается только Y, X остаётся фиксированным (m от начала кадра)
+                int unused_tileX, currentTileY;
+                player_center_tile(p, &unused_tileX, &currentTileY);
+                
+                if (currentTileY >= 0 && currentTileY < level->height && 
+                    tileX >= 0 && tileX < level->width) {  // tileX от центра мяча (как m в Java)
+                    int currentTile = level_tile(level, tileX, currentTileY);
+                    if ((currentTile & TILE_FLAG_WATER) == 0) {
+                        // Вышел из воды - замедляемся
+                        p->ySpeed >>= 1;
+                        if (p->ySpeed <= MIN_BOUNCE_SPEED && p->ySpeed >= -MIN_BOUNCE_SPEED) {
+                            p->ySpeed = 0;
+                        }
+                    }
+                }
+            }
+        } else {
+            // Коллизия - пытаемся скользить по рампе (Java 1011-1025)
+            // Канон Java: условие только по mCDRampFlag, xSpeed < 10 и slideCntr == 0
+            if (p->mCDRampFlag && p->xSpeed < 10 && p->slideCntr == 0) {
+                int slideStep = 1;
+                if (collisionDetection(sim, p->xPos + slideStep, p->yPos + yStep)) {
+                    p->xPos += slideStep;
+                    p->yPos += yStep;
+                    p->mCDRampFlag = false;
+                    PHYSICS_STAT(sim, rampSlides, 1);
+                } else if (collisionDetection(sim, p->xPos - slideStep, p->yPos + yStep)) {
+                    p->xPos -= slideStep;
+                    p->yPos += yStep;
+                    p->mCDRampFlag = false;
+                    PHYSICS_STAT(sim, rampSlides, 1);
+                }
             }
-            break;
             
-        // Тайлы увеличения мяча (inflator) - используют thinCollide как в Java
-        case TILE_INFLATOR_FLOOR: case TILE_INFLATOR_LEFT_WALL: case TILE_INFLATOR_CEILING: case TILE_INFLATOR_RIGHT_WALL:
-            if (thinCollide(p, tileY, tileX, tileID)) {
-                canMove = false; // Java: paramBoolean = false
-                if (p->ballSize == NORMAL_SIZE) { // Java: только маленький мяч (ballSize == 12)
-                    enlarge_ball(p);
+            // Отскок от препятствия (Java 1027-1055)
+            if (yStep > 0 || (reverseGrav && yStep < 0)) {
+                // Отскок от пола/препятствия (Java: this.ySpeed = this.ySpeed * -1 / 2)
+                // ВАЖНО: умножение на -1 ДО деления даёт правильное округление к нулю
+                p->ySpeed = p->ySpeed * -1 / 2;
+                p->mGroundedFlag = true;
+                
+                // Резиновый отскок (Java 1032-1042)
+                if (p->mCDRubberFlag && (p->direction & MOVE_UP)) {
+                    p->mCDRubberFlag = false;
+                    if (reverseGrav) {
+                        p->jumpOffset += MIN_BOUNCE_SPEED;
+                    } else {
+                        p->jumpOffset += -MIN_BOUNCE_SPEED;
+                    }
+                } else if (p->jumpBonusCntr == 0) {
+                    p->jumpOffset = 0;
                 }
+                
+                // Нормализация скорости отскока (Java 1046-1051)
+                if (p->ySpeed < MIN_BOUNCE_SPEED && p->ySpeed > -MIN_BOUNCE_SPEED) {
+                    if (reverseGrav) {
+                        p->ySpeed = -MIN_BOUNCE_SPEED;
+                    } else {
+                        p->ySpeed = MIN_BOUNCE_SPEED;
+                    }
+                }
+                break;
             }
-            break;
-        
-        // Чекпоинт (Java case 7: строки 633-639)
-        case TILE_CHECKPOINT:
-            game_add_score(200);             // add2Score(200) - как в оригинале!
-            game_set_respawn(tileX, tileY);  // Событие: чекпоинт активирован
-            break;
             
-        // Выход (Java case 9, офсет 1372-1415: сначала thinCollide, потом проверка двери)
-        case TILE_EXIT:
-            if (thinCollide(p, tileY, tileX, tileID)) {
-                if (game_exit_is_open()) {
-                    game_complete_level();
+            // Удар о потолок (Java 1057-1067)
+            if (yStep < 0 || (reverseGrav && yStep > 0)) {
+                if (reverseGrav) {
+                    p->ySpeed = -ROOF_COLLISION_SPEED;
                 } else {
-                    canMove = false;
+                    p->ySpeed = ROOF_COLLISION_SPEED;
                 }
             }
-            break;
-            
-        // Дополнительная жизнь (Java case 29: Ball.java:800-810)
-        case TILE_EXTRA_LIFE:
-            game_add_extra_life();  // Событие: дополнительная жизнь собрана
-            level_set_id(tileX, tileY, 0);  // Убираем тайл (Java: = 128, у нас 0 = пустота)
-            break;
-        
-        
-        // Бонусы гравитации (Java case 47-50: gravBonusCntr = 300)
-        case TILE_GRAVITY_FLOOR: case TILE_GRAVITY_LEFT_WALL: case TILE_GRAVITY_CEILING: case TILE_GRAVITY_RIGHT_WALL:
-            canMove = false; // Java: paramBoolean = false
-            p->gravBonusCntr = BONUS_DURATION; // Java: this.gravBonusCntr = 300
-            sound_play_pickup();
-            break;
-            
-        // Бонусы прыжков (Java case 51-54: jumpBonusCntr = 300)
-        case TILE_JUMP_FLOOR: case TILE_JUMP_LEFT_WALL: case TILE_JUMP_CEILING: case TILE_JUMP_RIGHT_WALL:
-            canMove = false; // Java: paramBoolean = false
-            p->jumpBonusCntr = BONUS_DURATION; // Java: this.jumpBonusCntr = 300
-            sound_play_pickup();
-            break;
-        
-        default:
-            // Остальные неизвестные тайлы пропускаем (как пустые)
-            break;
+        }
     }
     
-    return canMove;  // Возвращаем текущее состояние
+#ifdef PHYSICS_CHECK_FAST_PATH
+    if (checkFastY) check_fast_path(&checkY, p, "Y");
+#endif
 }
 
+// Фаза X: подшаги по горизонтали с коллизиями и скольжением по рампам
+static void player_move_x(SimContext* sim, bool reverseGrav) {
+    Player* p = &sim->player;
+    Level* level = &sim->level;
+    // Число X-подшагов вычисляется один раз до входа в цикл.
+    int xStepCount = abs(p->xSpeed) / MOVEMENT_STEP_DIVISOR;
+    bool fastX = false;
+#ifdef PHYSICS_CHECK_FAST_PATH
+    Player checkX;
+    memcpy(&checkX, p, sizeof(Player));
+    bool checkFastX = free_flight_x(level, &checkX, xStepCount);
+#else
+    fastX = free_flight_x(level, p, xStepCount);
+#endif
+    if (fastX) PHYSICS_STAT(sim, fastSubstepsX, xStepCount);
+    for (int i = 0; !fastX && i < xStepCount; i++) {
+        int xStep = 0;
+        if (p->xSpeed != 0) {
+            xStep = (p->xSpeed < 0) ? -1 : 1;
+        }
+        PHYSICS_STAT(sim, substepsX, 1);
+        
+        // Обычное движение по X.
+        if (collisionDetection(sim, p->xPos + xStep, p->yPos)) {
+            p->xPos += xStep;
+        } else if (p->mCDRampFlag) {
+            // Диагональное скольжение по рампе.
+            p->mCDRampFlag = false; // Флаг может быть выставлен заново внутри collisionDetection().
+            int diagonalStep = reverseGrav ? 1 : -1;
+
+            // Пробуем диагональ 1: (xStep, diagonalStep)
+            if (collisionDetection(sim, p->xPos + xStep, p->yPos + diagonalStep)) {
+                p->xPos += xStep;
+                p->yPos += diagonalStep;
+                PHYSICS_STAT(sim, rampSlides, 1);
+            }
+            // Пробуем диагональ 2: (xStep, -diagonalStep)
+            else if (collisionDetection(sim, p->xPos + xStep, p->yPos - diagonalStep)) {
+                p->xPos += xStep;
+                p->yPos -= diagonalStep;
+                PHYSICS_STAT(sim, rampSlides, 1);
+            }
+            // Оригинал: если обе диагонали заблокированы, развернуть и вдвое
+            // уменьшить горизонтальную скорость (Ball bytecode 1536-1544).
+            else {
+                p->xSpeed = -(p->xSpeed >> 1);
+            }
+        }
+        // Без рампы движение по X просто блокируется, скорость не меняется.
+    }
+#ifdef PHYSICS_CHECK_FAST_PATH
+    if (checkFastX) check_fast_path(&checkX, p, "X");
+#endif
+}
 
 // Основная физика игрока, сохраненная близкой к оригиналу.
-void player_update(Player* p) {
+void player_update(SimContext* sim) {
+    Player* p = &sim->player;
+    Level* level = &sim->level;  // Не const: free_flight_* достраивают Level::solidRows
+    PHYSICS_STAT(sim, updates, 1);
     // Обработка анимации лопания.
     if (p->ballState == BALL_STATE_POPPED) {
         p->popCntr--;       // Уменьшаем счетчик анимации
@@ -628,8 +1136,8 @@ void player_update(Player* p) {
     int tileX, tileY;
     player_center_tile(p, &tileX, &tileY);
     
-    if (tileX >= 0 && tileX < g_level.width && tileY >= 0 && tileY < g_level.height) {
-        int tile = g_level.tileMap[tileY][tileX];
+    if (tileX >= 0 && tileX < level->width && tileY >= 0 && tileY < level->height) {
+        int tile = level_tile(level, tileX, tileY);
         p->isInWater = (tile & TILE_FLAG_WATER) ? true : false;
     } else {
         p->isInWater = false;
@@ -693,94 +1201,8 @@ void player_update(Player* p) {
     clamp_speed(p);
     
     // === ФИЗИКА ПО ОСИ Y ===
-    for (int i = 0; i < abs(p->ySpeed) / MOVEMENT_STEP_DIVISOR; i++) {
-        int yStep = 0;
-        if (p->ySpeed != 0) {
-            yStep = (p->ySpeed < 0) ? -1 : 1;
-        }
-        
-        // Попытка движения (Java 989)
-        bool canMoveY = collisionDetection(p, p->xPos, p->yPos + yStep);
-        if (canMoveY) {
-            p->yPos += yStep;
-            p->mGroundedFlag = false;
-            
-            // Специальная логика для подводного большого мяча (Java 995-1006)
-            if (gravity == -30) { // Подводный большой мяч
-                // Java 996: n = this.mCanvas.tileY + this.yPos / 12
-                // Пересчитывается только Y, X остаётся фиксированным (m от начала кадра)
-                int unused_tileX, currentTileY;
-                player_center_tile(p, &unused_tileX, &currentTileY);
-                
-                if (currentTileY >= 0 && currentTileY < g_level.height && 
-                    tileX >= 0 && tileX < g_level.width) {  // tileX от центра мяча (как m в Java)
-                    int currentTile = g_level.tileMap[currentTileY][tileX];
-                    if ((currentTile & TILE_FLAG_WATER) == 0) {
-                        // Вышел из воды - замедляемся
-                        p->ySpeed >>= 1;
-                        if (p->ySpeed <= MIN_BOUNCE_SPEED && p->ySpeed >= -MIN_BOUNCE_SPEED) {
-                            p->ySpeed = 0;
-                        }
-                    }
-                }
-            }
-        } else {
-            // Коллизия - пытаемся скользить по рампе (Java 1011-1025)
-            // Канон Java: условие только по mCDRampFlag, xSpeed < 10 и slideCntr == 0
-            if (p->mCDRampFlag && p->xSpeed < 10 && p->slideCntr == 0) {
-                int slideStep = 1;
-                if (collisionDetection(p, p->xPos + slideStep, p->yPos + yStep)) {
-                    p->xPos += slideStep;
-                    p->yPos += yStep;
-                    p->mCDRampFlag = false;
-                } else if (collisionDetection(p, p->xPos - slideStep, p->yPos + yStep)) {
-                    p->xPos -= slideStep;
-                    p->yPos += yStep;
-                    p->mCDRampFlag = false;
-                }
-            }
-            
-            // Отскок от препятствия (Java 1027-1055)
-            if (yStep > 0 || (reverseGrav && yStep < 0)) {
-                // Отскок от пола/препятствия (Java: this.ySpeed = this.ySpeed * -1 / 2)
-                // ВАЖНО: умножение на -1 ДО деления даёт правильное округление к нулю
-                p->ySpeed = p->ySpeed * -1 / 2;
-                p->mGroundedFlag = true;
-                
-                // Резиновый отскок (Java 1032-1042)
-                if (p->mCDRubberFlag && (p->direction & MOVE_UP)) {
-                    p->mCDRubberFlag = false;
-                    if (reverseGrav) {
-                        p->jumpOffset += MIN_BOUNCE_SPEED;
-                    } else {
-                        p->jumpOffset += -MIN_BOUNCE_SPEED;
-                    }
-                } else if (p->jumpBonusCntr == 0) {
-                    p->jumpOffset = 0;
-                }
-                
-                // Нормализация скорости отскока (Java 1046-1051)
-                if (p->ySpeed < MIN_BOUNCE_SPEED && p->ySpeed > -MIN_BOUNCE_SPEED) {
-                    if (reverseGrav) {
-                        p->ySpeed = -MIN_BOUNCE_SPEED;
-                    } else {
-                        p->ySpeed = MIN_BOUNCE_SPEED;
-                    }
-                }
-                break;
-            }
-            
-            // Удар о потолок (Java 1057-1067)
-            if (yStep < 0 || (reverseGrav && yStep > 0)) {
-                if (reverseGrav) {
-                    p->ySpeed = -ROOF_COLLISION_SPEED;
-                } else {
-                    p->ySpeed = ROOF_COLLISION_SPEED;
-                }
-            }
-        }
-    }
-    
+    player_move_y(sim, gravity, reverseGrav, tileX);
+
     // Применение гравитации (Java 1071-1082) - выполняется всегда после Y-фазы
     if (reverseGrav) {
         if (gravityStep == -2 && p->ySpeed < gravity) { // Подводный большой мяч
@@ -834,41 +1256,7 @@ void player_update(Player* p) {
     }
     
     // === ФИЗИКА ПО ОСИ X ===
-    // Число X-подшагов вычисляется один раз до входа в цикл.
-    int xStepCount = abs(p->xSpeed) / MOVEMENT_STEP_DIVISOR;
-    for (int i = 0; i < xStepCount; i++) {
-        int xStep = 0;
-        if (p->xSpeed != 0) {
-            xStep = (p->xSpeed < 0) ? -1 : 1;
-        }
-        
-        // Обычное движение по X.
-        if (collisionDetection(p, p->xPos + xStep, p->yPos)) {
-            p->xPos += xStep;
-        } else if (p->mCDRampFlag) {
-            // Диагональное скольжение по рампе.
-            p->mCDRampFlag = false; // Флаг может быть выставлен заново внутри collisionDetection().
-            int diagonalStep = reverseGrav ? 1 : -1;
-
-            // Пробуем диагональ 1: (xStep, diagonalStep)
-            if (collisionDetection(p, p->xPos + xStep, p->yPos + diagonalStep)) {
-                p->xPos += xStep;
-                p->yPos += diagonalStep;
-            }
-            // Пробуем диагональ 2: (xStep, -diagonalStep)
-            else if (collisionDetection(p, p->xPos + xStep, p->yPos - diagonalStep)) {
-                p->xPos += xStep;
-                p->yPos -= diagonalStep;
-            }
-            // Оригинал: если обе диагонали заблокированы, развернуть и вдвое
-            // уменьшить горизонтальную скорость (Ball bytecode 1536-1544).
-            else {
-                p->xSpeed = -(p->xSpeed >> 1);
-            }
-        }
-        // Без рампы движение по X просто блокируется, скорость не меняется.
-    }
-
+    player_move_x(sim, reverseGrav);
 }
 
 static bool rectCollide(int x1, int y1, int x2, int y2, int rx1, int ry1, int rx2, int ry2) {
@@ -876,13 +1264,8 @@ static bool rectCollide(int x1, int y1, int x2, int y2, int rx1, int ry1, int rx
 }
 
 // Тонкие коллизии универсальные на основе ориентации тайла (улучшенная версия Java thinCollide)
+// Сужение прямоугольника тайла (Ball.java:520-538) заложено в формы COLLIDE_THIN_*.
 static bool thinCollide(Player* p, int tileRow, int tileCol, int tileID) {
-    int tilePixelX = tileCol * TILE_SIZE;  // i в Java
-    int tilePixelY = tileRow * TILE_SIZE;  // j в Java
-    int tileRight = tilePixelX + TILE_SIZE;  // k в Java
-    int tileBottom = tilePixelY + TILE_SIZE; // m в Java
-
-    // Прямая портировка Java switch (Ball.java:520-538)
     switch (tileID) {
         // Горизонтальное сужение (i += 4, k -= 4)
         case 3:   // SPIKE_UP
@@ -896,9 +1279,7 @@ static bool thinCollide(Player* p, int tileRow, int tileCol, int tileID) {
         case 22:  // LARGE_HOOP_ACTIVE_VERT_BOTTOM
         case 43:  // INFLATOR_FLOOR
         case 45:  // INFLATOR_CEILING
-            tilePixelX += THIN_TILE_SIZE;  // i += 4
-            tileRight -= THIN_TILE_SIZE;   // k -= 4
-            break;
+            return shapeCollide(p, tileRow, tileCol, COLLIDE_THIN_VERT);
 
         // Вертикальное сужение (j += 4, m -= 4)
         case 4:   // SPIKE_LEFT
@@ -911,104 +1292,46 @@ static bool thinCollide(Player* p, int tileRow, int tileCol, int tileID) {
         case 24:  // LARGE_HOOP_ACTIVE_HORIZ_RIGHT
         case 44:  // INFLATOR_LEFT_WALL
         case 46:  // INFLATOR_RIGHT_WALL
-            tilePixelY += THIN_TILE_SIZE;  // j += 4
-            tileBottom -= THIN_TILE_SIZE;  // m -= 4
-            break;
+            return shapeCollide(p, tileRow, tileCol, COLLIDE_THIN_HORIZ);
 
         // Тайлы без сужения (остальные используют полные границы)
-        default:
-            // Без модификации границ
-            break;
+        default: {
+            int tilePixelX = tileCol * TILE_SIZE;
+            int tilePixelY = tileRow * TILE_SIZE;
+            return rectCollide(p->globalBallX, p->globalBallY,
+                              p->globalBallX + p->ballSize, p->globalBallY + p->ballSize,
+                              tilePixelX, tilePixelY, tilePixelX + TILE_SIZE, tilePixelY + TILE_SIZE);
+        }
     }
-
-    // Проверка пересечения мяча с модифицированным тайлом (точно как в Java)
-    return rectCollide(p->globalBallX, p->globalBallY,
-                      p->globalBallX + p->ballSize, p->globalBallY + p->ballSize,
-                      tilePixelX, tilePixelY, tileRight, tileBottom);
 }
 
-// Проверка коллизий с краями для колец (портировано из Ball.java edgeCollide) 
+// Проверка коллизий с краями для колец (портировано из Ball.java edgeCollide)
+// Прямоугольники кромок (Java switch 505-580) заложены в формы COLLIDE_EDGE_*.
 static bool edgeCollide(Player* p, int tileRow, int tileCol, int tileID) {
-    int tilePixelX = tileCol * TILE_SIZE;
-    int tilePixelY = tileRow * TILE_SIZE;
-    int tileRight = tilePixelX + TILE_SIZE;
-    int tileBottom = tilePixelY + TILE_SIZE;
-    
-    // Специальная логика для разных типов колец (Java switch 505-580)
     switch (tileID) {
-        // Маленькие вертикальные кольца (Java case 13, 17)
+        // Маленькие вертикальные кольца (Java case 13, 17): i += 6, k -= 6, m -= 11
         case 13: case 17:
-            tilePixelX += 6;
-            tileRight -= 6;  
-            tileBottom -= 11; // m -= 11
-            return rectCollide(p->globalBallX, p->globalBallY,
-                              p->globalBallX + p->ballSize, p->globalBallY + p->ballSize,
-                              tilePixelX, tilePixelY, tileRight, tileBottom);
-            
-        // Маленькие вертикальные кольца - нижняя часть (Java case 14, 18)
+            return shapeCollide(p, tileRow, tileCol, COLLIDE_EDGE_TOP);
+
+        // Вертикальные кольца - нижняя часть (Java case 14, 18, 22, 26): i += 6, k -= 6, j += 11
         case 14: case 18:
-            tilePixelX += 6;
-            tileRight -= 6;
-            tilePixelY += 11; // j += 11 как в оригинальном Java
-            return rectCollide(p->globalBallX, p->globalBallY,
-                              p->globalBallX + p->ballSize, p->globalBallY + p->ballSize,
-                              tilePixelX, tilePixelY, tileRight, tileBottom);
-                              
-        // Большие вертикальные кольца - нижняя часть (Java case 22, 26)
         case 22: case 26:
-            tilePixelX += 6;
-            tileRight -= 6;
-            tilePixelY += 11; // j += 11 как в оригинальном Java
-            return rectCollide(p->globalBallX, p->globalBallY,
-                              p->globalBallX + p->ballSize, p->globalBallY + p->ballSize,
-                              tilePixelX, tilePixelY, tileRight, tileBottom);
-            
-        // Большие вертикальные кольца (Java case 21, 25)  
+            return shapeCollide(p, tileRow, tileCol, COLLIDE_EDGE_BOTTOM);
+
+        // Большие вертикальные кольца (Java case 21, 25): m = j; j--; i += 6, k -= 6
         case 21: case 25:
-            tileBottom = tilePixelY; // m = j; j--
-            tilePixelY--;
-            tilePixelX += 6;
-            tileRight -= 6;
-            return rectCollide(p->globalBallX, p->globalBallY,
-                              p->globalBallX + p->ballSize, p->globalBallY + p->ballSize,  
-                              tilePixelX, tilePixelY, tileRight, tileBottom);
-            
-        // Маленькие горизонтальные кольца - левая часть (Java case 15, 19)
+            return shapeCollide(p, tileRow, tileCol, COLLIDE_EDGE_LARGE_TOP);
+
+        // Горизонтальные кольца - левая часть (Java case 15, 19, 23, 27): j += 6, m -= 6, k -= 11
         case 15: case 19:
-            tilePixelY += 6;  // j += 6
-            tileBottom -= 6;  // m -= 6  
-            tileRight -= 11;  // k -= 11
-            return rectCollide(p->globalBallX, p->globalBallY,
-                              p->globalBallX + p->ballSize, p->globalBallY + p->ballSize,
-                              tilePixelX, tilePixelY, tileRight, tileBottom);
-            
-        // Маленькие горизонтальные кольца - правая часть (Java case 16, 20)
-        case 16: case 20:
-            tilePixelY += 6;  // j += 6
-            tileBottom -= 6;  // m -= 6
-            tilePixelX += 11; // i += 11
-            return rectCollide(p->globalBallX, p->globalBallY,
-                              p->globalBallX + p->ballSize, p->globalBallY + p->ballSize,
-                              tilePixelX, tilePixelY, tileRight, tileBottom);
-                              
-        // Большие горизонтальные кольца - левая часть (Java case 23, 27)
         case 23: case 27:
-            tilePixelY += 6;  // j += 6
-            tileBottom -= 6;  // m -= 6  
-            tileRight -= 11;  // k -= 11
-            return rectCollide(p->globalBallX, p->globalBallY,
-                              p->globalBallX + p->ballSize, p->globalBallY + p->ballSize,
-                              tilePixelX, tilePixelY, tileRight, tileBottom);
-                              
-        // Большие горизонтальные кольца - правая часть (Java case 24, 28)
+            return shapeCollide(p, tileRow, tileCol, COLLIDE_EDGE_LEFT);
+
+        // Горизонтальные кольца - правая часть (Java case 16, 20, 24, 28): j += 6, m -= 6, i += 11
+        case 16: case 20:
         case 24: case 28:
-            tilePixelY += 6;  // j += 6
-            tileBottom -= 6;  // m -= 6
-            tilePixelX += 11; // i += 11
-            return rectCollide(p->globalBallX, p->globalBallY,
-                              p->globalBallX + p->ballSize, p->globalBallY + p->ballSize,
-                              tilePixelX, tilePixelY, tileRight, tileBottom);
-            
+            return shapeCollide(p, tileRow, tileCol, COLLIDE_EDGE_RIGHT);
+
         // Остальные кольца - аналогичная логика
         default:
             return false;
@@ -0,0 +1,23 @@
+// platform.h - Тонкая прослойка платформенных типов для ядра симуляции
+// Физика, парсер уровня и игровые правила подключают только этот заголовок,
+// поэтому собираются как под PSP, так и нативно на хосте (BOUNCE_HOST).
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <stdint.h>
+
+#ifdef BOUNCE_HOST
+// Хостовая сборка: повторяем базовые типы из <psptypes.h>
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t   s8;
+typedef int16_t  s16;
+typedef int32_t  s32;
+typedef int64_t  s64;
+#else
+#include <psptypes.h>
+#endif
+
+#endif // PLATFORM_H
@@ -1,8 +1,6 @@
 #ifndef PNG_H
 #define PNG_H
 
-#include <pspgu.h>
-
 // ТОЧНАЯ КОПИЯ вашей структуры texture_t
 typedef struct {
     void* data;         // Texture data
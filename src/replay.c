@@ -0,0 +1,231 @@
+// replay.c - Компактная RLE-запись ввода и детерминированное воспроизведение
+#include "replay.h"
+#include "level.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Маска битов направлений внутри байта тика
+#define REPLAY_INPUT_MASK (MOVE_LEFT | MOVE_RIGHT | MOVE_UP)
+// Заголовок: magic(4) + version/level/mode/reserved(4) + score/lives/ticks/runs(16)
+#define REPLAY_HEADER_SIZE 24
+
+void replay_init(replay_t* r) {
+    memset(r, 0, sizeof(*r));
+}
+
+void replay_free(replay_t* r) {
+    free(r->runs);
+    free(r->hashes);
+    replay_init(r);
+}
+
+void replay_begin(replay_t* r, int level, game_start_mode_t mode, int score, int numLives) {
+    r->level = level;
+    r->mode = mode;
+    r->score = score;
+    r->numLives = numLives;
+    r->ticks = 0;
+    r->numRuns = 0;
+    r->numHashes = 0;
+}
+
+// Гарантировать место под ещё один отрезок
+static bool replay_reserve(replay_t* r) {
+    if (r->numRuns < r->capacity) return true;
+    uint32_t capacity = r->capacity ? r->capacity * 2 : 64;
+    replay_run_t* runs = (replay_run_t*)realloc(r->runs, capacity * sizeof(replay_run_t));
+    if (!runs) return false;
+    r->runs = runs;
+    r->capacity = capacity;
+    return true;
+}
+
+bool replay_record_tick(replay_t* r, uint8_t input) {
+    if (r->numRuns > 0 && r->runs[r->numRuns - 1].input == input &&
+        r->runs[r->numRuns - 1].length < UINT32_MAX) {
+        r->runs[r->numRuns - 1].length++;
+        r->ticks++;
+        return true;
+    }
+
+    if (!replay_reserve(r)) return false;
+    r->runs[r->numRuns].input = input;
+    r->runs[r->numRuns].length = 1;
+    r->numRuns++;
+    r->ticks++;
+    return true;
+}
+
+bool replay_record_hash(replay_t* r, uint64_t hash) {
+    if (r->numHashes == r->hashCapacity) {
+        uint32_t capacity = r->hashCapacity ? r->hashCapacity * 2 : 256;
+        uint64_t* hashes = (uint64_t*)realloc(r->hashes, capacity * sizeof(uint64_t));
+        if (!hashes) return false;
+        r->hashes = hashes;
+        r->hashCapacity = capacity;
+    }
+    r->hashes[r->numHashes++] = hash;
+    return true;
+}
+
+// --- Сериализация ---
+
+static void put_u32(uint8_t* out, uint32_t v) {
+    out[0] = (uint8_t)v;
+    out[1] = (uint8_t)(v >> 8);
+    out[2] = (uint8_t)(v >> 16);
+    out[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t get_u32(const uint8_t* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+bool replay_save(const replay_t* r, const char* path) {
+    FILE* file = util_open_file(path, "wb");
+    if (!file) return false;
+
+    uint8_t header[REPLAY_HEADER_SIZE];
+    memcpy(header, REPLAY_MAGIC, 4);
+    header[4] = REPLAY_VERSION;
+    header[5] = (uint8_t)r->level;
+    header[6] = (uint8_t)r->mode;
+    // Хэши пишутся, только если они есть для каждого тика
+    bool withHashes = r->numHashes > 0 && r->numHashes == r->ticks;
+    header[7] = withHashes ? REPLAY_HAS_HASHES : 0;
+    put_u32(header + 8, (uint32_t)r->score);
+    put_u32(header + 12, (uint32_t)r->numLives);
+    put_u32(header + 16, r->ticks);
+    put_u32(header + 20, r->numRuns);
+    bool ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+
+    for (uint32_t i = 0; ok && i < r->numRuns; i++) {
+        // Байт ввода + длина в varint: 2 байта на отрезок короче 128 тиков
+        uint8_t buf[6];
+        int n = 0;
+        uint32_t length = r->runs[i].length;
+        buf[n++] = r->runs[i].input;
+        do {
+            uint8_t b = length & 0x7F;
+            length >>= 7;
+            buf[n++] = length ? (uint8_t)(b | 0x80) : b;
+        } while (length);
+        ok = fwrite(buf, 1, (size_t)n, file) == (size_t)n;
+    }
+
+    for (uint32_t i = 0; ok && withHashes && i < r->numHashes; i++) {
+        uint8_t buf[8];
+        put_u32(buf, (uint32_t)r->hashes[i]);
+        put_u32(buf + 4, (uint32_t)(r->hashes[i] >> 32));
+        ok = fwrite(buf, 1, sizeof(buf), file) == sizeof(buf);
+    }
+
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
+
+bool replay_load(replay_t* r, const char* path) {
+    FILE* file = util_open_file(path, "rb");
+    if (!file) return false;
+
+    uint8_t header[REPLAY_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        memcmp(header, REPLAY_MAGIC, 4) != 0 || header[4] != REPLAY_VERSION) {
+        fclose(file);
+        return false;
+    }
+
+    replay_free(r);
+    replay_begin(r, header[5], (game_start_mode_t)header[6],
+                 (int)get_u32(header + 8), (int)get_u32(header + 12));
+    uint32_t ticks = get_u32(header + 16);
+    uint32_t numRuns = get_u32(header + 20);
+
+    bool ok = true;
+    for (uint32_t i = 0; ok && i < numRuns; i++) {
+        int input = fgetc(file);
+        uint32_t length = 0;
+        int shift = 0, c;
+        do {
+            c = fgetc(file);
+            if (c == EOF || shift > 28) { ok = false; break; }
+            length |= (uint32_t)(c & 0x7F) << shift;
+            shift += 7;
+        } while (c & 0x80);
+        if (input == EOF || length == 0) ok = false;
+
+        // Отрезки добавляются целиком, без слияния соседних
+        if (ok && !replay_reserve(r)) ok = false;
+        if (ok) {
+            r->runs[r->numRuns].input = (uint8_t)input;
+            r->runs[r->numRuns].length = length;
+            r->numRuns++;
+            r->ticks += length;
+        }
+    }
+
+    // Хэши тиков (если записаны): ровно по одному на тик
+    if (ok && (header[7] & REPLAY_HAS_HASHES) && r->ticks == ticks) {
+        for (uint32_t i = 0; ok && i < ticks; i++) {
+            uint8_t buf[8];
+            if (fread(buf, 1, sizeof(buf), file) != sizeof(buf)) {
+                ok = false;
+            } else {
+                ok = replay_record_hash(r, (uint64_t)get_u32(buf) | ((uint64_t)get_u32(buf + 4) << 32));
+            }
+        }
+    }
+    fclose(file);
+
+    if (!ok || r->ticks != ticks) {
+        replay_free(r);
+        return false;
+    }
+    return true;
+}
+
+// --- Воспроизведение ---
+
+bool replay_start(SimContext* sim, const replay_t* r, replay_cursor_t* cursor) {
+    bool loaded = game_start_level(sim, r->level, r->mode);
+    // Для GAME_START_NEXT счёт и жизни переходят с прошлого уровня
+    sim->score = r->score;
+    sim->numLives = r->numLives;
+
+    cursor->replay = r;
+    cursor->run = 0;
+    cursor->used = 0;
+    cursor->tick = 0;
+    return loaded;
+}
+
+bool replay_next_input(replay_cursor_t* cursor, uint8_t* input) {
+    const replay_t* r = cursor->replay;
+    if (cursor->run >= r->numRuns) return false;
+
+    *input = r->runs[cursor->run].input;
+    if (++cursor->used >= r->runs[cursor->run].length) {
+        cursor->run++;
+        cursor->used = 0;
+    }
+    cursor->tick++;
+    return true;
+}
+
+bool replay_step(SimContext* sim, replay_cursor_t* cursor) {
+    uint8_t input;
+    if (!replay_next_input(cursor, &input)) return false;
+
+    sim->invincible = (input & REPLAY_FLAG_INVINCIBLE) != 0;
+    game_tick(sim, (MoveMask)(input & REPLAY_INPUT_MASK));
+    return true;
+}
+
+bool replay_verify_hash(const replay_cursor_t* cursor, const SimContext* sim, uint64_t* expected) {
+    const replay_t* r = cursor->replay;
+    if (cursor->tick == 0 || cursor->tick > r->numHashes) return true;
+
+    *expected = r->hashes[cursor->tick - 1];
+    return sim_hash(sim) == *expected;
+}
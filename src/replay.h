@@ -0,0 +1,72 @@
+// replay.h - Запись и воспроизведение ввода на фиксированном тике 30 мс
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "types.h"
+#include "game.h"
+
+// Флаг байта тика: читерское бессмертие активно на этом тике.
+// Младшие биты байта - MoveMask (MOVE_LEFT/MOVE_RIGHT/MOVE_UP).
+#define REPLAY_FLAG_INVINCIBLE 0x80
+
+// Формат файла (little-endian):
+//   "BRPL" | version u8 | level u8 | mode u8 | flags u8
+//   score s32 | lives s32 | ticks u32 | runs u32
+//   runs × { input u8, length varint (LEB128) }
+//   [flags & REPLAY_HAS_HASHES] ticks × { sim_hash() после тика u64 }
+// Подряд идущие одинаковые тики хранятся одним run-length отрезком.
+// Байт flags раньше был зарезервирован (0), поэтому старые записи читаются как есть.
+#define REPLAY_MAGIC   "BRPL"
+#define REPLAY_VERSION 1
+#define REPLAY_HAS_HASHES 0x01
+
+typedef struct {
+    uint8_t input;          // MoveMask | REPLAY_FLAG_*
+    uint32_t length;        // Число подряд идущих тиков с этим вводом
+} replay_run_t;
+
+typedef struct replay_s {
+    int level;                  // Номер уровня (1-MAX_LEVEL)
+    game_start_mode_t mode;     // Режим старта game_start_level()
+    int score;                  // Счёт сразу после старта уровня
+    int numLives;               // Жизни сразу после старта уровня
+    uint32_t ticks;             // Общее число тиков
+    replay_run_t* runs;         // Отрезки RLE
+    uint32_t numRuns;
+    uint32_t capacity;
+    uint64_t* hashes;           // sim_hash() после каждого тика (или NULL)
+    uint32_t numHashes;
+    uint32_t hashCapacity;
+} replay_t;
+
+// Курсор воспроизведения
+typedef struct {
+    const replay_t* replay;
+    uint32_t run;               // Текущий отрезок
+    uint32_t used;              // Сколько тиков текущего отрезка уже выдано
+    uint32_t tick;              // Номер следующего тика
+} replay_cursor_t;
+
+// Запись
+void replay_init(replay_t* r);
+void replay_free(replay_t* r);
+void replay_begin(replay_t* r, int level, game_start_mode_t mode, int score, int numLives);
+bool replay_record_tick(replay_t* r, uint8_t input);
+bool replay_record_hash(replay_t* r, uint64_t hash);  // game_tick() после тика
+
+// Файлы (через util_open_file)
+bool replay_save(const replay_t* r, const char* path);
+bool replay_load(replay_t* r, const char* path);
+
+// Воспроизведение: replay_start() запускает уровень в sim как при записи,
+// replay_step() выполняет один game_tick() с записанным вводом.
+bool replay_start(SimContext* sim, const replay_t* r, replay_cursor_t* cursor);
+bool replay_next_input(replay_cursor_t* cursor, uint8_t* input);
+bool replay_step(SimContext* sim, replay_cursor_t* cursor);
+// Сверить sim_hash(sim) с записанным хэшем последнего выполненного тика.
+// false - первое расхождение (expected - записанный хэш); без хэшей всегда true.
+bool replay_verify_hash(const replay_cursor_t* cursor, const SimContext* sim, uint64_t* expected);
+
+#endif // REPLAY_H
@@ -0,0 +1,166 @@
+// rewind.c - Журнал отмены тиков для перемотки (дельты SimSnapshot в кольцевом буфере)
+#include "rewind.h"
+#include <string.h>
+
+// Максимальная запись: каждый второй байт снимка изменен (3 байта на 2) плюс рамка
+#define REWIND_RECORD_MAX (sizeof(SimSnapshot) * 2 + 4)
+// Неизмененный промежуток до стольких байт дешевле включить в отрезок,
+// чем начинать новый (заголовок отрезка - минимум 2 байта)
+#define REWIND_MERGE_GAP 2
+
+static inline uint32_t wrap(uint32_t pos) {
+    return pos % REWIND_BUFFER_SIZE;
+}
+
+static void ring_write(rewind_buffer_t* rw, const uint8_t* data, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) {
+        rw->buffer[rw->head] = data[i];
+        rw->head = wrap(rw->head + 1);
+    }
+}
+
+static uint32_t ring_read_u16(const rewind_buffer_t* rw, uint32_t pos) {
+    return (uint32_t)rw->buffer[wrap(pos)] | ((uint32_t)rw->buffer[wrap(pos + 1)] << 8);
+}
+
+// Отбросить самую старую запись
+static void rewind_drop_oldest(rewind_buffer_t* rw) {
+    uint32_t tail = wrap(rw->head + REWIND_BUFFER_SIZE - rw->used);
+    uint32_t size = ring_read_u16(rw, tail) + 4;
+    rw->used -= size;
+    rw->ticks--;
+}
+
+void rewind_reset(rewind_buffer_t* rw, const SimContext* sim) {
+    rw->head = 0;
+    rw->used = 0;
+    rw->ticks = 0;
+    rw->current = 0;
+    // Паддинг снимков обнуляется один раз и дальше не меняется,
+    // поэтому сравнение снимков побайтно не дает ложных отличий
+    memset(rw->snaps, 0, sizeof(rw->snaps));
+    rw->enabled = sim_snapshot(sim, &rw->snaps[0]);
+}
+
+// Закодировать старые значения байт, отличающихся в prev и next
+static uint32_t rewind_encode(const uint8_t* prev, const uint8_t* next, uint8_t* out) {
+    const uint32_t size = sizeof(SimSnapshot);
+    uint32_t n = 0;
+    uint32_t runEnd = 0;  // Конец предыдущего отрезка
+    uint32_t i = 0;
+
+    while (i < size) {
+        // Неизмененные слова пропускаются целиком
+        if (i % 4 == 0 && i + 4 <= size && memcmp(prev + i, next + i, 4) == 0) {
+            i += 4;
+            continue;
+        }
+        if (prev[i] == next[i]) {
+            i++;
+            continue;
+        }
+
+        // Отрезок: до 255 байт, включая короткие неизмененные промежутки
+        uint32_t start = i;
+        uint32_t end = i + 1;
+        while (end < size && end - start < 255) {
+            if (prev[end] != next[end]) {
+                end++;
+                continue;
+            }
+            uint32_t gap = end;
+            while (gap < size && gap - end < REWIND_MERGE_GAP && prev[gap] == next[gap]) gap++;
+            if (gap < size && gap - end < REWIND_MERGE_GAP && gap - start < 255) {
+                end = gap + 1;
+            } else {
+                break;
+            }
+        }
+
+        uint32_t skip = start - runEnd;
+        do {
+            uint8_t b = skip & 0x7F;
+            skip >>= 7;
+            out[n++] = skip ? (uint8_t)(b | 0x80) : b;
+        } while (skip);
+        out[n++] = (uint8_t)(end - start);
+        memcpy(out + n, prev + start, end - start);
+        n += end - start;
+
+        runEnd = end;
+        i = end;
+    }
+    return n;
+}
+
+void rewind_record(rewind_buffer_t* rw, const SimContext* sim) {
+    if (!rw->enabled) return;
+
+    SimSnapshot* prev = &rw->snaps[rw->current];
+    SimSnapshot* next = &rw->snaps[rw->current ^ 1];
+    if (!sim_snapshot(sim, next)) {
+        rw->enabled = false;
+        return;
+    }
+
+    uint8_t record[REWIND_RECORD_MAX];
+    uint32_t len = rewind_encode((const uint8_t*)prev, (const uint8_t*)next, record + 2);
+    record[0] = (uint8_t)len;
+    record[1] = (uint8_t)(len >> 8);
+    record[len + 2] = record[0];
+    record[len + 3] = record[1];
+    uint32_t size = len + 4;
+
+    while (rw->ticks > 0 && (rw->used + size > REWIND_BUFFER_SIZE || rw->ticks >= REWIND_MAX_TICKS)) {
+        rewind_drop_oldest(rw);
+    }
+    ring_write(rw, record, size);
+    rw->used += size;
+    rw->ticks++;
+    rw->current ^= 1;
+}
+
+// Применить самую новую запись к текущему снимку и убрать ее из буфера
+static void rewind_undo_last(rewind_buffer_t* rw) {
+    uint8_t* snap = (uint8_t*)&rw->snaps[rw->current];
+    uint32_t len = ring_read_u16(rw, rw->head + REWIND_BUFFER_SIZE - 2);
+    uint32_t pos = wrap(rw->head + REWIND_BUFFER_SIZE - 2 - len);
+    uint32_t end = pos + len;  // Без заворота: pos < REWIND_BUFFER_SIZE
+    uint32_t offset = 0;
+
+    while (pos < end) {
+        uint32_t skip = 0;
+        int shift = 0;
+        uint8_t b;
+        do {
+            b = rw->buffer[wrap(pos++)];
+            skip |= (uint32_t)(b & 0x7F) << shift;
+            shift += 7;
+        } while (b & 0x80);
+        uint32_t count = rw->buffer[wrap(pos++)];
+
+        offset += skip;
+        for (uint32_t i = 0; i < count; i++) {
+            snap[offset + i] = rw->buffer[wrap(pos++)];
+        }
+        offset += count;
+    }
+
+    rw->head = wrap(rw->head + REWIND_BUFFER_SIZE - len - 4);
+    rw->used -= len + 4;
+    rw->ticks--;
+}
+
+int rewind_step_back(rewind_buffer_t* rw, SimContext* sim, int ticks) {
+    if (!rw->enabled) return 0;
+
+    int done = 0;
+    while (done < ticks && rw->ticks > 0) {
+        rewind_undo_last(rw);
+        done++;
+    }
+    if (done > 0) {
+        sim_restore(sim, &rw->snaps[rw->current]);
+    }
+    return done;
+}
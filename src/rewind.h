@@ -0,0 +1,40 @@
+// rewind.h - Перемотка игры назад по журналу изменений за последние тики
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sim.h"
+
+// Глубина перемотки: 10 секунд по 30 мс (ограничена и объемом буфера)
+#define REWIND_MAX_TICKS   (10 * 1000 / 30)
+#define REWIND_BUFFER_SIZE (16 * 1024)
+
+// Кольцевой буфер записей отмены: для каждого тика хранятся только байты
+// SimSnapshot, изменившиеся за тик (старые значения), в виде отрезков
+//   { пропуск varint, длина u8, старые байты }.
+// Запись обрамлена длиной u16 с обеих сторон, чтобы буфер можно было
+// читать с конца (перемотка) и отбрасывать с начала (переполнение).
+// Типичный тик занимает несколько десятков байт.
+typedef struct {
+    uint8_t buffer[REWIND_BUFFER_SIZE];
+    uint32_t head;            // Позиция записи следующего тика
+    uint32_t used;            // Занято байт
+    uint32_t ticks;           // Число тиков, на которые можно отмотать
+    bool enabled;             // false, если для уровня недоступен sim_snapshot()
+
+    SimSnapshot snaps[2];     // Текущее и следующее состояние (без копирования между ними)
+    int current;              // Индекс снимка, соответствующего состоянию sim
+} rewind_buffer_t;
+
+// Начать журнал с текущего состояния (старт уровня)
+void rewind_reset(rewind_buffer_t* rw, const SimContext* sim);
+
+// Записать изменения за только что выполненный game_tick()
+void rewind_record(rewind_buffer_t* rw, const SimContext* sim);
+
+// Отмотать до ticks тиков назад и восстановить sim. Возвращает число отмотанных тиков.
+// Отмотанные тики удаляются из журнала: игра продолжается с восстановленного места.
+int rewind_step_back(rewind_buffer_t* rw, SimContext* sim, int ticks);
+
+#endif // REWIND_H
@@ -0,0 +1,141 @@
+// sim.c - Снимки состояния симуляции (sim_snapshot / sim_restore) и хэш состояния
+// Статическая часть уровня (стены, рампы, вода) после загрузки не меняется,
+// поэтому снимок хранит только изменяемые ячейки карты и копируется за O(их числа).
+#include "sim.h"
+#include "tile_table.h"
+#include "zobrist.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+SimContext* sim_clone(const SimContext* sim) {
+    SimContext* copy = (SimContext*)malloc(sizeof(SimContext));
+    if (!copy) {
+        return NULL;
+    }
+    memcpy(copy, sim, offsetof(SimContext, level));
+    memset(&copy->level, 0, sizeof(copy->level));
+    if (!level_copy(&copy->level, &sim->level)) {
+        free(copy);
+        return NULL;
+    }
+    return copy;
+}
+
+void sim_free(SimContext* sim) {
+    if (sim) {
+        level_free(&sim->level);
+        free(sim);
+    }
+}
+
+void sim_save_tiles(const Level* level, uint8_t* tiles) {
+    for (int i = 0; i < level->numMutableTiles; i++) {
+        tiles[i] = level->tiles[level->mutableTiles[i]];
+    }
+}
+
+void sim_load_tiles(Level* level, const uint8_t* tiles) {
+    // Карта классов коллизий и хэш карты меняются вместе с тайлом, как в level_set_id()
+    for (int i = 0; i < level->numMutableTiles; i++) {
+        int cell = level->mutableTiles[i];
+        uint8_t* tile = &level->tiles[cell];
+        if (*tile == tiles[i]) {
+            continue;
+        }
+        int y = cell / level->stride, x = cell - y * level->stride;
+        level->hash ^= zobrist_tile_key(x, y, *tile) ^ zobrist_tile_key(x, y, tiles[i]);
+        *tile = tiles[i];
+        level->collisionClass[cell] = tile_collision_class(tiles[i] & TILE_ID_MASK);
+        level->tileWindow.valid = false;
+    }
+}
+
+bool sim_snapshot(const SimContext* sim, SimSnapshot* snap) {
+    const Level* level = &sim->level;
+    if (level->numMutableTiles < 0) {
+        return false;
+    }
+
+    snap->levelNumber = sim->levelNumber;
+    snap->numMutableTiles = level->numMutableTiles;
+
+    snap->player = sim->player;
+    snap->numRings = sim->numRings;
+    snap->score = sim->score;
+    snap->numLives = sim->numLives;
+    snap->invincible = sim->invincible;
+    snap->state = sim->state;
+    snap->respawnX = sim->respawnX;
+    snap->respawnY = sim->respawnY;
+    snap->cameraY = sim->cameraY;
+    snap->exit = sim->exit;
+
+    snap->movingTick = level->movingTick;
+
+    sim_save_tiles(level, snap->tiles);
+    return true;
+}
+
+bool sim_restore(SimContext* sim, const SimSnapshot* snap) {
+    Level* level = &sim->level;
+    if (snap->levelNumber != sim->levelNumber || level->numMutableTiles < 0 ||
+        snap->numMutableTiles != level->numMutableTiles) {
+        return false;
+    }
+
+    sim->player = snap->player;
+    sim->numRings = snap->numRings;
+    sim->score = snap->score;
+    sim->numLives = snap->numLives;
+    sim->invincible = snap->invincible;
+    sim->state = snap->state;
+    sim->respawnX = snap->respawnX;
+    sim->respawnY = snap->respawnY;
+    sim->cameraY = snap->cameraY;
+    sim->exit = snap->exit;
+
+    level_seek_moving_objects(level, snap->movingTick);
+
+    sim_load_tiles(level, snap->tiles);
+    return true;
+}
+
+// Мяч и счетчики - два десятка полей, меняющихся почти на каждом тике:
+// их дешевле перемешать целиком, чем обновлять ключи при каждой записи.
+static uint64_t sim_hash_fields(const SimContext* sim) {
+    const Player* p = &sim->player;
+    const int fields[] = {
+        p->xPos, p->yPos, p->globalBallX, p->globalBallY, p->xSpeed, p->ySpeed,
+        p->direction, p->ballSize, p->mHalfBallSize, p->jumpOffset, p->ballState,
+        p->sizeState, p->mGroundedFlag, p->mCDRubberFlag, p->speedBonusCntr,
+        p->gravBonusCntr, p->jumpBonusCntr, p->popCntr, p->slideCntr, p->isInWater,
+        p->mCDRampFlag,
+        sim->numRings, sim->score, sim->numLives, sim->invincible, sim->state,
+        sim->levelNumber, sim->respawnX, sim->respawnY, sim->cameraY,
+        sim->exit.state, sim->exit.animation_offset
+    };
+    uint64_t h = ZOBRIST_DOMAIN_SIM;
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        h = (h ^ (uint32_t)fields[i]) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 32;
+    }
+    return zobrist_mix(h);
+}
+
+void sim_event_push(SimContext* sim, SimEventType type, int x, int y, int value) {
+    SimEventQueue* queue = &sim->events;
+    if (queue->count == SIM_EVENT_CAPACITY) {
+        queue->dropped++;
+        return;
+    }
+    SimEvent* event = &queue->items[queue->count++];
+    event->type = (uint8_t)type;
+    event->x = (short)x;
+    event->y = (short)y;
+    event->value = value;
+}
+
+uint64_t sim_hash(const SimContext* sim) {
+    return sim->level.hash ^ sim->level.movingHash ^ sim_hash_fields(sim);
+}
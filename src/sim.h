@@ -0,0 +1,174 @@
+// sim.h - Контекст симуляции: всё изменяемое состояние одного прогона уровня
+// Ядро (physics.c, level.c, game_logic.c) не хранит игровое состояние в глобальных
+// переменных: каждая функция получает SimContext*, поэтому несколько контекстов
+// можно вести независимо друг от друга (например, в разных потоках на хосте).
+// Игра на PSP использует один контекст g_sim (game.h).
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdbool.h>
+#include "types.h"
+#include "level.h"
+
+// Анимация двери выхода
+typedef enum {
+    EXIT_CLOSED = 0,
+    EXIT_WAITING_VISIBLE,
+    EXIT_OPENING,
+    EXIT_OPEN
+} ExitState;
+
+typedef struct {
+    ExitState state;
+    int animation_offset;
+} ExitController;
+
+// Игровые события тика. Состояние (счёт, кольца, карта, state) меняется сразу,
+// как в оригинале, а в очередь попадает только уведомление для платформы:
+// игра на PSP разбирает очередь после game_tick() и проигрывает звуки,
+// хостовые прогоны ее просто не читают. Очередь очищается в начале game_tick().
+typedef enum {
+    SIM_EVENT_SCORE = 0,      // value - начисленные очки
+    SIM_EVENT_RING,           // x, y, value - ID тайла собранного кольца
+    SIM_EVENT_CHECKPOINT,     // x, y - активированный чекпоинт
+    SIM_EVENT_EXTRA_LIFE,     // Собрана дополнительная жизнь
+    SIM_EVENT_BONUS,          // x, y, value - ID тайла бонуса скорости/гравитации/прыжка
+    SIM_EVENT_POP,            // Мяч лопнул
+    SIM_EVENT_LEVEL_COMPLETE  // Мяч прошел в открытую дверь
+} SimEventType;
+
+typedef struct {
+    uint8_t type;             // SimEventType
+    short x, y;               // Тайл, где произошло событие (если есть)
+    int value;
+} SimEvent;
+
+// За тик обычно 0-3 события; при переполнении лишние уведомления
+// отбрасываются (состояние симуляции от этого не зависит)
+#define SIM_EVENT_CAPACITY 32
+
+typedef struct {
+    int count;
+    int dropped;              // Отброшено из-за переполнения за тик
+    SimEvent items[SIM_EVENT_CAPACITY];
+} SimEventQueue;
+
+struct replay_s;
+
+#ifdef PHYSICS_STATS
+// Счетчики работы физики (только в сборке с -DPHYSICS_STATS, без нее счетчиков
+// нет ни в коде, ни в SimContext). Копятся, пока вызывающий код их не обнулит:
+// bounce_bench суммирует их по уровню, bounce_headless_stats пишет CSV по тикам.
+typedef struct {
+    uint64_t updates;                     // Вызовы player_update()
+    uint64_t collisionCalls;              // Вызовы collisionDetection()
+    uint64_t tileTests;                   // Вызовы testTile()
+    uint64_t classTests[TILE_CLASS_COUNT]; // testTile() по классу коллизии тайла
+    uint64_t substepsY;                   // Подшаги Y-цикла с коллизиями
+    uint64_t substepsX;                   // Подшаги X-цикла с коллизиями
+    uint64_t fastSubstepsY;               // Подшаги Y, выполненные свободным полетом
+    uint64_t fastSubstepsX;               // Подшаги X, выполненные свободным полетом
+    uint64_t rampSlides;                  // Сдвиги скольжением по рампе (Y и X фазы)
+    uint64_t enlargeSearch;               // Итерации поиска места в enlarge_ball()
+    uint64_t enlargeRadius;               // Наибольшее смещение, на котором enlarge_ball() нашел место (или сдался)
+} PhysicsStats;
+#endif
+
+typedef struct SimContext {
+    Player player;            // Состояние мяча
+
+    // Игровая статистика (Java-совместимые поля)
+    int numRings;             // Количество собранных колец
+    int score;                // Очки игрока (500 за кольцо)
+    int numLives;             // Количество жизней (начинается с 3, максимум 5)
+    bool invincible;          // Читерское бессмертие (как mInvincible в Java)
+
+    // Итог прогона: STATE_GAME пока уровень идет,
+    // STATE_LEVEL_COMPLETE или STATE_GAME_OVER после завершения
+    GameState state;
+    int levelNumber;          // Номер загруженного уровня (1-MAX_LEVEL)
+
+    int respawnX, respawnY;   // Точка респауна в тайлах (как в Java setRespawn)
+    int cameraY;              // Вертикальная камера с мертвой зоной: от нее зависит открытие двери
+    ExitController exit;      // Анимация двери выхода
+
+    struct replay_s* recorder; // Необязательная запись ввода (см. game_attach_recorder)
+    SimEventQueue events;     // События текущего тика (не входят в снимок и хэш)
+#ifdef PHYSICS_STATS
+    PhysicsStats stats;       // Накапливаются, пока вызывающий код их не обнулит
+#endif
+
+    Level level;              // Карта и движущиеся объекты (сетки карты - в куче, см. level.h)
+} SimContext;
+
+// Независимая копия контекста (со своими сетками уровня) для другого потока
+// или ветви перебора; NULL - нет памяти. Освобождается sim_free().
+SimContext* sim_clone(const SimContext* sim);
+// Освободить контекст из calloc()/sim_clone() вместе с сетками уровня
+void sim_free(SimContext* sim);
+
+// Снимок состояния для продолжения игры с того же тика (sim.c).
+// Плоская структура фиксированного размера (меньше 1 КБ): копируется memcpy,
+// не содержит указателей и не требует повторного разбора уровня.
+// Из карты хранятся только изменяемые ячейки (Level::mutableTiles).
+typedef struct {
+    int levelNumber;          // Уровень, на котором снят снимок
+    int numMutableTiles;      // Для проверки соответствия карте при восстановлении
+
+    Player player;
+    int numRings;
+    int score;
+    int numLives;
+    bool invincible;
+    GameState state;
+    int respawnX, respawnY;
+    int cameraY;
+    ExitController exit;
+
+    uint32_t movingTick;      // Шипы восстанавливаются по номеру тика (level_seek_moving_objects)
+    uint8_t tiles[MAX_MUTABLE_TILES];  // Байты тайлов изменяемых ячеек
+} SimSnapshot;
+
+// Снять снимок. false, если у уровня слишком много изменяемых ячеек.
+bool sim_snapshot(const SimContext* sim, SimSnapshot* snap);
+// Восстановить снимок в контекст с тем же загруженным уровнем (иначе false).
+bool sim_restore(SimContext* sim, const SimSnapshot* snap);
+
+// Байты изменяемых ячеек карты (Level::numMutableTiles штук, в порядке
+// Level::mutableTiles): сохранить и подставить обратно, как это делают снимки.
+void sim_save_tiles(const Level* level, uint8_t* tiles);
+void sim_load_tiles(Level* level, const uint8_t* tiles);
+
+// 64-битный хэш всего состояния симуляции: Zobrist-хэш карты (Level::hash) и
+// ключи движущихся объектов (Level::movingHash), оба обновляются на месте, и поля
+// мяча и счетчиков. Эти три десятка полей перемешиваются заново при каждом вызове:
+// они меняются почти на каждом тике, и ключ на каждую запись в физике стоил бы
+// дороже. Не зависит от пути к состоянию: годится для сверки реплеев по тикам и
+// для отсева уже посещенных состояний при переборе.
+uint64_t sim_hash(const SimContext* sim);
+
+// Добавить событие в очередь тика (sim.c)
+void sim_event_push(SimContext* sim, SimEventType type, int x, int y, int value);
+
+static inline void sim_events_clear(SimContext* sim) {
+    sim->events.count = 0;
+    sim->events.dropped = 0;
+}
+
+// Функции физики игрока (physics.c)
+void player_init(SimContext* sim, int x, int y, BallSizeState sizeState);
+void player_update(SimContext* sim);
+void enlarge_ball(SimContext* sim);
+void shrink_ball(SimContext* sim);
+void pop_ball(SimContext* sim);
+
+// Игровые события (callbacks, game_logic.c)
+void game_add_score(SimContext* sim, int points);
+void game_add_ring(SimContext* sim);
+void game_ring_collected(SimContext* sim, int tileX, int tileY, uint8_t tileID);
+
+void game_set_respawn(SimContext* sim, int x, int y);
+void game_add_extra_life(SimContext* sim);
+void game_complete_level(SimContext* sim);
+
+#endif // SIM_H
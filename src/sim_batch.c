@@ -0,0 +1,88 @@
+// sim_batch.c - Пакетный тик дорожек SimBatch на общем SimContext
+// Своей физики здесь нет: дорожка по очереди подставляется в sim->player,
+// счётчики и (если она что-то собрала) в ячейки карты, и тик идет обычными
+// player_update(), game_resolve_death() и game_update_exit().
+#include "sim_batch.h"
+#include "game.h"
+
+// Подставить ячейки карты дорожки want (-1 - базовые)
+static void batch_use_tiles(SimBatch* b, Level* level, int want) {
+    if (b->loadedTiles != want) {
+        sim_load_tiles(level, want < 0 ? b->baseTiles : b->tiles[want]);
+        b->loadedTiles = want;
+    }
+}
+
+static void batch_load(SimBatch* b, SimContext* sim, int i) {
+    const SimBatchLane* lane = &b->lanes[i];
+    sim->player = lane->player;
+    sim->numRings = lane->numRings;
+    sim->score = lane->score;
+    sim->numLives = lane->numLives;
+    sim->state = lane->state;
+    sim->respawnX = lane->respawnX;
+    sim->respawnY = lane->respawnY;
+    sim->cameraY = lane->cameraY;
+    sim->exit = lane->exit;
+
+    batch_use_tiles(b, &sim->level, lane->ownTiles ? i : -1);
+    sim->level.tileWindow = lane->window;
+    sim_events_clear(sim);
+}
+
+static void batch_store(SimBatch* b, const SimContext* sim, int i) {
+    SimBatchLane* lane = &b->lanes[i];
+    lane->player = sim->player;
+    lane->numRings = sim->numRings;
+    lane->score = sim->score;
+    lane->numLives = sim->numLives;
+    lane->state = sim->state;
+    lane->respawnX = sim->respawnX;
+    lane->respawnY = sim->respawnY;
+    lane->cameraY = sim->cameraY;
+    lane->exit = sim->exit;
+    lane->window = sim->level.tileWindow;
+}
+
+bool sim_batch_fill(SimBatch* b, const SimContext* sim, int count) {
+    if (count < 1 || count > SIM_BATCH_LANES || sim->level.numMutableTiles < 0) {
+        return false;
+    }
+    b->count = count;
+    sim_save_tiles(&sim->level, b->baseTiles);
+    b->loadedTiles = -1;
+    for (int i = 0; i < count; i++) {
+        batch_store(b, sim, i);
+        b->lanes[i].ownTiles = false;
+    }
+    return true;
+}
+
+void sim_batch_extract(SimBatch* b, SimContext* sim, int lane) {
+    batch_load(b, sim, lane);
+}
+
+void sim_batch_tick(SimBatch* b, SimContext* sim, const MoveMask* inputs) {
+    for (int i = 0; i < b->count; i++) {
+        if (b->lanes[i].state != STATE_GAME) continue;
+        batch_load(b, sim, i);
+        uint64_t hash = sim->level.hash;
+
+        // game_tick() без записи реплея и без движущихся шипов
+        game_apply_input(&sim->player, inputs[i]);
+        player_update(sim);
+        game_resolve_death(sim);
+        game_update_exit(sim);
+
+        // Дорожка изменила ячейки карты (хэш карты сдвинулся): они копируются
+        // в ее собственный набор
+        if (sim->level.hash != hash) {
+            sim_save_tiles(&sim->level, b->tiles[i]);
+            b->lanes[i].ownTiles = true;
+            b->loadedTiles = i;
+        }
+        batch_store(b, sim, i);
+    }
+
+    level_update_moving_objects(&sim->level);
+}
@@ -0,0 +1,59 @@
+// sim_batch.h - Пакетный тик: много независимых мячей на одной карте за один вызов
+// Для массового перебора вариантов ввода от одного состояния на хосте (сотни и
+// тысячи продолжений одного чекпоинта). Дорожки делят одну загруженную карту и
+// движущиеся шипы (сдвигаются один раз за тик пакета), а физику ведет тот же
+// player_update(), что и game_tick(), по дорожке на общем SimContext. Результат
+// каждой дорожки совпадает с game_tick() отдельного контекста, начатого с того
+// же состояния. По скорости дорожка-тик равна game_tick(): пакет экономит
+// память (одна карта на все дорожки), а не время.
+#ifndef SIM_BATCH_H
+#define SIM_BATCH_H
+
+#include "sim.h"
+
+#define SIM_BATCH_LANES 64      // Дорожек в одном пакете (~42 КБ вместе с ячейками карты)
+
+// Состояние одной дорожки: мяч и счётчики прогона (бессмертие общее - sim->invincible)
+typedef struct {
+    Player player;
+    int numRings, score, numLives;
+    GameState state;
+    int respawnX, respawnY;
+    int cameraY;
+    ExitController exit;
+
+    // Окно тайлов collisionDetection() у каждой дорожки свое: общее сбрасывалось
+    // бы на каждой смене дорожки. Ячейки, которые видит дорожка, меняет только
+    // она сама, поэтому ее окно остается верным и при подстановке чужих ячеек.
+    TileWindowCache window;
+    bool ownTiles;              // У дорожки своя копия изменяемых ячеек (SimBatch::tiles)
+} SimBatchLane;
+
+typedef struct {
+    int count;                  // Число занятых дорожек
+    SimBatchLane lanes[SIM_BATCH_LANES];
+
+    // Изменяемые ячейки карты. Пока дорожка ничего не собрала, она видит
+    // baseTiles; после первого изменения у нее появляется своя копия.
+    uint8_t baseTiles[MAX_MUTABLE_TILES];
+    uint8_t tiles[SIM_BATCH_LANES][MAX_MUTABLE_TILES];
+    int loadedTiles;            // Чьи ячейки сейчас в sim->level: дорожка или -1 (baseTiles)
+} SimBatch;
+
+// Заполнить count дорожек копиями текущего состояния sim. Дальше sim - общая карта
+// и рабочий контекст пакета: его мяч и счётчики перезаписываются дорожками.
+// false, если count вне 1..SIM_BATCH_LANES или у уровня слишком много изменяемых ячеек.
+bool sim_batch_fill(SimBatch* batch, const SimContext* sim, int count);
+
+// Один тик всех дорожек, как game_tick() для каждой: inputs[i] - маска дорожки i.
+// Движущиеся шипы общие и сдвигаются один раз за вызов. Дорожки, где уровень
+// закончился (state != STATE_GAME), больше не меняются. События и запись реплея
+// пакет не ведет.
+void sim_batch_tick(SimBatch* batch, SimContext* sim, const MoveMask* inputs);
+
+// Перенести дорожку в sim целиком (мяч, счётчики и ячейки карты): например,
+// чтобы продолжить лучший вариант обычным game_tick() или снять его снимок.
+// После этого пакет нужно заполнить заново.
+void sim_batch_extract(SimBatch* batch, SimContext* sim, int lane);
+
+#endif // SIM_BATCH_H
@@ -0,0 +1,169 @@
+// solid_bitmap.c - Растеризация кирпича, резины и рамп в Level::solidRows
+#include "solid_bitmap.h"
+#include "level_masks.inc"
+#include <stdlib.h>
+#include <string.h>
+
+// Строка тайла (12 бит, бит c = столбец c) для растеризации
+static uint16_t solid_tile_row(uint8_t cls, int tileID, int row) {
+    switch (cls) {
+        case TILE_CLASS_BRICK:
+        case TILE_CLASS_RUBBER:
+            return (1u << TILE_SIZE) - 1;
+        case TILE_CLASS_RAMP:
+            return TRI_TILE_ROWS[(tileID - 30) & 3][row];  // Как triangleCollide
+        default:
+            return 0;
+    }
+}
+
+// 64 бита строки карты, начиная с пикселя (px & 31) слова w. Отступ в одно слово
+// в конце строки (Level::solidStride) позволяет читать второе слово без проверок.
+static inline uint64_t solid_row_bits(const uint32_t* w, int px) {
+    return ((uint64_t)w[0] | ((uint64_t)w[1] << 32)) >> (px & 31);
+}
+// Слова строки пикселей py карты, начиная со слова word. Строка тайлов py /
+// TILE_SIZE должна быть построена.
+static inline uint32_t* solid_row(const Level* level, int py, int word) {
+    int ty = py / TILE_SIZE;
+    return level->solidRows[ty] + (py - ty * TILE_SIZE) * level->solidStride + word;
+}
+
+// Растеризовать строку тайлов ty (12 строк пикселей) в новый блок. У кирпича и
+// резины все строки пикселей одинаковы, поэтому первая строка пишется подряд
+// через 64-битный накопитель и копируется в остальные, а рампы дорисовываются
+// по одной. false - нет памяти.
+static bool solid_bitmap_build_row(Level* level, int ty) {
+    int stride = level->solidStride;
+    uint32_t* row = (uint32_t*)malloc((size_t)TILE_SIZE * (size_t)stride * sizeof(uint32_t));
+    if (!row) return false;
+    uint32_t* out = row;
+    uint64_t acc = 0;
+    int bits = 0;
+    bool ramps = false;
+    for (int tx = 0; tx < level->width; tx++) {
+        uint8_t cls = level->collisionClass[ty * level->stride + tx];
+        if (cls == TILE_CLASS_BRICK || cls == TILE_CLASS_RUBBER) {
+            acc |= (uint64_t)((1u << TILE_SIZE) - 1) << bits;
+        } else if (cls == TILE_CLASS_RAMP) {
+            ramps = true;
+        }
+        bits += TILE_SIZE;
+        if (bits >= 32) {
+            *out++ = (uint32_t)acc;
+            acc >>= 32;
+            bits -= 32;
+        }
+    }
+    for (; out < row + stride; out++) {  // Хвост строки и слово отступа
+        *out = (uint32_t)acc;
+        acc >>= 32;
+    }
+    for (int r = 1; r < TILE_SIZE; r++) {
+        memcpy(row + r * stride, row, (size_t)stride * sizeof(uint32_t));
+    }
+
+    level->solidRows[ty] = row;
+    if (ramps) {
+        for (int tx = 0; tx < level->width; tx++) {
+            if (level->collisionClass[ty * level->stride + tx] == TILE_CLASS_RAMP) {
+                solid_bitmap_update_tile(level, tx, ty);
+            }
+        }
+    }
+    return true;
+}
+
+void solid_bitmap_update_tile(Level* level, int tx, int ty) {
+    if (!level->solidRows[ty]) return;  // Строка еще не построена: возьмет тайл при построении
+
+    uint8_t cls = level->collisionClass[ty * level->stride + tx];
+    int tileID = level_tile(level, tx, ty) & TILE_ID_MASK;
+    int px = tx * TILE_SIZE;
+    int shift = px & 31;
+    uint64_t keep = ~((uint64_t)((1u << TILE_SIZE) - 1) << shift);
+    for (int r = 0; r < TILE_SIZE; r++) {
+        uint32_t* w = solid_row(level, ty * TILE_SIZE + r, px >> 5);
+        uint64_t v = (uint64_t)w[0] | ((uint64_t)w[1] << 32);
+        v = (v & keep) | ((uint64_t)solid_tile_row(cls, tileID, r) << shift);
+        w[0] = (uint32_t)v;
+        w[1] = (uint32_t)(v >> 32);
+    }
+}
+
+void solid_bitmap_init(Level* level) {
+    level->solidStride = solid_bitmap_stride(level->width);
+    // Таблица solidRows уже очищена level_alloc_grids()
+}
+
+void solid_bitmap_free(Level* level) {
+    for (int ty = 0; level->solidRows && ty < level->height; ty++) {
+        free(level->solidRows[ty]);
+        level->solidRows[ty] = NULL;
+    }
+    level->solidStride = 0;
+}
+
+size_t solid_bitmap_built_bytes(const Level* level) {
+    size_t rows = 0;
+    for (int ty = 0; level->solidRows && ty < level->height; ty++) {
+        rows += level->solidRows[ty] != NULL;
+    }
+    return rows * TILE_SIZE * (size_t)level->solidStride * sizeof(uint32_t);
+}
+
+// Построить недостающие строки тайлов, покрывающие строки пикселей [py0, py1)
+static bool solid_bitmap_prepare(Level* level, int py0, int py1) {
+    if (level->solidStride == 0) return false;
+    for (int ty = py0 / TILE_SIZE; ty <= (py1 - 1) / TILE_SIZE; ty++) {
+        if (!level->solidRows[ty] && !solid_bitmap_build_row(level, ty)) return false;
+    }
+    return true;
+}
+
+// Маска мяча выпуклая: строки вложены друг в друга по направлению к середине,
+// а каждая строка - сплошной отрезок бит. Поэтому OR масок всех позиций сдвига
+// по одной оси собирается без перебора позиций. ballSize - константа в обоих
+// вызовах из solid_bitmap_sweep_hits(): маска и число строк известны компилятору.
+static inline bool sweep_hits_sized(Level* level, const int ballSize, int gx, int gy, int dx, int dy, int steps) {
+    const uint16_t* ballRows = (ballSize == ENLARGED_SIZE) ? LARGE_BALL_ROWS : SMALL_BALL_ROWS;
+
+    if (dy != 0) {
+        // Строка j полосы - OR строк мяча lo..hi, то есть ближайшей к середине.
+        // Обход с передней кромки: касание обычно находится в первых строках.
+        int rows = ballSize + steps - 1;
+        int top = (dy < 0) ? gy - steps : gy + 1;
+        if (!solid_bitmap_prepare(level, top, top + rows)) return true;
+        int j = (dy < 0) ? 0 : rows - 1;
+        for (int n = 0; n < rows; n++, j += (dy < 0) ? 1 : -1) {
+            int lo = (j - steps + 1 > 0) ? j - steps + 1 : 0;
+            int hi = (j < ballSize - 1) ? j : ballSize - 1;
+            int row = ballSize / 2;
+            if (row < lo) row = lo;
+            if (row > hi) row = hi;
+            if (solid_row_bits(solid_row(level, top + j, gx >> 5), gx) & ballRows[row]) return true;
+        }
+        return false;
+    }
+
+    // Строка полосы по X - отрезок строки мяча, продленный на steps - 1 пикселей
+    int span = (dx != 0) ? steps : 1;
+    int left = (dx < 0) ? gx - steps : gx + dx;
+    if (ballSize + span - 1 > 32) return true;  // Не помещается в окно solid_row_bits
+    if (!solid_bitmap_prepare(level, gy, gy + ballSize)) return true;
+    for (int r = 0; r < ballSize; r++) {
+        uint64_t m = ballRows[r];
+        uint64_t far = m << (span - 1);
+        if (solid_row_bits(solid_row(level, gy + r, left >> 5), left) & (far | (far - (m & (~m + 1))))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool solid_bitmap_sweep_hits(Level* level, int ballSize, int gx, int gy, int dx, int dy, int steps) {
+    if (ballSize == ENLARGED_SIZE) {
+        return sweep_hits_sized(level, ENLARGED_SIZE, gx, gy, dx, dy, steps);
+    }
+    return sweep_hits_sized(level, NORMAL_SIZE, gx, gy, dx, dy, steps);
+}
@@ -0,0 +1,46 @@
+// solid_bitmap.h - Пиксельная карта статической геометрии уровня (1 бит на пиксель)
+// Кирпич, резина и рампы растеризуются в строки Level::solidRows по маскам
+// level_masks.inc. Для этих тайлов коллизия мяча - это пересечение пикселей маски
+// мяча с маской тайла, поэтому проверка мяча против карты - AND строк маски мяча
+// со строками карты, сколько бы тайлов мяч ни задевал. Карта только отсеивает
+// серии подшагов свободного полета (physics.c); сама коллизия (collisionDetection
+// и testTile) по-прежнему проверяет тайлы по одному. Остальные классы (шипы,
+// кольца, бонусы) сравнивают прямоугольники и в карту не входят.
+#ifndef SOLID_BITMAP_H
+#define SOLID_BITMAP_H
+
+#include <stdbool.h>
+#include "level.h"
+
+// Слов в строке пикселей карты уровня шириной width тайлов: с отступом в одно
+// слово, чтобы читать 64 бита с любого пикселя без проверок
+static inline int solid_bitmap_stride(int width) {
+    return ((width * TILE_SIZE + 31) >> 5) + 1;
+}
+
+// Слов в карте уровня width x height тайлов, если построены все строки
+static inline size_t solid_bitmap_words(int width, int height) {
+    return (size_t)height * TILE_SIZE * (size_t)solid_bitmap_stride(width);
+}
+
+// Подготовить карту при загрузке. Строки тайлов растеризуются лениво, при первой
+// проверке, которая их касается, и только тогда под них выделяется память:
+// уровень, где мяч не летит долго над непустыми тайлами, карты не держит вовсе.
+void solid_bitmap_init(Level* level);
+
+// Освободить построенные строки (перед загрузкой другого уровня и в level_free)
+void solid_bitmap_free(Level* level);
+
+// Байт в построенных строках карты (для отчетов о памяти)
+size_t solid_bitmap_built_bytes(const Level* level);
+
+// Перерисовать один тайл после смены его ID (level_set_id)
+void solid_bitmap_update_tile(Level* level, int tx, int ty);
+
+// Задевает ли мяч размера ballSize геометрию карты хотя бы в одной из позиций
+// левого-верхнего угла (gx + dx*k, gy + dy*k), k = 1..steps. Сдвиг - по одной оси
+// (dx или dy равен 0). Все позиции должны лежать внутри карты. Без карты (или
+// без памяти под недостающую строку) - true. Недостающие строки строятся по ходу.
+bool solid_bitmap_sweep_hits(Level* level, int ballSize, int gx, int gy, int dx, int dy, int steps);
+
+#endif // SOLID_BITMAP_H
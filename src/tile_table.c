@@ -123,6 +123,26 @@ static const TileMeta TILE_DB[55] = {
 
 };
 
+// Классы коллизий по ID тайла (параллельно TILE_DB; ID вне таблицы проходимы)
+static const uint8_t TILE_COLLISION_CLASS[55] = {
+    [1] = TILE_CLASS_BRICK,
+    [2] = TILE_CLASS_RUBBER,
+    [3 ... 6] = TILE_CLASS_SPIKE,
+    [7] = TILE_CLASS_CHECKPOINT,
+    [9] = TILE_CLASS_EXIT,
+    [10] = TILE_CLASS_MOVING_SPIKE,
+    [13 ... 24] = TILE_CLASS_HOOP,
+    [25] = TILE_CLASS_HOOP_EDGE,
+    [27 ... 28] = TILE_CLASS_HOOP_EDGE,
+    [29] = TILE_CLASS_EXTRA_LIFE,
+    [30 ... 37] = TILE_CLASS_RAMP,
+    [38] = TILE_CLASS_SPEED,
+    [39 ... 42] = TILE_CLASS_DEFLATOR,
+    [43 ... 46] = TILE_CLASS_INFLATOR,
+    [47 ... 50] = TILE_CLASS_GRAVITY,
+    [51 ... 54] = TILE_CLASS_JUMP,
+};
+
 const TileMeta* tile_meta_db(void) {
     return TILE_DB;
 }
@@ -131,4 +151,9 @@ uint32_t tile_meta_count(void) {
     return 55;
 }
 
-
+uint8_t tile_collision_class(int tileID) {
+    if ((uint32_t)tileID >= tile_meta_count()) {
+        return TILE_CLASS_NONE;
+    }
+    return TILE_COLLISION_CLASS[tileID];
+}
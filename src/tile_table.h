@@ -1,7 +1,7 @@
 #ifndef TILE_TABLE_H
 #define TILE_TABLE_H
 
-#include <psptypes.h>
+#include "platform.h"
 
 // КРИТИЧЕСКИ ВАЖНО: TILE_SIZE = 12 - архитектурный инвариант
 // Все маски коллизий, спрайты и логика игры привязана к 12×12 пикселям из оригинала Bounce
@@ -60,6 +60,28 @@ typedef enum {
     COLLISION_ORIENTED         // Ориентированная коллизия (используется orientation)
 } CollisionType;
 
+// Класс коллизии тайла для диспетчеризации testTile (physics.c).
+// Один класс - один обработчик; ID с одинаковой логикой объединены.
+typedef enum {
+    TILE_CLASS_NONE = 0,       // Проходимый без действий: пусто, 8, 11-12, 26, неизвестные ID
+    TILE_CLASS_BRICK,          // 1 - кирпич
+    TILE_CLASS_RUBBER,         // 2 - резиновый блок
+    TILE_CLASS_SPIKE,          // 3-6 - шипы
+    TILE_CLASS_CHECKPOINT,     // 7 - кристалл чекпоинта
+    TILE_CLASS_EXIT,           // 9 - выход
+    TILE_CLASS_MOVING_SPIKE,   // 10 - область движущихся шипов
+    TILE_CLASS_HOOP,           // 13-24 - кольца (thinCollide + edgeCollide)
+    TILE_CLASS_HOOP_EDGE,      // 25, 27, 28 - большие неактивные кольца (только edgeCollide)
+    TILE_CLASS_EXTRA_LIFE,     // 29 - дополнительная жизнь
+    TILE_CLASS_RAMP,           // 30-37 - рампы
+    TILE_CLASS_SPEED,          // 38 - бонус скорости
+    TILE_CLASS_DEFLATOR,       // 39-42 - уменьшение мяча
+    TILE_CLASS_INFLATOR,       // 43-46 - увеличение мяча
+    TILE_CLASS_GRAVITY,        // 47-50 - бонус гравитации
+    TILE_CLASS_JUMP,           // 51-54 - бонус прыжка
+    TILE_CLASS_COUNT
+} TileCollisionClass;
+
 // Трансформации спрайтов (на основе Java manipulateImage)
 typedef enum {
     TF_NONE = 0,               // Без трансформации
@@ -139,6 +161,7 @@ typedef struct {
 // Функции доступа к таблице тайлов
 const TileMeta* tile_meta_db(void);
 uint32_t tile_meta_count(void);
+uint8_t tile_collision_class(int tileID);  // ID без флагов; вне TILE_DB - TILE_CLASS_NONE
 
 
 #endif // TILE_TABLE_H
\ No newline at end of file
@@ -194,21 +194,12 @@ typedef struct {
     bool mCDRampFlag;
 } Player;
 
-// Глобальное состояние игры
+// Глобальное состояние интерфейса игры
+// Мяч, счёт, жизни и карта уровня - в контексте симуляции g_sim (sim.h)
 typedef struct {
     GameState state;          // Текущее состояние игры
     int menu_selection;       // Выбранный пункт меню
     int selected_level;       // Выбранный уровень (1-MAX_LEVEL)
-    Player player;            // Состояние игрока
-    
-    // Игровая статистика (Java-совместимые поля)
-    int numRings;             // Количество собранных колец
-    int score;                // Очки игрока (500 за кольцо)
-    int numLives;             // Количество жизней (начинается с 3, максимум 5)
-    // Анимация двери теперь управляется из game.c
-    
-    // Отладочные флаги
-    bool invincible_cheat;      // Читерское бессмертие (как mInvincible в Java)
     
     // Splash screen система
     int splash_timer;           // Таймер для splash экранов
@@ -228,23 +219,9 @@ typedef struct {
 
 extern Game g_game;
 
-// Функции физики игрока (реализованы в отдельном файле физики)
-void player_init(Player* p, int x, int y, BallSizeState sizeState);
-void player_update(Player* p);
+// Флаги направления (physics.c); остальная физика и игровые события - в sim.h
 void set_direction(Player* p, MoveDirection dir);
 void release_direction(Player* p, MoveDirection dir);
-void enlarge_ball(Player* p);
-void shrink_ball(Player* p);
-void pop_ball(Player* p);
-
-// Игровые события (callbacks)
-void game_add_score(int points);
-void game_add_ring(void);
-void game_ring_collected(int tileX, int tileY, uint8_t tileID);
-
-void game_set_respawn(int x, int y);
-void game_add_extra_life(void);
-void game_complete_level(void);
 
 // === СИСТЕМА СОХРАНЕНИЙ ===
 typedef struct {
@@ -0,0 +1,41 @@
+// zobrist.h - Ключи Zobrist-хэша состояния симуляции (см. sim_hash)
+// Хэш - XOR ключей всех компонент состояния, поэтому замена одного значения
+// обновляет его за O(1):  hash ^= key(старое) ^ key(новое).
+// Ключ не берется из таблицы, а вычисляется перемешиванием номера компоненты
+// и ее значения: таблица на карту 255x255 с 256 значениями тайла заняла бы 128 МБ.
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <stdint.h>
+
+// Домены ключей в старших битах: компоненты разного вида не дают равных ключей
+#define ZOBRIST_DOMAIN_TILE   (1ULL << 60)
+#define ZOBRIST_DOMAIN_MOVING (2ULL << 60)
+#define ZOBRIST_DOMAIN_SIM    (3ULL << 60)
+
+// Финализатор splitmix64: биективное перемешивание 64 бит
+static inline uint64_t zobrist_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Ключ тайла (x, y) карты с его байтом. Номер ячейки считается по предельной
+// ширине 255, а не по ширине уровня: ключи, а с ними и хэши в реплеях, не
+// зависят от раскладки сеток Level.
+static inline uint64_t zobrist_tile_key(int x, int y, short tile) {
+    return zobrist_mix(ZOBRIST_DOMAIN_TILE | ((uint64_t)(uint32_t)(y * 255 + x) << 16) | (uint16_t)tile);
+}
+
+// Ключ движущегося объекта index со смещением и направлением. Направление
+// читается из знакового байта файла уровня, поэтому помещается в 8 бит.
+static inline uint64_t zobrist_moving_key(int index, const short offset[2], const short direction[2]) {
+    return zobrist_mix(ZOBRIST_DOMAIN_MOVING | ((uint64_t)(uint8_t)index << 48) |
+                       ((uint64_t)(uint8_t)direction[1] << 40) | ((uint64_t)(uint8_t)direction[0] << 32) |
+                       ((uint64_t)(uint16_t)offset[1] << 16) | (uint16_t)offset[0]);
+}
+
+#endif // ZOBRIST_H